@@ -11,6 +11,11 @@
 #ifndef PCB_H
 #define PCB_H
 
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stddef.h>
+
 /**
 * Defines the 5 states that a process can exist in:
 * New, Ready, Running, Waiting, Terminated
@@ -22,24 +27,25 @@ typedef enum state {
 } State;
 
 /**
-* Represents a process control block and defines attributes of a process.
-* Also logs runtime statistics of a particular process.
+* Represents a process control block. Only the fields scheduling decisions read live here,
+* packed into 32 bytes, the 64-bit PID included, so that two PCB's share a cache line. The
+* runtime statistics of a process are kept in the arrays of the PCB store (pcb_store.h),
+* indexed by the PCB's slot.
+*
+* A process waits in at most one queue at a time (the ready queue or one device queue), so
+* the queue link is embedded in the PCB and moving a process between queues never allocates.
 */
 typedef struct pcb_t{
+	struct pcb_t* next;				// Next PCB in the queue holding this process
+
 	// Process Identifiers
-	int PID;
+	Procsim_PID PID;
 	int priority;
-	int target_io_device;
-	State state;
-
-	// Process runtime statistic trackers
-	int start_ready_time;
-	int end_ready_time;
-	int total_ready_time;
-
-	int start_io_blocked_time;
-	int end_io_blocked_time;
-	int total_io_blocked_time;
+	int target_sector;
+	int slot;						// Index of the process statistics in the PCB store
+	unsigned char state;			// A State value
+	unsigned char target_io_device;
+	unsigned short group;			// Process group of the fair-share policy
 }PCB_t;
 
 /**
@@ -47,16 +53,14 @@ typedef struct pcb_t{
 * @param pcb: the PCB to initialize
 */
 static void initialize_PCB(PCB_t* pcb) {
+	pcb->next = NULL;
 	pcb->PID = 0;
 	pcb->priority = 0;
-	pcb->target_io_device = 0;
+	pcb->target_sector = 0;
+	pcb->slot = 0;
 	pcb->state = READY;
-	pcb->start_ready_time = 0;
-	pcb->end_ready_time = 0;
-	pcb->total_ready_time = 0;
-	pcb->start_io_blocked_time = 0;
-	pcb->end_io_blocked_time = 0;
-	pcb->total_io_blocked_time = 0;
+	pcb->target_io_device = 0;
+	pcb->group = 0;
 }
 
 #endif //PCB_H
@@ -0,0 +1,78 @@
+/**
+ * @file Scheduler.c
+ * @brief Defines the scheduler functions shared by the handlers of every policy
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "Scheduler.h"
+#include "instrumentation.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+
+/**
+* @brief Sends a scheduling event to the record callback unless the handler is fast-forwarding. The
+* record carries the length of the device's request list for I/O events, and the length of
+* the ready queue otherwise, as they are when the event is logged
+* @param schedulerHandler: A reference to the current scheduler
+* @param kind: the kind of event
+* @param time: the time of the event
+* @param process: the process the event concerns, NULL for I/O completions
+* @param io_device: the device the event concerns, NULL for CPU events
+*/
+void log_event(const SchedulerHandler* schedulerHandler, Log_Kind kind, Procsim_Time time, const PCB_t* process, const IO_Device_t* io_device) {
+	if (!schedulerHandler->print_events || schedulerHandler->record_callback == NULL) {
+		return;
+	}
+
+	LogRecord_t record;
+	record.time = time;
+	record.PID = process != NULL ? process->PID : 0;
+	record.priority = process != NULL ? process->priority : 0;
+	record.kind = (unsigned char)kind;
+	if (io_device != NULL) {
+		record.device = (signed char)io_device->id;
+		record.queue_length = get_io_request_count(io_device);
+	} else {
+		record.device = -1;
+		record.queue_length = get_ready_queue_length(schedulerHandler);
+	}
+
+	schedulerHandler->record_callback(&record, schedulerHandler->record_context);
+}
+
+/**
+* @brief Finds room for a run of processes. A short run uses the buffer on the caller's stack,
+* a longer one is allocated, since an I/O completion can release every process on a device
+* @param stack_buffer: the caller's buffer of HANDLER_STACK_PROCESSES entries
+* @param count: number of processes
+* @return the stack buffer or an allocated one, to be given back to release_process_buffer
+*/
+PCB_t** get_process_buffer(PCB_t** stack_buffer, int count) {
+	if (count <= HANDLER_STACK_PROCESSES) {
+		return stack_buffer;
+	}
+
+	INSTRUMENT_MEMORY_ALLOCATION();
+	PCB_t** buffer = (PCB_t**)malloc(count * sizeof(PCB_t*));
+	if (buffer == NULL) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	return buffer;
+}
+
+/**
+* @brief Frees a buffer from get_process_buffer unless it is the caller's stack buffer
+* @param buffer: the buffer
+* @param stack_buffer: the caller's stack buffer
+*/
+void release_process_buffer(PCB_t** buffer, PCB_t** stack_buffer) {
+	if (buffer != stack_buffer) {
+		free(buffer);
+	}
+}
@@ -18,6 +18,17 @@
 #include "io_device.h"
 #include "queue.h"
 #include "priority_queue.h"
+#include "request_heap.h"
+#include "fair_share.h"
+#include "pcb_store.h"
+#include "ready_spill.h"
+#include "adaptive_queue.h"
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+
+// Processes a handler keeps on the stack while it works on a run of them, longer runs are allocated
+#define HANDLER_STACK_PROCESSES 256
 
 /**
 * @struct SchedulerHandler
@@ -26,53 +37,150 @@
 */
 typedef struct SchedulerHandler {
 	// Handler functions
-	void* queue;  // Can be Queue_t* or PriorityQueue_t*
+	Scheduling_Policy policy;
+	void* queue;  // Queue_t* for FIFO, PriorityQueue_t* for priority, RequestHeap_t* keyed by predicted burst for SJF and SRTF,
+				  // FairShareQueue_t* for fair-share
 	PCB_t* CPU;
-	void (*handle_process_start)(struct SchedulerHandler* schedulerHandler, int priority, int* PID_tracker, int* current_time);
-	void (*handle_io_request)(struct SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
-	void (*handle_io_complete)(struct SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
-	PCB_t (*handle_process_end)(struct SchedulerHandler* schedulerHandler, int* current_time);
+	void (*handle_process_start)(struct SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+	void (*handle_io_request)(struct SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time);
+	void (*handle_io_complete)(struct SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
+	void (*handle_process_end)(struct SchedulerHandler* schedulerHandler, Procsim_Time* current_time);
+	// Starts a run of op code 1 events at the same time in one step, NULL to start them one at a time
+	void (*handle_process_start_batch)(struct SchedulerHandler* schedulerHandler, const Event_t* events, int count, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+	int ready_pending;  // Processes logged as ready that a handler has yet to merge into the ready queue
+	ReadySpill_t* ready_spill;  // Spills the end of the priority policy's ready queue to a scratch file, NULL to keep it in memory
+	AdaptiveQueue_t* adaptive_queue;  // Moves the priority policy's ready queue between backends, NULL to keep the list
 	IO_Device_t* io_devices;
+	PCB_Store_t* pcb_store;
+	bool print_events;  // Cleared while fast-forwarding so handlers only update state
+	ProcsimRecordCallback record_callback;  // Receives the scheduling events, NULL to discard them
+	void* record_context;
 
 	// Analytics Tracking
-	int start_idle_time;
-	int end_idle_time;
-	int total_idle_time;
+	Procsim_Time start_idle_time;
+	Procsim_Time end_idle_time;
+	Procsim_Time total_idle_time;
 } SchedulerHandler;
 
+/**
+* @brief Sends a scheduling event to the record callback unless the handler is fast-forwarding. The
+* record carries the length of the device's request list for I/O events, and the length of
+* the ready queue otherwise, as they are when the event is logged
+* @param schedulerHandler: A reference to the current scheduler
+* @param kind: the kind of event
+* @param time: the time of the event
+* @param process: the process the event concerns, NULL for I/O completions
+* @param io_device: the device the event concerns, NULL for CPU events
+*/
+void log_event(const SchedulerHandler* schedulerHandler, Log_Kind kind, Procsim_Time time, const PCB_t* process, const IO_Device_t* io_device);
+
+/**
+* @brief Finds room for a run of processes. A short run uses the buffer on the caller's stack,
+* a longer one is allocated, since an I/O completion can release every process on a device
+* @param stack_buffer: the caller's buffer of HANDLER_STACK_PROCESSES entries
+* @param count: number of processes
+* @return the stack buffer or an allocated one, to be given back to release_process_buffer
+*/
+PCB_t** get_process_buffer(PCB_t** stack_buffer, int count);
+
+/**
+* @brief Frees a buffer from get_process_buffer unless it is the caller's stack buffer
+* @param buffer: the buffer
+* @param stack_buffer: the caller's stack buffer
+*/
+void release_process_buffer(PCB_t** buffer, PCB_t** stack_buffer);
+
+/**
+* @brief Checks whether a policy keeps its ready queue in a heap keyed by predicted burst
+* @param policy: the policy
+* @return true for SJF and SRTF
+*/
+static inline bool is_shortest_job_policy(Scheduling_Policy policy) {
+	return policy == SCHEDULE_SJF || policy == SCHEDULE_SRTF;
+}
+
+/**
+* @brief Looks up the length of the ready queue. Both list types keep their size at the same
+* place, so the FIFO layout serves for the priority queue as well. Processes a handler is
+* about to merge into the queue and spilled processes already count
+* @param schedulerHandler: A reference to the current scheduler
+* @return the number of processes waiting to run
+*/
+static inline int get_ready_queue_length(const SchedulerHandler* schedulerHandler) {
+	if (is_shortest_job_policy(schedulerHandler->policy)) {
+		return ((const RequestHeap_t*)schedulerHandler->queue)->size;
+	}
+	if (schedulerHandler->policy == SCHEDULE_FAIR_SHARE) {
+		return ((const FairShareQueue_t*)schedulerHandler->queue)->size;
+	}
+	int length = ((const Queue_t*)schedulerHandler->queue)->size + schedulerHandler->ready_pending;
+	if (schedulerHandler->ready_spill != NULL) {
+		length += (int)schedulerHandler->ready_spill->spilled;
+	}
+	if (schedulerHandler->adaptive_queue != NULL) {
+		length += schedulerHandler->adaptive_queue->size;
+	}
+	return length;
+}
+
+/**
+* @brief Merges processes into the priority policy's ready queue, through the spill if the
+* waiting processes are bounded, or the adaptive backend if there is one
+* @param schedulerHandler: A reference to the current scheduler
+* @param processes: the waiting processes
+* @param count: number of processes
+* @param time: the current time
+*/
+static inline void enqueue_ready_processes(SchedulerHandler* schedulerHandler, PCB_t** processes, int count, Procsim_Time time) {
+	if (schedulerHandler->adaptive_queue != NULL) {
+		enqueue_adaptive_queue(schedulerHandler->adaptive_queue, (PriorityQueue_t*)schedulerHandler->queue, processes, count, time);
+		return;
+	}
+	if (schedulerHandler->ready_spill == NULL) {
+		enqueue_batch_priority_queue((PriorityQueue_t*)schedulerHandler->queue, processes, count);
+		return;
+	}
+	for (int i = 0; i < count; i++) {
+		enqueue_ready_spill(schedulerHandler->ready_spill, schedulerHandler->pcb_store, (PriorityQueue_t*)schedulerHandler->queue, processes[i]);
+	}
+}
+
 // Function Prototypes for non-preemptive functions
 /**
 * @brief Handles the event of starting of a process using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param priority: a new processes priority
+* @param group: the process group of the new process
 * @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int* PID_tracker, int* current_time);
+void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
 
 /**
 * @brief Handles the event where an active process requests an I/O device using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
+void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time);
 
 /**
 * @brief Handles the event where an I/O device completes its tasks using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
+void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
 
 /**
-* @brief Handles the event where an active process terminates using non-preemptive scheduling
+* @brief Handles the event where an active process terminates using non-preemptive scheduling.
+* The process is recorded in the completed process analytics of the PCB store
 * @param schedulerHandler: A reference to the current scheduler
 * @param current_time: reference to the current time, used for analytics marking events
-* @return a copy of the completed process
 */
-PCB_t non_preemptive_process_end(SchedulerHandler* schedulerHandler, int* current_time);
+void non_preemptive_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time);
 
 
 
@@ -81,44 +189,157 @@ PCB_t non_preemptive_process_end(SchedulerHandler* schedulerHandler, int* curren
 * @brief Handles the event of starting of a process using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param priority: a new processes priority
+* @param group: the process group of the new process
 * @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int* PID_tracker, int* current_time);
+void preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+
+/**
+* @brief Handles a run of process starts at the same time using preemptive scheduling. The
+* scheduling events match starting them one at a time, and the processes left waiting join
+* the ready queue in one merge
+* @param schedulerHandler: A reference to the current scheduler
+* @param events: the op code 1 events, all at the current time
+* @param count: number of events
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to each new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void preemptive_process_start_batch(SchedulerHandler* schedulerHandler, const Event_t* events, int count, Procsim_PID* PID_tracker, Procsim_Time* current_time);
 
 /**
 * @brief Handles the event where an active process requests an I/O device using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
+void preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time);
 
 /**
 * @brief Handles the event where an I/O device completes its tasks using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an active process terminates using preemptive scheduling.
+* The process is recorded in the completed process analytics of the PCB store
+* @param schedulerHandler: A reference to the current scheduler
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void preemptive_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time);
+
+// Function Prototypes for shortest job functions
+/**
+* @brief Handles the event of starting of a process using SJF scheduling. The process waits
+* with its initial burst prediction unless the CPU is idle
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void sjf_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event of starting of a process using SRTF scheduling. The process preempts
+* the running one if its predicted burst is shorter than what the running one has left
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void srtf_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an active process requests an I/O device using SJF or SRTF
+* scheduling. The request ends the process's CPU burst
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void shortest_job_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using SJF scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void sjf_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using SRTF scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void srtf_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an active process terminates using SJF or SRTF scheduling.
+* The process is recorded in the completed process analytics of the PCB store
+* @param schedulerHandler: A reference to the current scheduler
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void shortest_job_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time);
+
+// Function Prototypes for fair-share functions
+/**
+* @brief Handles the event of starting of a process using fair-share scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an active process requests an I/O device using fair-share
+* scheduling. The CPU time of the process is charged to its group
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time);
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using fair-share scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
 * @param current_time: reference to the current time, used for analytics and marking events
 */
-void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time);
+void fair_share_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time);
 
 /**
-* @brief Handles the event where an active process terminates using preemptive scheduling
+* @brief Handles the event where an active process terminates using fair-share scheduling.
+* The CPU time of the process is charged to its group
 * @param schedulerHandler: A reference to the current scheduler
 * @param current_time: reference to the current time, used for analytics and marking events
-* @return a copy of the completed process
 */
-PCB_t preemptive_process_end(SchedulerHandler* schedulerHandler, int* current_time);
+void fair_share_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time);
 
 /**
 * @brief Initializes a schedulerHandler struct to the right functions
 * @param scheduler_handler: pointer to the scheduler handler
 * @param io_devices: pointer to array of initialized I/O devices
-* @param preemptive_scheduler: non-preemptive (0) or preemptive (1)
+* @param pcb_store: the store that owns every PCB of the run
+* @param policy: the scheduling policy
 */
-static void initialize_scheduler_handler(SchedulerHandler* scheduler_handler, IO_Device_t* io_devices, int* preemptive_scheduler) {
+static void initialize_scheduler_handler(SchedulerHandler* scheduler_handler, IO_Device_t* io_devices, PCB_Store_t* pcb_store, Scheduling_Policy policy) {
 	// Initialize scheduler based on mode
-	if (*preemptive_scheduler == 0) {
+	if (policy == SCHEDULE_FIFO) {
 		// Non-preemptive scheduler
 		Queue_t* pcb_queue = (Queue_t*)malloc(sizeof(Queue_t));
 		initialize_queue(pcb_queue);
@@ -129,8 +350,9 @@ static void initialize_scheduler_handler(SchedulerHandler* scheduler_handler, IO
 		scheduler_handler->handle_io_request = &non_preemptive_io_request;
 		scheduler_handler->handle_io_complete = &non_preemptive_io_complete;
 		scheduler_handler->handle_process_end = &non_preemptive_process_end;
+		scheduler_handler->handle_process_start_batch = NULL;
 		scheduler_handler->io_devices = io_devices;
-	} else {
+	} else if (policy == SCHEDULE_PRIORITY) {
 		// Preemptive scheduler
 		PriorityQueue_t* pcb_queue = (PriorityQueue_t*)malloc(sizeof(PriorityQueue_t));
 		initialize_priority_queue(pcb_queue);
@@ -141,9 +363,45 @@ static void initialize_scheduler_handler(SchedulerHandler* scheduler_handler, IO
 		scheduler_handler->handle_io_request = &preemptive_io_request;
 		scheduler_handler->handle_io_complete = &preemptive_io_complete;
 		scheduler_handler->handle_process_end = &preemptive_process_end;
+		scheduler_handler->handle_process_start_batch = &preemptive_process_start_batch;
+		scheduler_handler->io_devices = io_devices;
+	} else if (policy == SCHEDULE_FAIR_SHARE) {
+		// Fair-share scheduler, a priority queue per group under a heap of groups
+		FairShareQueue_t* pcb_queue = (FairShareQueue_t*)malloc(sizeof(FairShareQueue_t));
+		initialize_fair_share_queue(pcb_queue);
+
+		scheduler_handler->queue = pcb_queue;
+		scheduler_handler->CPU = NULL;
+		scheduler_handler->handle_process_start = &fair_share_process_start;
+		scheduler_handler->handle_io_request = &fair_share_io_request;
+		scheduler_handler->handle_io_complete = &fair_share_io_complete;
+		scheduler_handler->handle_process_end = &fair_share_process_end;
+		scheduler_handler->handle_process_start_batch = NULL;
+		scheduler_handler->io_devices = io_devices;
+	} else {
+		// Shortest job schedulers, the ready queue is a heap keyed by predicted burst
+		RequestHeap_t* pcb_queue = (RequestHeap_t*)malloc(sizeof(RequestHeap_t));
+		initialize_request_heap(pcb_queue);
+
+		bool preemptive = policy == SCHEDULE_SRTF;
+		scheduler_handler->queue = pcb_queue;
+		scheduler_handler->CPU = NULL;
+		scheduler_handler->handle_process_start = preemptive ? &srtf_process_start : &sjf_process_start;
+		scheduler_handler->handle_io_request = &shortest_job_io_request;
+		scheduler_handler->handle_io_complete = preemptive ? &srtf_io_complete : &sjf_io_complete;
+		scheduler_handler->handle_process_end = &shortest_job_process_end;
+		scheduler_handler->handle_process_start_batch = NULL;
 		scheduler_handler->io_devices = io_devices;
 	}
 
+	scheduler_handler->ready_pending = 0;
+	scheduler_handler->ready_spill = NULL;
+	scheduler_handler->adaptive_queue = NULL;
+	scheduler_handler->policy = policy;
+	scheduler_handler->pcb_store = pcb_store;
+	scheduler_handler->print_events = true;
+	scheduler_handler->record_callback = NULL;
+	scheduler_handler->record_context = NULL;
 	scheduler_handler->start_idle_time = 0;
 	scheduler_handler->end_idle_time = 0;
 	scheduler_handler->total_idle_time = 0;
@@ -152,22 +410,24 @@ static void initialize_scheduler_handler(SchedulerHandler* scheduler_handler, IO
 /**
 * @brief Frees the memory of the scheduler
 * @param schedulerHandler: pointer to the scheduler handler
-* @param preemptive_scheduler: what type of scheduler it is
 */
-static void free_scheduler_handler(SchedulerHandler* schedulerHandler, int* preemptive_scheduler) {
-	if (*preemptive_scheduler == 0) {
+static void free_scheduler_handler(SchedulerHandler* schedulerHandler) {
+	if (schedulerHandler->policy == SCHEDULE_FIFO) {
 		// If the program is non-preemptive scheduling, the backing structure is a queue.
 		free_queue((Queue_t*)schedulerHandler->queue);
-	} else {
-		// If the program is non-preemptive scheduling, the backing structure is a priority queue.
+	} else if (schedulerHandler->policy == SCHEDULE_PRIORITY) {
+		// If the program is preemptive scheduling, the backing structure is a priority queue.
 		free_priority_queue((PriorityQueue_t*)schedulerHandler->queue);
+	} else if (schedulerHandler->policy == SCHEDULE_FAIR_SHARE) {
+		// The fair-share scheduler keeps a queue per group
+		free_fair_share_queue((FairShareQueue_t*)schedulerHandler->queue);
+	} else {
+		// The shortest job schedulers keep a heap
+		free_request_heap((RequestHeap_t*)schedulerHandler->queue);
 	}
 
+	// The PCB's themselves belong to the PCB store
 	free(schedulerHandler->queue);
-
-	if (schedulerHandler->CPU != NULL){
-		free(schedulerHandler->CPU);
-	}
 }
 
 
@@ -0,0 +1,674 @@
+/**
+ * @file adaptive_queue.c
+ * @brief Defines the adaptive backend of the priority policy's ready queue
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "adaptive_queue.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Entries of the priority counts to start with, a power of 2
+#define INITIAL_COUNT_CAPACITY 64
+// Entries of the heap to start with
+#define INITIAL_HEAP_CAPACITY 64
+
+/**
+* @brief Reads the monotonic clock
+* @return the time in nanoseconds
+*/
+static long adaptive_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+* @brief Stops the simulator if an allocation failed
+* @return the allocation
+*/
+static void* check_allocation(void* pointer) {
+	if (pointer == NULL) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	return pointer;
+}
+
+/**
+* @brief Finds the entry of a priority in the counts, or the unused entry it would take
+*/
+static int find_priority_count(const AdaptiveQueue_t* queue, int priority) {
+	unsigned int hash = (unsigned int)priority * 2654435761u;
+	int mask = queue->count_capacity - 1;
+	int index = (int)(hash ^ (hash >> 16)) & mask;
+	while (queue->counts[index].count >= 0 && queue->counts[index].priority != priority) {
+		index = (index + 1) & mask;
+	}
+	return index;
+}
+
+/**
+* @brief Rebuilds the counts without the priorities no longer waiting, doubling them if
+* the waiting ones fill half
+*/
+static void rebuild_priority_counts(AdaptiveQueue_t* queue) {
+	PriorityCount_t* old_counts = queue->counts;
+	int old_capacity = queue->count_capacity;
+	while (queue->distinct_priorities * 2 >= queue->count_capacity) {
+		queue->count_capacity *= 2;
+	}
+
+	queue->counts = (PriorityCount_t*)check_allocation(malloc(queue->count_capacity * sizeof(PriorityCount_t)));
+	for (int i = 0; i < queue->count_capacity; i++) {
+		queue->counts[i].count = -1;
+	}
+	for (int i = 0; i < old_capacity; i++) {
+		if (old_counts[i].count > 0) {
+			queue->counts[find_priority_count(queue, old_counts[i].priority)] = old_counts[i];
+		}
+	}
+	queue->count_used = queue->distinct_priorities;
+	free(old_counts);
+}
+
+/**
+* @brief Counts a waiting process of a priority
+*/
+static void count_priority(AdaptiveQueue_t* queue, int priority) {
+	PriorityCount_t* entry = &queue->counts[find_priority_count(queue, priority)];
+	if (entry->count < 0) {
+		// Keep at least a quarter of the entries unused so probes stay short
+		if ((queue->count_used + 1) * 4 > queue->count_capacity * 3) {
+			rebuild_priority_counts(queue);
+			entry = &queue->counts[find_priority_count(queue, priority)];
+		}
+		entry->priority = priority;
+		entry->count = 0;
+		queue->count_used++;
+	}
+	if (entry->count++ == 0) {
+		queue->distinct_priorities++;
+		if (queue->distinct_priorities > queue->stats.max_distinct_priorities) {
+			queue->stats.max_distinct_priorities = queue->distinct_priorities;
+		}
+	}
+}
+
+/**
+* @brief Stops counting a waiting process of a priority
+*/
+static void uncount_priority(AdaptiveQueue_t* queue, int priority) {
+	PriorityCount_t* entry = &queue->counts[find_priority_count(queue, priority)];
+	if (entry->count <= 0) {
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Priority of a waiting process was not counted!");
+	}
+	if (--entry->count == 0) {
+		queue->distinct_priorities--;
+	}
+}
+
+/**
+* @brief Makes sure a bucket covers a priority. The buckets grow by at least their count
+* toward it, so a widening range does not reallocate them at every new priority
+* @return true on success, false if the range would grow past ADAPTIVE_MAX_BUCKET_RANGE
+*/
+static bool reserve_bucket(AdaptiveQueue_t* queue, int priority) {
+	long long low = queue->bucket_base;
+	long long high = queue->bucket_base + queue->bucket_count - 1;
+	if (queue->bucket_count > 0 && priority >= low && priority <= high) {
+		return true;
+	}
+
+	if (queue->bucket_count == 0) {
+		low = priority;
+		high = priority;
+	} else if (priority < low) {
+		low = priority;
+	} else {
+		high = priority;
+	}
+	if (high - low + 1 > ADAPTIVE_MAX_BUCKET_RANGE) {
+		return false;
+	}
+	long long extra = ADAPTIVE_MAX_BUCKET_RANGE - (high - low + 1);
+	if (extra > queue->bucket_count) {
+		extra = queue->bucket_count;
+	}
+	if (priority == low) {
+		low -= extra;
+	} else {
+		high += extra;
+	}
+
+	int bucket_count = (int)(high - low + 1);
+	ReadyBucket_t* buckets = (ReadyBucket_t*)check_allocation(calloc(bucket_count, sizeof(ReadyBucket_t)));
+	if (queue->bucket_count > 0) {
+		memcpy(&buckets[queue->bucket_base - low], queue->buckets, queue->bucket_count * sizeof(ReadyBucket_t));
+	}
+	free(queue->buckets);
+	queue->buckets = buckets;
+	queue->bucket_base = low;
+	queue->bucket_count = bucket_count;
+	return true;
+}
+
+/**
+* @brief Looks up the bucket of a priority the buckets cover
+*/
+static ReadyBucket_t* get_bucket(const AdaptiveQueue_t* queue, int priority) {
+	return &queue->buckets[priority - queue->bucket_base];
+}
+
+/**
+* @brief Adds a process to the buckets where enqueue_priority_queue would place it in the
+* list: first of its bucket above the others or between them, last at or below the lowest
+* priority, and second of its bucket at the highest priority. Its bucket must be reserved
+*/
+static void enqueue_bucket(AdaptiveQueue_t* queue, PCB_t* pcb) {
+	int priority = pcb->priority;
+	ReadyBucket_t* bucket = get_bucket(queue, priority);
+	if (queue->size > 0 && priority <= queue->lowest) {
+		pcb->next = NULL;
+		if (bucket->tail != NULL) {
+			bucket->tail->next = pcb;
+		} else {
+			bucket->head = pcb;
+		}
+		bucket->tail = pcb;
+	} else if (queue->size > 0 && priority == queue->highest) {
+		pcb->next = bucket->head->next;
+		bucket->head->next = pcb;
+		if (bucket->tail == bucket->head) {
+			bucket->tail = pcb;
+		}
+	} else {
+		pcb->next = bucket->head;
+		bucket->head = pcb;
+		if (bucket->tail == NULL) {
+			bucket->tail = pcb;
+		}
+	}
+
+	if (queue->size == 0 || priority > queue->highest) {
+		queue->highest = priority;
+	}
+	if (queue->size == 0 || priority < queue->lowest) {
+		queue->lowest = priority;
+	}
+	queue->size++;
+}
+
+/**
+* @brief Removes the first process of the highest bucket
+*/
+static PCB_t* dequeue_bucket(AdaptiveQueue_t* queue) {
+	ReadyBucket_t* bucket = get_bucket(queue, queue->highest);
+	PCB_t* pcb = bucket->head;
+	bucket->head = pcb->next;
+	if (bucket->head == NULL) {
+		bucket->tail = NULL;
+	}
+	pcb->next = NULL;
+	queue->size--;
+
+	if (bucket->head == NULL && queue->size > 0) {
+		// The next highest bucket holds the new first process
+		long long index = queue->highest - queue->bucket_base - 1;
+		while (queue->buckets[index].head == NULL) {
+			index--;
+		}
+		queue->highest = (int)(queue->bucket_base + index);
+	}
+	return pcb;
+}
+
+/**
+* @brief Checks if heap entry a runs before heap entry b
+*/
+static bool entry_before(const ReadyHeapEntry_t* a, const ReadyHeapEntry_t* b) {
+	if (a->priority != b->priority) {
+		return a->priority > b->priority;
+	}
+	return a->key < b->key;
+}
+
+/**
+* @brief Orders heap entries in run order, for qsort
+*/
+static int compare_entries(const void* a, const void* b) {
+	return entry_before((const ReadyHeapEntry_t*)a, (const ReadyHeapEntry_t*)b) ? -1 : 1;
+}
+
+/**
+* @brief Adds a process to the heap under a key
+*/
+static void push_heap_entry(AdaptiveQueue_t* queue, PCB_t* pcb, long long key) {
+	if (queue->heap_size == queue->heap_capacity) {
+		queue->heap_capacity = queue->heap_capacity > 0 ? queue->heap_capacity * 2 : INITIAL_HEAP_CAPACITY;
+		queue->heap = (ReadyHeapEntry_t*)check_allocation(realloc(queue->heap, queue->heap_capacity * sizeof(ReadyHeapEntry_t)));
+	}
+
+	ReadyHeapEntry_t entry = {key, pcb->priority, pcb};
+	ReadyHeapEntry_t* heap = queue->heap;
+	int index = queue->heap_size++;
+	while (index > 0 && entry_before(&entry, &heap[(index - 1) / 2])) {
+		heap[index] = heap[(index - 1) / 2];
+		index = (index - 1) / 2;
+	}
+	heap[index] = entry;
+}
+
+/**
+* @brief Removes the first process of the heap
+*/
+static PCB_t* pop_heap_entry(AdaptiveQueue_t* queue) {
+	ReadyHeapEntry_t* heap = queue->heap;
+	PCB_t* pcb = heap[0].pcb;
+	ReadyHeapEntry_t last = heap[--queue->heap_size];
+	int index = 0;
+	while (true) {
+		int child = 2 * index + 1;
+		if (child >= queue->heap_size) {
+			break;
+		}
+		if (child + 1 < queue->heap_size && entry_before(&heap[child + 1], &heap[child])) {
+			child++;
+		}
+		if (!entry_before(&heap[child], &last)) {
+			break;
+		}
+		heap[index] = heap[child];
+		index = child;
+	}
+	heap[index] = last;
+	return pcb;
+}
+
+/**
+* @brief Adds a process to the heap backend where enqueue_priority_queue would place it in the
+* list. A process above the highest priority takes the first place, and the one it displaces
+* goes before the rest of its priority
+*/
+static void enqueue_heap(AdaptiveQueue_t* queue, PCB_t* pcb) {
+	int priority = pcb->priority;
+	pcb->next = NULL;
+	if (queue->size == 0) {
+		queue->first = pcb;
+		queue->highest = priority;
+		queue->lowest = priority;
+	} else if (priority > queue->highest) {
+		push_heap_entry(queue, queue->first, queue->next_front_key--);
+		queue->first = pcb;
+		queue->highest = priority;
+	} else if (priority <= queue->lowest) {
+		push_heap_entry(queue, pcb, queue->next_back_key++);
+		queue->lowest = priority;
+	} else {
+		// Before the others of its priority, but after the first process
+		push_heap_entry(queue, pcb, queue->next_front_key--);
+	}
+	queue->size++;
+}
+
+/**
+* @brief Removes the first process of the heap backend
+*/
+static PCB_t* dequeue_heap(AdaptiveQueue_t* queue) {
+	PCB_t* pcb = queue->first;
+	queue->size--;
+	if (queue->heap_size > 0) {
+		queue->first = pop_heap_entry(queue);
+		queue->highest = queue->first->priority;
+	} else {
+		queue->first = NULL;
+		queue->next_front_key = -1;
+		queue->next_back_key = 1;
+	}
+	return pcb;
+}
+
+/**
+* @brief Looks up the number of waiting processes
+*/
+static int get_adaptive_depth(const AdaptiveQueue_t* queue, const PriorityQueue_t* list) {
+	return queue->backend == READY_QUEUE_LIST ? list->size : queue->size;
+}
+
+/**
+* @brief Looks up the highest minus the lowest waiting priority, plus 1, or 0 with none waiting
+*/
+static long long get_priority_range(const AdaptiveQueue_t* queue, const PriorityQueue_t* list) {
+	if (get_adaptive_depth(queue, list) == 0) {
+		return 0;
+	}
+	if (queue->backend == READY_QUEUE_LIST) {
+		return (long long)list->head->priority - list->tail->priority + 1;
+	}
+	return (long long)queue->highest - queue->lowest + 1;
+}
+
+// Function templates
+static void switch_backend(AdaptiveQueue_t* queue, PriorityQueue_t* list, Ready_Queue_Backend backend, Procsim_Time time);
+
+/**
+* @brief Adds a process to the current backend. The buckets give way to the heap if they
+* cannot cover its priority
+*/
+static void insert_process(AdaptiveQueue_t* queue, PriorityQueue_t* list, PCB_t* pcb, Procsim_Time time) {
+	if (queue->backend == READY_QUEUE_BUCKETS && !reserve_bucket(queue, pcb->priority)) {
+		switch_backend(queue, list, READY_QUEUE_HEAP, time);
+	}
+
+	if (queue->backend == READY_QUEUE_LIST) {
+		enqueue_priority_queue(list, pcb);
+	} else if (queue->backend == READY_QUEUE_BUCKETS) {
+		enqueue_bucket(queue, pcb);
+	} else {
+		enqueue_heap(queue, pcb);
+	}
+}
+
+/**
+* @brief Removes the first process of the current backend
+*/
+static PCB_t* remove_process(AdaptiveQueue_t* queue, PriorityQueue_t* list) {
+	if (queue->backend == READY_QUEUE_LIST) {
+		return dequeue_priority_queue(list);
+	}
+	if (queue->backend == READY_QUEUE_BUCKETS) {
+		return dequeue_bucket(queue);
+	}
+	return dequeue_heap(queue);
+}
+
+/**
+* @brief Takes every waiting process out of the current backend in order
+* @return the processes, chained through their next field
+*/
+static PCB_t* take_waiting_processes(AdaptiveQueue_t* queue, PriorityQueue_t* list) {
+	PCB_t* chain = NULL;
+	PCB_t* chain_tail = NULL;
+	for (int depth = get_adaptive_depth(queue, list); depth > 0; depth--) {
+		PCB_t* pcb = remove_process(queue, list);
+		pcb->next = NULL;
+		if (chain_tail != NULL) {
+			chain_tail->next = pcb;
+		} else {
+			chain = pcb;
+		}
+		chain_tail = pcb;
+	}
+
+	// The buckets are sized again around the priorities of their next tenure
+	free(queue->buckets);
+	queue->buckets = NULL;
+	queue->bucket_count = 0;
+	return chain;
+}
+
+/**
+* @brief Moves the waiting processes to another backend in order, and reports the switch with
+* the cost measured on the backend left
+*/
+static void switch_backend(AdaptiveQueue_t* queue, PriorityQueue_t* list, Ready_Queue_Backend backend, Procsim_Time time) {
+	long start = adaptive_now();
+	ReadyQueueSwitch_t record;
+	record.time = time;
+	record.from = queue->backend;
+	record.to = backend;
+	record.depth = get_adaptive_depth(queue, list);
+	record.distinct_priorities = queue->distinct_priorities;
+	record.priority_range = get_priority_range(queue, list);
+	record.operations = queue->tenure_operations;
+	record.nanoseconds_per_operation = queue->tenure_sampled > 0 ? (double)queue->tenure_nanoseconds / queue->tenure_sampled : 0;
+
+	// In order, every process lands last in the new backend
+	PCB_t* pcb = take_waiting_processes(queue, list);
+	queue->backend = backend;
+	while (pcb != NULL) {
+		PCB_t* next = pcb->next;
+		insert_process(queue, list, pcb, time);
+		pcb = next;
+	}
+
+	record.migration_nanoseconds = (double)(adaptive_now() - start);
+	queue->tenure_operations = 0;
+	queue->tenure_sampled = 0;
+	queue->tenure_nanoseconds = 0;
+	queue->stats.backend = backend;
+	queue->stats.switches++;
+	if (queue->callback != NULL) {
+		queue->callback(&record, queue->context);
+	}
+}
+
+/**
+* @brief Picks the backend for the current depth and priorities. Each threshold is looser for
+* the backend in use than for one to switch to, so the queue does not flap around it
+*/
+static void check_backend(AdaptiveQueue_t* queue, PriorityQueue_t* list, Procsim_Time time) {
+	int depth = get_adaptive_depth(queue, list);
+	int list_depth = queue->backend == READY_QUEUE_LIST ? ADAPTIVE_LIST_LEAVE_DEPTH : ADAPTIVE_LIST_ENTER_DEPTH;
+	int bucket_priorities = queue->backend == READY_QUEUE_BUCKETS ? ADAPTIVE_BUCKETS_LEAVE_PRIORITIES : ADAPTIVE_BUCKETS_ENTER_PRIORITIES;
+
+	Ready_Queue_Backend backend;
+	if (depth <= list_depth) {
+		backend = READY_QUEUE_LIST;
+	} else if (queue->distinct_priorities <= bucket_priorities && get_priority_range(queue, list) <= ADAPTIVE_MAX_BUCKET_RANGE) {
+		backend = READY_QUEUE_BUCKETS;
+	} else {
+		backend = READY_QUEUE_HEAP;
+	}
+	if (backend != queue->backend) {
+		switch_backend(queue, list, backend, time);
+	}
+}
+
+/**
+* @brief Accounts for queue operations, timed from start if they were sampled, and checks the
+* backend once the interval has passed
+*/
+static void finish_operations(AdaptiveQueue_t* queue, PriorityQueue_t* list, int count, Ready_Queue_Backend backend, long start, Procsim_Time time) {
+	// A sample that spans a switch is dropped
+	if (start >= 0 && backend == queue->backend) {
+		long nanoseconds = adaptive_now() - start;
+		queue->tenure_sampled += count;
+		queue->tenure_nanoseconds += nanoseconds;
+		queue->sampled[backend] += count;
+		queue->sampled_nanoseconds[backend] += nanoseconds;
+	}
+	queue->tenure_operations += count;
+	queue->stats.operations[backend] += count;
+
+	int depth = get_adaptive_depth(queue, list);
+	if (depth > queue->stats.max_depth) {
+		queue->stats.max_depth = depth;
+	}
+	queue->operations_until_check -= count;
+	if (queue->operations_until_check <= 0) {
+		queue->operations_until_check = ADAPTIVE_CHECK_INTERVAL;
+		check_backend(queue, list, time);
+	}
+}
+
+/**
+* @brief Initializes an empty adaptive queue on the list backend
+* @param queue: the queue to initialize
+* @param callback: receives each switch, may be NULL
+* @param context: passed to the callback
+*/
+void initialize_adaptive_queue(AdaptiveQueue_t* queue, ProcsimQueueSwitchCallback callback, void* context) {
+	memset(queue, 0, sizeof(AdaptiveQueue_t));
+	queue->backend = READY_QUEUE_LIST;
+	queue->next_front_key = -1;
+	queue->next_back_key = 1;
+	queue->count_capacity = INITIAL_COUNT_CAPACITY;
+	queue->counts = (PriorityCount_t*)check_allocation(malloc(INITIAL_COUNT_CAPACITY * sizeof(PriorityCount_t)));
+	for (int i = 0; i < INITIAL_COUNT_CAPACITY; i++) {
+		queue->counts[i].count = -1;
+	}
+	queue->operations_until_check = ADAPTIVE_CHECK_INTERVAL;
+	queue->stats.backend = READY_QUEUE_LIST;
+	queue->callback = callback;
+	queue->context = context;
+}
+
+/**
+* @brief Adds waiting processes, placing each where enqueue_priority_queue would in array
+* order, and switches backend if a check falls due
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+* @param processes: the processes
+* @param count: number of processes
+* @param time: the current time, for the switch records
+*/
+void enqueue_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list, PCB_t** processes, int count, Procsim_Time time) {
+	if (count == 0) {
+		return;
+	}
+	Ready_Queue_Backend backend = queue->backend;
+	long start = queue->sample_clock++ % ADAPTIVE_SAMPLE_PERIOD == 0 ? adaptive_now() : -1;
+
+	if (backend == READY_QUEUE_LIST) {
+		// The list takes them in one merge
+		for (int i = 0; i < count; i++) {
+			count_priority(queue, processes[i]->priority);
+		}
+		enqueue_batch_priority_queue(list, processes, count);
+	} else {
+		// Each is counted once in, so a switch it forces reports the processes before it
+		for (int i = 0; i < count; i++) {
+			insert_process(queue, list, processes[i], time);
+			count_priority(queue, processes[i]->priority);
+		}
+	}
+
+	finish_operations(queue, list, count, backend, start, time);
+}
+
+/**
+* @brief Removes the first waiting process, and switches backend if a check falls due
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+* @param time: the current time, for the switch records
+* @return the process, the queue must not be empty
+*/
+PCB_t* dequeue_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list, Procsim_Time time) {
+	Ready_Queue_Backend backend = queue->backend;
+	long start = queue->sample_clock++ % ADAPTIVE_SAMPLE_PERIOD == 0 ? adaptive_now() : -1;
+
+	PCB_t* pcb = remove_process(queue, list);
+	uncount_priority(queue, pcb->priority);
+
+	finish_operations(queue, list, 1, backend, start, time);
+	return pcb;
+}
+
+/**
+* @brief Moves every waiting process back to the list in order and forgets them, as the
+* scheduling policy changes. The queue starts over on the list backend
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+*/
+void release_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list) {
+	if (queue->backend != READY_QUEUE_LIST) {
+		PCB_t* pcb = take_waiting_processes(queue, list);
+		queue->backend = READY_QUEUE_LIST;
+		while (pcb != NULL) {
+			PCB_t* next = pcb->next;
+			enqueue_priority_queue(list, pcb);
+			pcb = next;
+		}
+	}
+
+	for (int i = 0; i < queue->count_capacity; i++) {
+		queue->counts[i].count = -1;
+	}
+	queue->count_used = 0;
+	queue->distinct_priorities = 0;
+	queue->operations_until_check = ADAPTIVE_CHECK_INTERVAL;
+	queue->tenure_operations = 0;
+	queue->tenure_sampled = 0;
+	queue->tenure_nanoseconds = 0;
+	queue->stats.backend = READY_QUEUE_LIST;
+}
+
+/**
+* @brief Appends the clone of a waiting process to a cloned list
+*/
+static void append_clone(PCB_Store_t* clone_store, PriorityQueue_t* clone_list, const PCB_t* pcb) {
+	PCB_t* clone = get_cloned_pcb(clone_store, pcb);
+	clone->next = NULL;
+	if (clone_list->tail != NULL) {
+		clone_list->tail->next = clone;
+	} else {
+		clone_list->head = clone;
+	}
+	clone_list->tail = clone;
+	clone_list->size++;
+}
+
+/**
+* @brief Appends the clones of the waiting processes held outside the list, in order, to the
+* list of a forked simulator
+* @param queue: the adaptive queue
+* @param clone_store: the store cloned from the one owning the waiting processes
+* @param clone_list: the cloned ready queue list
+*/
+void copy_adaptive_queue(const AdaptiveQueue_t* queue, PCB_Store_t* clone_store, PriorityQueue_t* clone_list) {
+	if (queue->backend == READY_QUEUE_LIST || queue->size == 0) {
+		return;
+	}
+
+	if (queue->backend == READY_QUEUE_BUCKETS) {
+		for (long long index = queue->highest - queue->bucket_base; index >= queue->lowest - queue->bucket_base; index--) {
+			for (const PCB_t* pcb = queue->buckets[index].head; pcb != NULL; pcb = pcb->next) {
+				append_clone(clone_store, clone_list, pcb);
+			}
+		}
+		return;
+	}
+
+	// The heap is copied and sorted
+	append_clone(clone_store, clone_list, queue->first);
+	ReadyHeapEntry_t* entries = (ReadyHeapEntry_t*)check_allocation(malloc((queue->heap_size > 0 ? queue->heap_size : 1) * sizeof(ReadyHeapEntry_t)));
+	memcpy(entries, queue->heap, queue->heap_size * sizeof(ReadyHeapEntry_t));
+	qsort(entries, queue->heap_size, sizeof(ReadyHeapEntry_t), compare_entries);
+	for (int i = 0; i < queue->heap_size; i++) {
+		append_clone(clone_store, clone_list, entries[i].pcb);
+	}
+	free(entries);
+}
+
+/**
+* @brief Looks up the statistics of an adaptive queue
+* @param queue: the adaptive queue
+* @param stats: the statistics to fill in
+*/
+void get_adaptive_queue_stats(const AdaptiveQueue_t* queue, ReadyQueueStats_t* stats) {
+	*stats = queue->stats;
+	for (int i = 0; i < READY_QUEUE_BACKEND_COUNT; i++) {
+		stats->nanoseconds_per_operation[i] = queue->sampled[i] > 0 ? (double)queue->sampled_nanoseconds[i] / queue->sampled[i] : 0;
+	}
+}
+
+/**
+* @brief Clears an adaptive queue from memory. The PCB's belong to the PCB store
+* @param queue: the queue to clear
+*/
+void free_adaptive_queue(AdaptiveQueue_t* queue) {
+	free(queue->buckets);
+	free(queue->heap);
+	free(queue->counts);
+	queue->buckets = NULL;
+	queue->heap = NULL;
+	queue->counts = NULL;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file adaptive_queue.h
+ * @brief Declares the adaptive backend of the priority policy's ready queue. The waiting
+ *		  processes move between the sorted ready queue list, a list per priority and a heap
+ *		  as their number and their distinct priorities change, and run in the same order
+ *		  whatever the backend
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef ADAPTIVE_QUEUE_H
+#define ADAPTIVE_QUEUE_H
+
+// Header imports
+#include "PCB.h"
+#include "pcb_store.h"
+#include "priority_queue.h"
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+
+// Queue operations between two looks at the depth and the distinct priorities
+#define ADAPTIVE_CHECK_INTERVAL 256
+// One queue operation in this many is timed
+#define ADAPTIVE_SAMPLE_PERIOD 16
+// The list gives way past this depth, and takes over again at or below the next one
+#define ADAPTIVE_LIST_LEAVE_DEPTH 64
+#define ADAPTIVE_LIST_ENTER_DEPTH 16
+// The buckets take over at or below this many distinct priorities, and give way past the next one
+#define ADAPTIVE_BUCKETS_ENTER_PRIORITIES 32
+#define ADAPTIVE_BUCKETS_LEAVE_PRIORITIES 128
+// Widest priority range the buckets cover
+#define ADAPTIVE_MAX_BUCKET_RANGE 4096
+
+/**
+* @struct ReadyBucket_t
+* @brief Defines the waiting processes of one priority, linked through the PCB's next field
+*/
+typedef struct ready_bucket {
+	PCB_t* head;
+	PCB_t* tail;
+} ReadyBucket_t;
+
+/**
+* @struct ReadyHeapEntry_t
+* @brief Defines a waiting process in the heap. The key keeps equal priorities in list order,
+* negative keys counting down for processes placed before the others of their priority,
+* positive keys counting up for processes placed after them
+*/
+typedef struct ready_heap_entry {
+	long long key;
+	int priority;
+	PCB_t* pcb;
+} ReadyHeapEntry_t;
+
+/**
+* @struct PriorityCount_t
+* @brief Defines the number of waiting processes of one priority
+*/
+typedef struct priority_count {
+	int priority;
+	int count;			// -1 for an unused entry, 0 for a priority no longer waiting
+} PriorityCount_t;
+
+/**
+* @struct AdaptiveQueue_t
+* @brief Defines the backend state of an adaptive ready queue. With the list backend, the
+* waiting processes sit in the ready queue list as usual. Otherwise the list is empty
+*/
+typedef struct adaptive_queue {
+	Ready_Queue_Backend backend;
+	int size;					// Waiting processes held outside the list
+	int highest;				// Highest and lowest waiting priority, valid while size > 0
+	int lowest;
+
+	// Buckets backend
+	ReadyBucket_t* buckets;
+	long long bucket_base;		// Priority of the first bucket
+	int bucket_count;
+
+	// Heap backend, the first waiting process is kept out of the heap
+	PCB_t* first;
+	ReadyHeapEntry_t* heap;
+	int heap_size;
+	int heap_capacity;
+	long long next_front_key;	// Counts down from -1
+	long long next_back_key;	// Counts up from 1
+
+	// Priorities of the waiting processes whatever the backend, open addressing
+	PriorityCount_t* counts;
+	int count_capacity;
+	int count_used;				// Entries in use, priorities no longer waiting included
+	int distinct_priorities;
+
+	// Switch decisions and costs
+	int operations_until_check;
+	unsigned int sample_clock;
+	long tenure_operations;		// Since the backend was chosen
+	long tenure_sampled;
+	long tenure_nanoseconds;
+	long sampled[READY_QUEUE_BACKEND_COUNT];
+	long sampled_nanoseconds[READY_QUEUE_BACKEND_COUNT];
+	ReadyQueueStats_t stats;
+	ProcsimQueueSwitchCallback callback;
+	void* context;
+} AdaptiveQueue_t;
+
+/**
+* @brief Initializes an empty adaptive queue on the list backend
+* @param queue: the queue to initialize
+* @param callback: receives each switch, may be NULL
+* @param context: passed to the callback
+*/
+void initialize_adaptive_queue(AdaptiveQueue_t* queue, ProcsimQueueSwitchCallback callback, void* context);
+
+/**
+* @brief Adds waiting processes, placing each where enqueue_priority_queue would in array
+* order, and switches backend if a check falls due
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+* @param processes: the processes
+* @param count: number of processes
+* @param time: the current time, for the switch records
+*/
+void enqueue_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list, PCB_t** processes, int count, Procsim_Time time);
+
+/**
+* @brief Removes the first waiting process, and switches backend if a check falls due
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+* @param time: the current time, for the switch records
+* @return the process, the queue must not be empty
+*/
+PCB_t* dequeue_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list, Procsim_Time time);
+
+/**
+* @brief Moves every waiting process back to the list in order and forgets them, as the
+* scheduling policy changes. The queue starts over on the list backend
+* @param queue: the adaptive queue
+* @param list: the ready queue list
+*/
+void release_adaptive_queue(AdaptiveQueue_t* queue, PriorityQueue_t* list);
+
+/**
+* @brief Appends the clones of the waiting processes held outside the list, in order, to the
+* list of a forked simulator
+* @param queue: the adaptive queue
+* @param clone_store: the store cloned from the one owning the waiting processes
+* @param clone_list: the cloned ready queue list
+*/
+void copy_adaptive_queue(const AdaptiveQueue_t* queue, PCB_Store_t* clone_store, PriorityQueue_t* clone_list);
+
+/**
+* @brief Looks up the statistics of an adaptive queue
+* @param queue: the adaptive queue
+* @param stats: the statistics to fill in
+*/
+void get_adaptive_queue_stats(const AdaptiveQueue_t* queue, ReadyQueueStats_t* stats);
+
+/**
+* @brief Clears an adaptive queue from memory. The PCB's belong to the PCB store
+* @param queue: the queue to clear
+*/
+void free_adaptive_queue(AdaptiveQueue_t* queue);
+
+#endif //ADAPTIVE_QUEUE_H
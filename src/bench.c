@@ -0,0 +1,155 @@
+/**
+ * @file bench.c
+ * @brief Measures the event throughput of libprocsim under each scheduling policy on a
+ *		  generated trace. The trace is built in memory first, so only the simulator is timed
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Events of the generated trace unless given on the command line
+#define DEFAULT_BENCH_EVENTS 2000000
+// Runs of each policy, the fastest is reported
+#define BENCH_ROUNDS 3
+#define BENCH_DEVICES 4
+
+/**
+* @brief Steps a xorshift generator, so every run sees the same trace
+* @param state: the generator state, not 0
+* @return the next value
+*/
+static unsigned long long next_random(unsigned long long* state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/**
+* @brief Generates a trace that only holds events the simulator accepts. Processes start,
+* request I/O and end at random, and a device completes all of its requests at once
+* @param count: number of events
+* @param time_scale: time units between consecutive input times, large values push the
+* times past 32 bits
+* @return the events
+*/
+static Event_t* generate_trace(long count, long long time_scale) {
+	Event_t* events = (Event_t*)malloc((size_t)count * sizeof(Event_t));
+	if (events == NULL) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	static const int steps[] = {0, 0, 1, 1, 2, 5};
+	unsigned long long state = 88172645463325252ULL;
+	long live = 0;
+	long blocked[BENCH_DEVICES] = {0};
+	long long time = 0;
+
+	for (long i = 0; i < count; i++) {
+		time += steps[next_random(&state) % 6] * time_scale;
+		int device = (int)(next_random(&state) % BENCH_DEVICES);
+		int choice = (int)(next_random(&state) % 5);
+		Event_t* event = &events[i];
+		event->time = time;
+		event->extra = 0;
+		event->argument = 0;
+
+		if (live == 0 || choice == 0) {
+			event->operation_code = 1;
+			event->argument = (int)(next_random(&state) % 20) + 1;
+			live++;
+		} else if (choice == 1 && blocked[device] > 0) {
+			event->operation_code = 3;
+			event->argument = device;
+			live += blocked[device];
+			blocked[device] = 0;
+		} else if (choice <= 3) {
+			event->operation_code = 2;
+			event->argument = device;
+			event->extra = (long long)(next_random(&state) % 1000);
+			blocked[device]++;
+			live--;
+		} else {
+			event->operation_code = 4;
+			live--;
+		}
+	}
+	return events;
+}
+
+/**
+* @brief Reads the monotonic clock
+* @return the time in seconds
+*/
+static double get_seconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+* @brief Runs the trace through a new simulator under a policy
+* @param policy: the scheduling policy
+* @param events: the trace
+* @param count: number of events
+* @param rejected: filled in with the number of events the simulator rejected
+* @return the seconds the run took
+*/
+static double run_trace(Scheduling_Policy policy, const Event_t* events, long count, long* rejected) {
+	bool preemptive = policy == SCHEDULE_PRIORITY || policy == SCHEDULE_SRTF;
+	Procsim_t* simulator = procsim_create(preemptive, BENCH_DEVICES);
+	procsim_set_scheduling_policy(simulator, policy);
+	procsim_set_result_retention(simulator, 4096);
+
+	*rejected = 0;
+	double start = get_seconds();
+	for (long i = 0; i < count; i++) {
+		*rejected += procsim_submit_event(simulator, &events[i]) != PROCSIM_OK;
+	}
+	double seconds = get_seconds() - start;
+
+	procsim_destroy(simulator);
+	return seconds;
+}
+
+/**
+* @brief Entry point. Takes the event count and the time scale of the trace
+* @param argc: number of arguments
+* @param argv: the event count and the time scale, both optional
+* @return 0 on success
+*/
+int main(int argc, char** argv) {
+	long count = argc > 1 ? atol(argv[1]) : DEFAULT_BENCH_EVENTS;
+	long long time_scale = argc > 2 ? atoll(argv[2]) : 1;
+	if (count <= 0 || time_scale <= 0) {
+		fprintf(stderr, "ERROR: Usage: %s [event count] [time scale]\n", argv[0]);
+		return 1;
+	}
+
+	Event_t* events = generate_trace(count, time_scale);
+	printf("BENCHMARK: EVENTS %ld, LAST TIME %lld, EVENT SIZE %zu\n", count, events[count - 1].time, sizeof(Event_t));
+	for (int policy = 0; policy < SCHEDULE_POLICY_COUNT; policy++) {
+		double best = 0;
+		long rejected = 0;
+		for (int round = 0; round < BENCH_ROUNDS; round++) {
+			double seconds = run_trace((Scheduling_Policy)policy, events, count, &rejected);
+			if (round == 0 || seconds < best) {
+				best = seconds;
+			}
+		}
+		printf("POLICY %s: %.3f SECONDS, %.2f MILLION EVENTS PER SECOND, REJECTED %ld\n",
+			get_scheduling_policy_name((Scheduling_Policy)policy), best, (double)count / best / 1e6, rejected);
+	}
+
+	free(events);
+	return 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file chrome_trace.c
+ * @brief Defines the Chrome Trace Event exporter
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "chrome_trace.h"
+
+// Every track belongs to a single trace process
+#define TRACE_PID 1
+#define TRACE_CPU_TID 0
+
+/**
+* @brief Starts a new event in the events array
+*/
+static void begin_trace_event(ChromeTrace_t* trace) {
+	fputs(trace->events_written == 0 ? "\n" : ",\n", trace->output);
+	trace->events_written++;
+}
+
+/**
+* @brief Names the track of a device the first time it is used
+*/
+static void name_device_track(ChromeTrace_t* trace, int device) {
+	if (trace->device_named[device]) {
+		return;
+	}
+	trace->device_named[device] = true;
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"I/O device %d\"}}",
+			TRACE_PID, device + 1, device);
+}
+
+/**
+* @brief Writes the slice of the process on the CPU and marks the CPU idle
+*/
+static void end_cpu_slice(ChromeTrace_t* trace, Procsim_Time time) {
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"PID %lld\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+			"\"args\":{\"pid\":%lld,\"priority\":%d}}", trace->cpu_PID, TRACE_PID, TRACE_CPU_TID, trace->cpu_start,
+			time - trace->cpu_start, trace->cpu_PID, trace->cpu_priority);
+	trace->cpu_PID = 0;
+}
+
+/**
+* @brief Writes the busy period of a device that just went idle
+*/
+static void end_device_busy_slice(ChromeTrace_t* trace, int device, Procsim_Time time) {
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"busy\",\"cat\":\"io\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+			TRACE_PID, device + 1, trace->device_busy_start[device], time - trace->device_busy_start[device]);
+}
+
+/**
+* @brief Writes the ready queue counter if its value changed
+*/
+static void update_ready_counter(ChromeTrace_t* trace, Procsim_Time time, int length) {
+	if (length == trace->ready_length) {
+		return;
+	}
+	trace->ready_length = length;
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"ready queue\",\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"args\":{\"length\":%d}}",
+			TRACE_PID, time, length);
+}
+
+/**
+* @brief Writes the request counter of a device if its value changed, and opens or closes the
+* device's busy period when it leaves or reaches zero
+*/
+static void update_device_requests(ChromeTrace_t* trace, int device, Procsim_Time time, int requests) {
+	int previous = trace->device_requests[device];
+	if (requests == previous) {
+		return;
+	}
+	trace->device_requests[device] = requests;
+
+	if (previous == 0) {
+		trace->device_busy_start[device] = time;
+	} else if (requests == 0) {
+		end_device_busy_slice(trace, device, time);
+	}
+
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"I/O device %d requests\",\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"args\":{\"requests\":%d}}",
+			device, TRACE_PID, time, requests);
+}
+
+/**
+* @brief Creates the trace file and writes the CPU track metadata
+* @param trace: the exporter to open
+* @param path: the JSON file to write
+* @return true on success, false if the file could not be created
+*/
+bool open_chrome_trace(ChromeTrace_t* trace, const char* path) {
+	trace->output = fopen(path, "w");
+	if (trace->output == NULL) {
+		return false;
+	}
+	setvbuf(trace->output, NULL, _IOFBF, LOG_WRITE_BUFFER_SIZE);
+
+	trace->events_written = 0;
+	trace->cpu_PID = 0;
+	trace->cpu_priority = 0;
+	trace->cpu_start = 0;
+	trace->ready_length = 0;
+	for (int i = 0; i < TRACE_MAX_DEVICES; i++) {
+		trace->device_requests[i] = 0;
+		trace->device_busy_start[i] = 0;
+		trace->device_named[i] = false;
+	}
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", trace->output);
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"Scheduler\"}}", TRACE_PID);
+	begin_trace_event(trace);
+	fprintf(trace->output, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"CPU\"}}",
+			TRACE_PID, TRACE_CPU_TID);
+	return true;
+}
+
+/**
+* @brief Adds a scheduling event to the timeline
+* @param trace: the exporter
+* @param record: the event
+*/
+void add_chrome_trace_record(ChromeTrace_t* trace, const LogRecord_t* record) {
+	int device = record->device;
+
+	switch (record->kind) {
+		case LOG_PROCESS_SCHEDULED:
+			if (trace->cpu_PID != 0) {
+				end_cpu_slice(trace, record->time);
+			}
+			trace->cpu_PID = record->PID;
+			trace->cpu_priority = record->priority;
+			trace->cpu_start = record->time;
+			break;
+		case LOG_PROCESS_PREEMPTED:
+		case LOG_PROCESS_ENDED:
+		case LOG_IO_WAITING:
+			if (trace->cpu_PID == record->PID) {
+				end_cpu_slice(trace, record->time);
+			}
+			break;
+		default:
+			break;
+	}
+
+	if (device < 0) {
+		update_ready_counter(trace, record->time, record->queue_length);
+		return;
+	}
+
+	// The wait of each process on a device is an async slice on the device's track
+	name_device_track(trace, device);
+	if (record->kind == LOG_IO_WAITING || record->kind == LOG_IO_RELEASED) {
+		begin_trace_event(trace);
+		fprintf(trace->output, "{\"name\":\"PID %lld\",\"cat\":\"io_wait\",\"ph\":\"%s\",\"id\":%lld,\"pid\":%d,\"tid\":%d,\"ts\":%lld}",
+				record->PID, record->kind == LOG_IO_WAITING ? "b" : "e", record->PID, TRACE_PID, device + 1, record->time);
+	}
+	update_device_requests(trace, device, record->time, record->queue_length);
+}
+
+/**
+* @brief Ends the slices still open, completes the JSON document and closes the file
+* @param trace: the exporter
+* @param end_time: the time the open slices end at
+* @return true on success, false if the file could not be written
+*/
+bool close_chrome_trace(ChromeTrace_t* trace, Procsim_Time end_time) {
+	if (trace->cpu_PID != 0) {
+		end_cpu_slice(trace, end_time);
+	}
+	for (int i = 0; i < TRACE_MAX_DEVICES; i++) {
+		if (trace->device_requests[i] > 0) {
+			end_device_busy_slice(trace, i, end_time);
+		}
+	}
+
+	fputs("\n]}\n", trace->output);
+	bool ok = !ferror(trace->output);
+	if (fclose(trace->output) != 0) {
+		ok = false;
+	}
+	trace->output = NULL;
+	return ok;
+}
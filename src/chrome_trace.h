@@ -0,0 +1,69 @@
+/**
+ * @file chrome_trace.h
+ * @brief Declares the Chrome Trace Event exporter, which streams scheduling events into a
+ *		  JSON timeline that trace viewers such as Perfetto can open
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+// Header imports
+#include "log_sink.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+
+// Device identifiers a log record can carry
+#define TRACE_MAX_DEVICES 128
+
+/**
+* @struct ChromeTrace_t
+* @brief Defines the exporter state. Only the open CPU slice and the state of each device are
+* kept, every finished slice is written out right away
+*/
+typedef struct chrome_trace {
+	FILE* output;
+	long events_written;
+
+	// Slice of the process on the CPU, PID 0 when the CPU is idle
+	Procsim_PID cpu_PID;
+	int cpu_priority;
+	Procsim_Time cpu_start;
+
+	int ready_length;
+
+	// Per device request count, start of the current busy period and whether the track is named
+	int device_requests[TRACE_MAX_DEVICES];
+	Procsim_Time device_busy_start[TRACE_MAX_DEVICES];
+	bool device_named[TRACE_MAX_DEVICES];
+} ChromeTrace_t;
+
+/**
+* @brief Creates the trace file and writes the CPU track metadata
+* @param trace: the exporter to open
+* @param path: the JSON file to write
+* @return true on success, false if the file could not be created
+*/
+bool open_chrome_trace(ChromeTrace_t* trace, const char* path);
+
+/**
+* @brief Adds a scheduling event to the timeline
+* @param trace: the exporter
+* @param record: the event
+*/
+void add_chrome_trace_record(ChromeTrace_t* trace, const LogRecord_t* record);
+
+/**
+* @brief Ends the slices still open, completes the JSON document and closes the file
+* @param trace: the exporter
+* @param end_time: the time the open slices end at
+* @return true on success, false if the file could not be written
+*/
+bool close_chrome_trace(ChromeTrace_t* trace, Procsim_Time end_time);
+
+#endif //CHROME_TRACE_H
@@ -0,0 +1,366 @@
+/**
+ * @file compressed_input.c
+ * @brief Defines the compressed input file reader
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "compressed_input.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+// Bytes zlib reads from the file at a time
+#define GZIP_READ_BUFFER_SIZE 131072
+
+/**
+* @brief Decompresses the next block of the file
+* @param input: the reader
+* @param block: filled in with up to DECOMPRESSED_BLOCK_SIZE bytes
+* @return the number of bytes, 0 at the end of the file or on an error
+*/
+static size_t decompress_block(CompressedInput_t* input, char* block) {
+	size_t size = 0;
+	if (input->compression == INPUT_GZIP) {
+		// zlib moves on to the next member of a concatenated file by itself
+		int length = gzread(input->gzip, block, DECOMPRESSED_BLOCK_SIZE);
+		int error = Z_OK;
+		if (length <= 0) {
+			// A file cut short ends with a buffer error instead of a clean end of file
+			gzerror(input->gzip, &error);
+		}
+		if (length < 0 || error != Z_OK) {
+			input->failed = true;
+		} else {
+			size = (size_t)length;
+		}
+	}
+#ifdef PROCSIM_ZSTD
+	if (input->compression == INPUT_ZSTD) {
+		ZSTD_outBuffer output = {block, DECOMPRESSED_BLOCK_SIZE, 0};
+		while (output.pos < output.size) {
+			if (input->zstd_input.pos == input->zstd_input.size) {
+				size_t length = fread(input->zstd_buffer, 1, input->zstd_buffer_size, input->file);
+				if (length == 0) {
+					// A frame still waiting for input means the file was cut short
+					input->failed = input->zstd_frame_left != 0;
+					break;
+				}
+				input->zstd_input.src = input->zstd_buffer;
+				input->zstd_input.size = length;
+				input->zstd_input.pos = 0;
+			}
+			size_t result = ZSTD_decompressStream(input->zstd, &output, &input->zstd_input);
+			input->zstd_frame_left = result;
+			if (ZSTD_isError(result)) {
+				input->failed = true;
+				break;
+			}
+		}
+		size = output.pos;
+	}
+#endif
+	input->blocks_decompressed += size > 0;
+	input->bytes_decompressed += (long)size;
+	return size;
+}
+
+/**
+* @brief Body of the decompressor thread. Fills the ring a block at a time until the end of
+* the file or until the reader cancels
+* @param argument: the reader
+*/
+static void* run_decompressor(void* argument) {
+	CompressedInput_t* input = (CompressedInput_t*)argument;
+
+	while (true) {
+		if (input->producer_tail - atomic_load_explicit(&input->head, memory_order_acquire) >= DECOMPRESSED_BLOCK_COUNT) {
+			input->decompressor_stalls++;
+			while (input->producer_tail - atomic_load_explicit(&input->head, memory_order_acquire) >= DECOMPRESSED_BLOCK_COUNT) {
+				if (atomic_load_explicit(&input->cancelled, memory_order_relaxed)) {
+					break;
+				}
+				sched_yield();
+			}
+		}
+		if (atomic_load_explicit(&input->cancelled, memory_order_relaxed)) {
+			break;
+		}
+
+		int slot = (int)(input->producer_tail % DECOMPRESSED_BLOCK_COUNT);
+		size_t size = decompress_block(input, input->blocks + (size_t)slot * DECOMPRESSED_BLOCK_SIZE);
+		if (size == 0) {
+			break;
+		}
+		input->block_sizes[slot] = size;
+		input->producer_tail++;
+		atomic_store_explicit(&input->tail, input->producer_tail, memory_order_release);
+	}
+
+	atomic_store_explicit(&input->finished, true, memory_order_release);
+	return NULL;
+}
+
+/**
+* @brief Moves the reader to the next decompressed block
+* @return true if there is one, false at the end of the input
+*/
+static bool next_block(CompressedInput_t* input) {
+	if (!input->threaded) {
+		input->block = input->blocks;
+		input->block_size = decompress_block(input, input->blocks);
+		input->block_position = 0;
+		return input->block_size > 0;
+	}
+
+	// The block just read goes back to the decompressor
+	if (input->holding_block) {
+		input->consumer_head++;
+		atomic_store_explicit(&input->head, input->consumer_head, memory_order_release);
+		input->holding_block = false;
+	}
+
+	bool stalled = false;
+	while (true) {
+		// The decompressor publishes its last block before it sets finished
+		bool finished = atomic_load_explicit(&input->finished, memory_order_acquire);
+		if (input->consumer_head != atomic_load_explicit(&input->tail, memory_order_acquire)) {
+			break;
+		}
+		if (finished) {
+			return false;
+		}
+		if (!stalled) {
+			input->reader_stalls++;
+			stalled = true;
+		}
+		sched_yield();
+	}
+
+	int slot = (int)(input->consumer_head % DECOMPRESSED_BLOCK_COUNT);
+	input->block = input->blocks + (size_t)slot * DECOMPRESSED_BLOCK_SIZE;
+	input->block_size = input->block_sizes[slot];
+	input->block_position = 0;
+	input->holding_block = true;
+	return true;
+}
+
+/**
+* @brief Tells the format of an input file from its first bytes
+* @param path: the input file
+* @return the format, INPUT_PLAIN if the file could not be read
+*/
+Input_Compression detect_input_compression(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return INPUT_PLAIN;
+	}
+	unsigned char magic[4] = {0, 0, 0, 0};
+	size_t length = fread(magic, 1, sizeof(magic), file);
+	fclose(file);
+
+	if (length >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+		return INPUT_GZIP;
+	}
+	if (length == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+		return INPUT_ZSTD;
+	}
+	return INPUT_PLAIN;
+}
+
+/**
+* @brief Checks whether this build can read a format
+* @param compression: the format
+* @return true if it can
+*/
+bool is_compression_supported(Input_Compression compression) {
+	if (compression == INPUT_ZSTD) {
+#ifdef PROCSIM_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	}
+	return true;
+}
+
+/**
+* @brief Names a format
+* @param compression: the format
+* @return the name
+*/
+const char* get_compression_name(Input_Compression compression) {
+	switch (compression) {
+		case INPUT_GZIP:
+			return "gzip";
+		case INPUT_ZSTD:
+			return "zstd";
+		default:
+			return "plain";
+	}
+}
+
+/**
+* @brief Opens a compressed input file. With threading a decompressor thread starts filling
+* the ring
+* @param input: the reader to open
+* @param path: the input file
+* @param compression: the format of the file, which this build can read
+* @param threaded: whether to decompress on a separate thread
+* @return true on success, false if the file could not be opened
+*/
+bool open_compressed_input(CompressedInput_t* input, const char* path, Input_Compression compression, bool threaded) {
+	input->compression = compression;
+	input->gzip = NULL;
+	input->threaded = threaded;
+	input->blocks = NULL;
+	input->producer_tail = 0;
+	input->blocks_decompressed = 0;
+	input->bytes_decompressed = 0;
+	input->decompressor_stalls = 0;
+	input->failed = false;
+	input->consumer_head = 0;
+	input->holding_block = false;
+	input->block = NULL;
+	input->block_size = 0;
+	input->block_position = 0;
+	input->reader_stalls = 0;
+	atomic_init(&input->tail, 0);
+	atomic_init(&input->head, 0);
+	atomic_init(&input->finished, false);
+	atomic_init(&input->cancelled, false);
+
+	if (compression == INPUT_GZIP) {
+		input->gzip = gzopen(path, "rb");
+		if (input->gzip == NULL) {
+			return false;
+		}
+		gzbuffer(input->gzip, GZIP_READ_BUFFER_SIZE);
+	}
+#ifdef PROCSIM_ZSTD
+	input->file = NULL;
+	input->zstd = NULL;
+	input->zstd_buffer = NULL;
+	if (compression == INPUT_ZSTD) {
+		input->file = fopen(path, "rb");
+		input->zstd = ZSTD_createDStream();
+		input->zstd_buffer_size = ZSTD_DStreamInSize();
+		input->zstd_buffer = malloc(input->zstd_buffer_size);
+		if (input->file == NULL || input->zstd == NULL || input->zstd_buffer == NULL) {
+			close_compressed_input(input);
+			return false;
+		}
+		ZSTD_initDStream(input->zstd);
+		input->zstd_input.src = input->zstd_buffer;
+		input->zstd_input.size = 0;
+		input->zstd_input.pos = 0;
+		input->zstd_frame_left = 0;
+	}
+#endif
+
+	input->blocks = (char*)malloc((size_t)(threaded ? DECOMPRESSED_BLOCK_COUNT : 1) * DECOMPRESSED_BLOCK_SIZE);
+	if (input->blocks == NULL) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	if (threaded && pthread_create(&input->decompressor, NULL, run_decompressor, input) != 0) {
+		fprintf(stderr, "ERROR: Could not start the decompressor thread!\n");
+		exit(1);
+	}
+	return true;
+}
+
+/**
+* @brief Reads the next line of the decompressed input, as fgets does
+* @param input: the reader
+* @param line: filled in with the line and its newline, if it fits
+* @param size: size of line
+* @return true if a line was read, false at the end of the input
+*/
+bool read_compressed_line(CompressedInput_t* input, char* line, int size) {
+	size_t length = 0;
+
+	// A line can run over into the next block
+	while (length + 1 < (size_t)size) {
+		if (input->block_position == input->block_size && !next_block(input)) {
+			break;
+		}
+		const char* start = input->block + input->block_position;
+		size_t available = input->block_size - input->block_position;
+		if (available > (size_t)size - 1 - length) {
+			available = (size_t)size - 1 - length;
+		}
+		const char* newline = (const char*)memchr(start, '\n', available);
+		size_t count = newline != NULL ? (size_t)(newline - start) + 1 : available;
+		memcpy(line + length, start, count);
+		length += count;
+		input->block_position += count;
+		if (newline != NULL) {
+			break;
+		}
+	}
+	line[length] = '\0';
+	return length > 0;
+}
+
+/**
+* @brief Reads the next event out of the decompressed input, skipping blank lines
+* @param input: the reader, past the simulation parameters
+* @param event: the event to fill in
+* @return true if an event was read, false at the end of the input
+*/
+bool read_compressed_event(CompressedInput_t* input, Event_t* event) {
+	char line[128];
+
+	while (read_compressed_line(input, line, sizeof(line))) {
+		if (parse_event(line, event)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+* @brief Stops the decompressor thread, even if it has not reached the end of the file, closes
+* the file and clears the blocks from memory
+* @param input: the reader to close
+*/
+void close_compressed_input(CompressedInput_t* input) {
+	if (input->threaded && input->blocks != NULL) {
+		atomic_store_explicit(&input->cancelled, true, memory_order_relaxed);
+		pthread_join(input->decompressor, NULL);
+	}
+	free(input->blocks);
+	input->blocks = NULL;
+
+	if (input->gzip != NULL) {
+		gzclose(input->gzip);
+		input->gzip = NULL;
+	}
+#ifdef PROCSIM_ZSTD
+	if (input->file != NULL) {
+		fclose(input->file);
+		input->file = NULL;
+	}
+	ZSTD_freeDStream(input->zstd);
+	input->zstd = NULL;
+	free(input->zstd_buffer);
+	input->zstd_buffer = NULL;
+#endif
+}
+
+/**
+* @brief Prints the format, block and byte counts and stall counters of a threaded reader
+* @param input: the closed reader
+*/
+void print_compressed_input_summary(const CompressedInput_t* input) {
+	printf("DECOMPRESSION: FORMAT %s, BLOCKS %ld, BYTES %ld, DECOMPRESSOR STALLS %ld, READER STALLS %ld\n",
+		get_compression_name(input->compression), input->blocks_decompressed, input->bytes_decompressed,
+		input->decompressor_stalls, input->reader_stalls);
+}
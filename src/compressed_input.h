@@ -0,0 +1,153 @@
+/**
+ * @file compressed_input.h
+ * @brief Declares the compressed input file reader. A gzip or zstd input file is decompressed
+ *		  a block at a time and the event lines are read straight out of the decompressed
+ *		  blocks, optionally with a decompressor thread filling a ring of blocks ahead of the
+ *		  reader
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+// Header imports
+#include "event.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <zlib.h>
+#ifdef PROCSIM_ZSTD
+#include <zstd.h>
+#endif
+
+#define DECOMPRESSED_CACHE_LINE_SIZE 64
+
+// Bytes of decompressed input per block
+#define DECOMPRESSED_BLOCK_SIZE 65536
+// Blocks in the ring of the decompressor thread
+#define DECOMPRESSED_BLOCK_COUNT 8
+
+/**
+* @enum Input_Compression
+* @brief Defines the formats an input file can be in, told apart by their first bytes
+*/
+typedef enum input_compression {
+	INPUT_PLAIN,
+	INPUT_GZIP,		// Starts with 1f 8b
+	INPUT_ZSTD		// Starts with 28 b5 2f fd, read when built with make ZSTD=1
+} Input_Compression;
+
+/**
+* @struct CompressedInput_t
+* @brief Defines a compressed input file being read. Without threading the reader decompresses
+* into the first block itself. With threading the decompressor thread fills the ring and the
+* reader hands each block back once it has read it, the two sides keeping their fields on
+* separate cache lines
+*/
+typedef struct compressed_input {
+	Input_Compression compression;
+	gzFile gzip;
+#ifdef PROCSIM_ZSTD
+	FILE* file;
+	ZSTD_DStream* zstd;
+	void* zstd_buffer;			// Compressed bytes read from the file
+	size_t zstd_buffer_size;
+	ZSTD_inBuffer zstd_input;
+	size_t zstd_frame_left;		// Last hint of the decoder, 0 once a frame is complete
+#endif
+	bool threaded;
+	char* blocks;				// DECOMPRESSED_BLOCK_COUNT blocks, only the first without threading
+	size_t block_sizes[DECOMPRESSED_BLOCK_COUNT];
+	pthread_t decompressor;
+
+	// Producer (decompressor thread) side. Without threading the reader is the producer
+	_Alignas(DECOMPRESSED_CACHE_LINE_SIZE) atomic_ulong tail;	// Blocks published to the reader
+	unsigned long producer_tail;
+	long blocks_decompressed;
+	long bytes_decompressed;
+	long decompressor_stalls;	// Times the ring was full
+	bool failed;				// Set when the file turned out corrupt or truncated
+
+	// Consumer (reader) side
+	_Alignas(DECOMPRESSED_CACHE_LINE_SIZE) atomic_ulong head;	// Blocks handed back to the producer
+	unsigned long consumer_head;
+	bool holding_block;			// Whether the reader is still reading the block at consumer_head
+	const char* block;
+	size_t block_size;
+	size_t block_position;
+	long reader_stalls;			// Times the ring was empty
+
+	// Shutdown flags
+	_Alignas(DECOMPRESSED_CACHE_LINE_SIZE) atomic_bool finished;	// Set by the producer at the end of the file
+	atomic_bool cancelled;											// Set by the reader to stop the producer
+} CompressedInput_t;
+
+/**
+* @brief Tells the format of an input file from its first bytes
+* @param path: the input file
+* @return the format, INPUT_PLAIN if the file could not be read
+*/
+Input_Compression detect_input_compression(const char* path);
+
+/**
+* @brief Checks whether this build can read a format
+* @param compression: the format
+* @return true if it can
+*/
+bool is_compression_supported(Input_Compression compression);
+
+/**
+* @brief Names a format
+* @param compression: the format
+* @return the name
+*/
+const char* get_compression_name(Input_Compression compression);
+
+/**
+* @brief Opens a compressed input file. With threading a decompressor thread starts filling
+* the ring
+* @param input: the reader to open
+* @param path: the input file
+* @param compression: the format of the file, which this build can read
+* @param threaded: whether to decompress on a separate thread
+* @return true on success, false if the file could not be opened
+*/
+bool open_compressed_input(CompressedInput_t* input, const char* path, Input_Compression compression, bool threaded);
+
+/**
+* @brief Reads the next line of the decompressed input, as fgets does
+* @param input: the reader
+* @param line: filled in with the line and its newline, if it fits
+* @param size: size of line
+* @return true if a line was read, false at the end of the input
+*/
+bool read_compressed_line(CompressedInput_t* input, char* line, int size);
+
+/**
+* @brief Reads the next event out of the decompressed input, skipping blank lines
+* @param input: the reader, past the simulation parameters
+* @param event: the event to fill in
+* @return true if an event was read, false at the end of the input
+*/
+bool read_compressed_event(CompressedInput_t* input, Event_t* event);
+
+/**
+* @brief Stops the decompressor thread, even if it has not reached the end of the file, closes
+* the file and clears the blocks from memory
+* @param input: the reader to close
+*/
+void close_compressed_input(CompressedInput_t* input);
+
+/**
+* @brief Prints the format, block and byte counts and stall counters of a threaded reader
+* @param input: the closed reader
+*/
+void print_compressed_input_summary(const CompressedInput_t* input);
+
+#endif //COMPRESSED_INPUT_H
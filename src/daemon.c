@@ -0,0 +1,446 @@
+/**
+ * @file daemon.c
+ * @brief Defines the daemon mode of the simulator
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "daemon.h"
+#include "event.h"
+// Library imports
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Set by SIGINT and SIGTERM, the daemon finishes the events it holds and returns
+static volatile sig_atomic_t stop_requested = 0;
+
+/**
+* @brief Asks the daemon to stop
+*/
+static void handle_stop_signal(int signal_number) {
+	(void)signal_number;
+	stop_requested = 1;
+}
+
+/**
+* @brief Reads the monotonic clock
+* @return the time in nanoseconds
+*/
+static long daemon_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+* @brief Switches a descriptor to non-blocking reads
+* @return true on success
+*/
+static bool set_nonblocking(int fd) {
+	int flags = fcntl(fd, F_GETFL);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+* @brief Creates a non-blocking UNIX stream socket listening on a path. A socket left behind
+* by an earlier run is replaced, any other file is not
+* @param path: the socket path
+* @return the listening socket, or -1 on failure
+*/
+static int open_listen_socket(const char* path) {
+	struct sockaddr_un address;
+	if (strlen(path) >= sizeof(address.sun_path)) {
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+
+	struct stat info;
+	if (stat(path, &info) == 0 && S_ISSOCK(info.st_mode)) {
+		unlink(path);
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	if (!set_nonblocking(fd) || bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 8) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/**
+* @brief Opens the event source and the statistics socket. An existing named pipe is read
+* directly, any other path becomes a UNIX stream socket that accepts one producer at a time
+* @param daemon: the daemon to open
+* @param event_path: the named pipe or socket path events arrive on
+* @param stats_path: the socket path statistics are served on, NULL for none
+* @return true on success, false if a path could not be opened
+*/
+bool open_daemon(Daemon_t* daemon, const char* event_path, const char* stats_path) {
+	memset(daemon, 0, sizeof(*daemon));
+	daemon->event_path = event_path;
+	daemon->stats_path = stats_path;
+	daemon->listen_fd = -1;
+	daemon->event_fd = -1;
+	daemon->stats_fd = -1;
+
+	struct stat info;
+	if (stat(event_path, &info) == 0 && S_ISFIFO(info.st_mode)) {
+		// Holding the write end open as well keeps the pipe from reaching end of file
+		// whenever the last producer closes it
+		daemon->event_fd = open(event_path, O_RDWR | O_NONBLOCK);
+		if (daemon->event_fd < 0) {
+			return false;
+		}
+	} else {
+		daemon->event_socket = true;
+		daemon->listen_fd = open_listen_socket(event_path);
+		if (daemon->listen_fd < 0) {
+			daemon->event_socket = false;
+			return false;
+		}
+	}
+
+	if (stats_path != NULL) {
+		daemon->stats_fd = open_listen_socket(stats_path);
+		if (daemon->stats_fd < 0) {
+			daemon->stats_path = NULL;
+			close_daemon(daemon);
+			return false;
+		}
+	}
+
+	// No SA_RESTART, so a signal also wakes the daemon out of poll
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handle_stop_signal;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	// A statistics client that hangs up early must not end the daemon
+	signal(SIGPIPE, SIG_IGN);
+	return true;
+}
+
+/**
+* @brief Finds the bucket holding a percentile of the latencies
+* @return the upper bound of the bucket in nanoseconds
+*/
+static long get_latency_percentile(const Daemon_t* daemon, double percentile) {
+	long rank = (long)(daemon->events_applied * percentile);
+	long seen = 0;
+	for (int i = 0; i < DAEMON_LATENCY_BUCKETS; i++) {
+		seen += daemon->latency_buckets[i];
+		if (seen > rank) {
+			return 1L << i;
+		}
+	}
+	return 1L << (DAEMON_LATENCY_BUCKETS - 1);
+}
+
+/**
+* @brief Answers one statistics request with a single line and hangs up
+* @param daemon: the daemon
+* @param simulator: the simulator, NULL while the simulation parameters have not arrived
+*/
+static void serve_daemon_stats(Daemon_t* daemon, const Procsim_t* simulator) {
+	int client = accept(daemon->stats_fd, NULL, NULL);
+	if (client < 0) {
+		return;
+	}
+	daemon->stats_requests++;
+
+	char reply[512];
+	int length;
+	if (simulator == NULL) {
+		length = snprintf(reply, sizeof(reply), "waiting for the simulation parameters\n");
+	} else {
+		ProcsimStats_t stats;
+		procsim_get_stats(simulator, &stats);
+		long completed = stats.processes_completed > 0 ? stats.processes_completed : 1;
+		double latency_mean = daemon->events_applied > 0 ? (double)daemon->total_latency / daemon->events_applied : 0.0;
+		length = snprintf(reply, sizeof(reply),
+			"events %ld rejected %ld malformed %ld time %lld idle %lld started %ld live %ld completed %ld ready %d "
+			"cpu %s mean_ready_wait %.2f mean_io_wait %.2f latency_mean_ns %.0f latency_p99_ns %ld latency_max_ns %ld\n",
+			daemon->events_applied, daemon->events_rejected, daemon->lines_malformed, stats.last_event_time,
+			stats.idle_time, stats.processes_started, stats.processes_live, stats.processes_completed,
+			procsim_get_ready_queue_length(simulator), procsim_is_cpu_busy(simulator) ? "busy" : "idle",
+			(double)stats.total_ready_wait_time / completed, (double)stats.total_io_wait_time / completed,
+			latency_mean, daemon->events_applied > 0 ? get_latency_percentile(daemon, 0.99) : 0L, daemon->max_latency);
+	}
+
+	// The reply fits the socket buffer of a new connection, so the write does not wait on the client
+	if (write(client, reply, length) < 0) {
+		// The client hung up first, nothing to report
+	}
+	close(client);
+}
+
+/**
+* @brief Waits for the event source, accepting producers and answering statistics requests
+* on the way
+* @param daemon: the daemon
+* @param simulator: the simulator statistics come from, NULL while it does not exist
+* @return true if the event source is ready to read, false if not, for example after a signal
+*/
+static bool wait_for_events(Daemon_t* daemon, const Procsim_t* simulator) {
+	struct pollfd fds[2];
+	int count = 0;
+	fds[count].fd = daemon->event_fd >= 0 ? daemon->event_fd : daemon->listen_fd;
+	fds[count++].events = POLLIN;
+	if (daemon->stats_fd >= 0) {
+		fds[count].fd = daemon->stats_fd;
+		fds[count++].events = POLLIN;
+	}
+
+	if (poll(fds, count, -1) <= 0) {
+		return false;
+	}
+
+	if (count > 1 && (fds[1].revents & POLLIN)) {
+		serve_daemon_stats(daemon, simulator);
+	}
+	if (fds[0].revents == 0) {
+		return false;
+	}
+	if (daemon->event_fd < 0) {
+		// Producers are served one at a time, the next one waits in the listen backlog
+		daemon->event_fd = accept(daemon->listen_fd, NULL, NULL);
+		if (daemon->event_fd >= 0 && !set_nonblocking(daemon->event_fd)) {
+			close(daemon->event_fd);
+			daemon->event_fd = -1;
+		}
+		if (daemon->event_fd >= 0) {
+			daemon->producers++;
+		}
+		return false;
+	}
+	return true;
+}
+
+/**
+* @brief Reads what the event source holds into the buffer, after the bytes of an incomplete line
+* @param daemon: the daemon
+*/
+static void read_event_source(Daemon_t* daemon) {
+	// One byte stays free for the newline a disconnecting producer may leave off
+	ssize_t count = read(daemon->event_fd, daemon->buffer + daemon->buffered,
+						 DAEMON_BUFFER_SIZE - 1 - daemon->buffered);
+	if (count > 0) {
+		daemon->buffered += count;
+		if (daemon->buffered == DAEMON_BUFFER_SIZE - 1 && memchr(daemon->buffer, '\n', daemon->buffered) == NULL) {
+			// No line is this long, drop it rather than stall
+			daemon->lines_malformed++;
+			daemon->buffered = 0;
+		}
+		return;
+	}
+	if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+		return;
+	}
+	if (!daemon->event_socket) {
+		return;
+	}
+
+	// The producer disconnected. Its last line counts even without a newline
+	if (daemon->buffered > 0) {
+		daemon->buffer[daemon->buffered++] = '\n';
+	}
+	close(daemon->event_fd);
+	daemon->event_fd = -1;
+}
+
+/**
+* @brief Checks whether a line holds nothing but whitespace
+*/
+static bool is_blank_line(const char* line) {
+	return line[strspn(line, " \t\r")] == '\0';
+}
+
+/**
+* @brief Waits for the first line of the event stream, which holds the simulation parameters
+* @param daemon: the daemon
+* @param policy: filled in with the scheduling policy, FIFO for an unknown value
+* @return true once the line was read, false if the daemon was stopped first or the line is malformed
+*/
+bool read_daemon_header(Daemon_t* daemon, Scheduling_Policy* policy) {
+	while (!stop_requested) {
+		char* newline = (char*)memchr(daemon->buffer, '\n', daemon->buffered);
+		if (newline == NULL) {
+			if (wait_for_events(daemon, NULL)) {
+				read_event_source(daemon);
+			}
+			continue;
+		}
+
+		*newline = '\0';
+		bool blank = is_blank_line(daemon->buffer);
+		int scheduler = 0;
+		bool ok = sscanf(daemon->buffer, "%d", &scheduler) == 1;
+
+		// Whatever follows the line is already part of the events
+		daemon->buffered -= newline + 1 - daemon->buffer;
+		memmove(daemon->buffer, newline + 1, daemon->buffered);
+		if (!blank) {
+			*policy = scheduler > 0 && scheduler < SCHEDULE_POLICY_COUNT ? (Scheduling_Policy)scheduler : SCHEDULE_FIFO;
+			return ok;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Submits a batch of events, reporting and skipping the ones the simulator rejects
+* @param daemon: the daemon
+* @param simulator: the simulator
+* @param batch: the events
+* @param count: number of events
+* @param read_time: when the bytes holding the events were read
+*/
+static void submit_daemon_batch(Daemon_t* daemon, Procsim_t* simulator, const Event_t* batch, int count, long read_time) {
+	long handled = 0;
+	long rejected = 0;
+	while (handled < count) {
+		Procsim_Status status = PROCSIM_OK;
+		handled += procsim_submit_events(simulator, batch + handled, count - handled, &status);
+		if (status != PROCSIM_OK) {
+			fprintf(stderr, "ERROR: Rejected event at time %lld: %s\n", batch[handled].time,
+					procsim_get_status_message(status));
+			rejected++;
+			handled++;
+		}
+	}
+
+	// Every event of the batch was decided on once the batch returned
+	long latency = daemon_now() - read_time;
+	int bucket = 0;
+	while (bucket < DAEMON_LATENCY_BUCKETS - 1 && latency >= (1L << bucket)) {
+		bucket++;
+	}
+	long applied = count - rejected;
+	daemon->latency_buckets[bucket] += applied;
+	daemon->total_latency += latency * applied;
+	if (latency > daemon->max_latency) {
+		daemon->max_latency = latency;
+	}
+	daemon->events_applied += applied;
+	daemon->events_rejected += rejected;
+	daemon->batches++;
+}
+
+/**
+* @brief Applies every complete line of the buffer and keeps the incomplete one
+* @param daemon: the daemon
+* @param simulator: the simulator
+* @param read_time: when the bytes were read
+*/
+static void apply_buffered_events(Daemon_t* daemon, Procsim_t* simulator, long read_time) {
+	Event_t batch[DAEMON_BATCH_SIZE];
+	int count = 0;
+	char* line = daemon->buffer;
+	char* end = daemon->buffer + daemon->buffered;
+	char* newline;
+
+	while ((newline = (char*)memchr(line, '\n', end - line)) != NULL) {
+		*newline = '\0';
+		Event_t event;
+		if (!parse_event(line, &event)) {
+			if (!is_blank_line(line)) {
+				daemon->lines_malformed++;
+			}
+		} else if (daemon->has_last_time && event.time < daemon->last_time) {
+			// The simulator needs events in time order, a late one is dropped
+			fprintf(stderr, "ERROR: Rejected event at time %lld: Event is earlier than time %lld\n",
+					event.time, daemon->last_time);
+			daemon->events_rejected++;
+		} else {
+			daemon->has_last_time = true;
+			daemon->last_time = event.time;
+			batch[count++] = event;
+			if (count == DAEMON_BATCH_SIZE) {
+				submit_daemon_batch(daemon, simulator, batch, count, read_time);
+				count = 0;
+			}
+		}
+		line = newline + 1;
+	}
+	if (count > 0) {
+		submit_daemon_batch(daemon, simulator, batch, count, read_time);
+	}
+
+	daemon->buffered = end - line;
+	memmove(daemon->buffer, line, daemon->buffered);
+}
+
+/**
+* @brief Applies events as they arrive and answers statistics requests until SIGINT or SIGTERM
+* @param daemon: the daemon
+* @param simulator: the simulator the events go to
+*/
+void run_daemon(Daemon_t* daemon, Procsim_t* simulator) {
+	// Events that arrived along with the simulation parameters
+	apply_buffered_events(daemon, simulator, daemon_now());
+
+	while (!stop_requested) {
+		if (wait_for_events(daemon, simulator)) {
+			read_event_source(daemon);
+			apply_buffered_events(daemon, simulator, daemon_now());
+		}
+	}
+}
+
+/**
+* @brief Closes the event source and the statistics socket and removes the socket files
+* @param daemon: the daemon to close
+*/
+void close_daemon(Daemon_t* daemon) {
+	if (daemon->event_fd >= 0) {
+		close(daemon->event_fd);
+		daemon->event_fd = -1;
+	}
+	if (daemon->listen_fd >= 0) {
+		close(daemon->listen_fd);
+		daemon->listen_fd = -1;
+	}
+	if (daemon->event_socket) {
+		unlink(daemon->event_path);
+	}
+	if (daemon->stats_fd >= 0) {
+		close(daemon->stats_fd);
+		daemon->stats_fd = -1;
+		unlink(daemon->stats_path);
+	}
+}
+
+/**
+* @brief Prints the event counts and the event-to-decision latency of the daemon
+* @param daemon: the daemon
+*/
+void print_daemon_summary(const Daemon_t* daemon) {
+	printf("DAEMON: EVENTS APPLIED %ld, REJECTED %ld, MALFORMED LINES %ld, BATCHES %ld, PRODUCERS %ld, STATS REQUESTS %ld\n",
+		   daemon->events_applied, daemon->events_rejected, daemon->lines_malformed, daemon->batches,
+		   daemon->producers, daemon->stats_requests);
+	if (daemon->events_applied > 0) {
+		printf("EVENT-TO-DECISION LATENCY: MEAN %.1f ns, P99 < %ld ns, MAX %ld ns\n",
+			   (double)daemon->total_latency / daemon->events_applied, get_latency_percentile(daemon, 0.99),
+			   daemon->max_latency);
+	}
+}
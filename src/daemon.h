@@ -0,0 +1,94 @@
+/**
+ * @file daemon.h
+ * @brief Declares the daemon mode of the simulator. Events arrive on a named pipe or a UNIX
+ *		  stream socket and are applied as soon as they are read, while a second socket
+ *		  answers statistics requests. Memory stays bounded however long the daemon runs
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+
+// Bytes read from the event source at a time, a line never spans more than this
+#define DAEMON_BUFFER_SIZE 65536
+// Events submitted to the simulator at a time
+#define DAEMON_BATCH_SIZE 1024
+// Latency buckets, bucket i counts events applied less than 2^i nanoseconds after they were read
+#define DAEMON_LATENCY_BUCKETS 40
+
+/**
+* @struct Daemon_t
+* @brief Defines the event source, the statistics socket and the counters of a daemon
+*/
+typedef struct daemon {
+	const char* event_path;
+	const char* stats_path;		// NULL without a statistics socket
+	bool event_socket;			// A socket path rather than a named pipe
+	int listen_fd;				// Event socket listener, -1 for a named pipe
+	int event_fd;				// The named pipe or the connected producer, -1 between producers
+	int stats_fd;				// Statistics socket listener, -1 without one
+
+	char buffer[DAEMON_BUFFER_SIZE];
+	int buffered;				// Bytes of an incomplete line carried over to the next read
+	bool has_last_time;
+	Procsim_Time last_time;		// Time of the last event applied, later events must not go back
+
+	long events_applied;
+	long events_rejected;
+	long lines_malformed;
+	long batches;
+	long producers;
+	long stats_requests;
+
+	long latency_buckets[DAEMON_LATENCY_BUCKETS];
+	long total_latency;
+	long max_latency;
+} Daemon_t;
+
+/**
+* @brief Opens the event source and the statistics socket. An existing named pipe is read
+* directly, any other path becomes a UNIX stream socket that accepts one producer at a time
+* @param daemon: the daemon to open
+* @param event_path: the named pipe or socket path events arrive on
+* @param stats_path: the socket path statistics are served on, NULL for none
+* @return true on success, false if a path could not be opened
+*/
+bool open_daemon(Daemon_t* daemon, const char* event_path, const char* stats_path);
+
+/**
+* @brief Waits for the first line of the event stream, which holds the simulation parameters
+* @param daemon: the daemon
+* @param policy: filled in with the scheduling policy, FIFO for an unknown value
+* @return true once the line was read, false if the daemon was stopped first or the line is malformed
+*/
+bool read_daemon_header(Daemon_t* daemon, Scheduling_Policy* policy);
+
+/**
+* @brief Applies events as they arrive and answers statistics requests until SIGINT or SIGTERM
+* @param daemon: the daemon
+* @param simulator: the simulator the events go to
+*/
+void run_daemon(Daemon_t* daemon, Procsim_t* simulator);
+
+/**
+* @brief Closes the event source and the statistics socket and removes the socket files
+* @param daemon: the daemon to close
+*/
+void close_daemon(Daemon_t* daemon);
+
+/**
+* @brief Prints the event counts and the event-to-decision latency of the daemon
+* @param daemon: the daemon
+*/
+void print_daemon_summary(const Daemon_t* daemon);
+
+#endif //DAEMON_H
@@ -0,0 +1,63 @@
+/**
+ * @file debug_dump.c
+ * @brief Defines the debugging printers of the simulator's internal structures
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "debug_dump.h"
+// Library imports
+#include <stdio.h>
+
+/**
+* @brief For debugging purposes, prints the contents of the queue
+* @param queue: contents to print
+*/
+void dump_queue(const Queue_t* queue) {
+	PCB_t* temp = queue->head;
+	int i = 0;
+	while (temp != NULL) {
+		printf("Node #%d: ID %lld, ", i++, temp->PID);
+		temp = temp->next;
+	}
+}
+
+/**
+* @brief For debugging purposes, prints the contents of the queue
+* @param queue: contents to print
+*/
+void dump_priority_queue(PriorityQueue_t* queue) {
+	PCB_t* temp = queue->head;
+	int i = 0;
+	while (temp != NULL) {
+		printf("Node #%d: ID: %lld, Priority %d | ", i++, temp->PID, temp->priority);
+		temp = temp->next;
+	}
+}
+
+/**
+* @brief For debugging purposes, prints the contents of the heap in storage order
+* @param heap: contents to print
+*/
+void dump_request_heap(const RequestHeap_t* heap) {
+	for (int i = 0; i < heap->size; i++) {
+		printf("Entry #%d: ID %lld, Key %ld | ", i, heap->entries[i].data->PID, heap->entries[i].key);
+	}
+}
+
+/**
+* @brief For debugging purposes, prints the contents of the IO devices queue
+* @param io_device: contents to print
+*/
+void dump_io_device(IO_Device_t* io_device) {
+	for (int i = 0; i < io_device->in_flight_count; i++) {
+		printf("Channel #%d: ID %lld, ", i, io_device->in_flight[i]->PID);
+	}
+	dump_queue(&io_device->queue);
+	dump_request_heap(&io_device->upper_heap);
+	dump_request_heap(&io_device->lower_heap);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file debug_dump.h
+ * @brief Declares the debugging printers of the simulator's internal structures. They are
+ *		  kept out of libprocsim, which does no I/O
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef DEBUG_DUMP_H
+#define DEBUG_DUMP_H
+
+// Header imports
+#include "queue.h"
+#include "priority_queue.h"
+#include "request_heap.h"
+#include "io_device.h"
+
+/**
+* @brief For debugging purposes, prints the contents of the queue
+* @param queue: contents to print
+*/
+void dump_queue(const Queue_t* queue);
+
+/**
+* @brief For debugging purposes, prints the contents of the queue
+* @param queue: contents to print
+*/
+void dump_priority_queue(PriorityQueue_t* queue);
+
+/**
+* @brief For debugging purposes, prints the contents of the heap in storage order
+* @param heap: contents to print
+*/
+void dump_request_heap(const RequestHeap_t* heap);
+
+/**
+* @brief For debugging purposes, prints the contents of the IO devices queue
+* @param io_device: contents to print
+*/
+void dump_io_device(IO_Device_t* io_device);
+
+#endif //DEBUG_DUMP_H
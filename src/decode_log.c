@@ -0,0 +1,119 @@
+/**
+ * @file decode_log.c
+ * @brief Program entry point.  Decodes a binary log written by --binary-log into the
+ *        simulator's event lines, into CSV or into a Chrome Trace Event timeline
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "log_sink.h"
+#include "chrome_trace.h"
+// Library imports
+#include <stdio.h>
+#include <string.h>
+
+// Records read per fread call
+#define DECODE_BATCH 4096
+
+/**
+ * @brief Prints the command line usage of the decoder
+ */
+static void print_usage(void) {
+    printf("Usage: decode_log [--csv | --chrome-trace file] log_file\n");
+    printf("  --csv                print one comma separated row per record instead of the event lines\n");
+    printf("  --chrome-trace file  write a Chrome Trace Event timeline instead of the event lines\n");
+}
+
+/**
+ * @brief Program entry procedure for the binary log decoder
+ */
+int main(int argc, char* argv[]) {
+    bool csv = false;
+    const char* chrome_trace_path = NULL;
+    const char* log_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--chrome-trace") == 0 && i + 1 < argc) {
+            chrome_trace_path = argv[++i];
+        } else if (log_path == NULL && argv[i][0] != '-') {
+            log_path = argv[i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (log_path == NULL) {
+        print_usage();
+        return 1;
+    }
+
+    FILE* input = fopen(log_path, "rb");
+    if (input == NULL) {
+        fprintf(stderr, "ERROR: Could not open %s\n", log_path);
+        return 1;
+    }
+
+    LogFileHeader_t header;
+    if (fread(&header, sizeof(header), 1, input) != 1 || header.magic != LOG_FILE_MAGIC) {
+        fprintf(stderr, "ERROR: %s is not a binary log\n", log_path);
+        fclose(input);
+        return 1;
+    }
+    if (header.version != LOG_FILE_VERSION || header.record_size != (int)sizeof(LogRecord_t)) {
+        fprintf(stderr, "ERROR: %s is a version %d binary log, this decoder reads version %d\n", log_path,
+                header.version, LOG_FILE_VERSION);
+        fclose(input);
+        return 1;
+    }
+
+    ChromeTrace_t chrome_trace;
+    if (chrome_trace_path != NULL && !open_chrome_trace(&chrome_trace, chrome_trace_path)) {
+        fprintf(stderr, "ERROR: Could not open %s\n", chrome_trace_path);
+        fclose(input);
+        return 1;
+    }
+    if (csv) {
+        printf("time,kind,pid,priority,device,queue_length\n");
+    }
+
+    // Decode the records a batch at a time
+    static LogRecord_t records[DECODE_BATCH];
+    char line[LOG_MAX_LINE_LENGTH];
+    size_t count;
+    Procsim_Time last_time = 0;
+    while ((count = fread(records, sizeof(LogRecord_t), DECODE_BATCH, input)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const LogRecord_t* record = &records[i];
+            last_time = record->time;
+            if (chrome_trace_path != NULL) {
+                add_chrome_trace_record(&chrome_trace, record);
+            } else if (csv) {
+                printf("%lld,%s,%lld,%d,%d,%d\n", record->time, get_log_kind_name(record->kind), record->PID,
+                       record->priority, record->device, record->queue_length);
+            } else {
+                fwrite(line, 1, (size_t)format_log_record(record, line), stdout);
+            }
+        }
+    }
+
+    bool failed = ferror(input);
+    if (failed) {
+        fprintf(stderr, "ERROR: Could not read %s\n", log_path);
+    }
+    fclose(input);
+    if (chrome_trace_path != NULL && !close_chrome_trace(&chrome_trace, last_time)) {
+        fprintf(stderr, "ERROR: Could not write %s\n", chrome_trace_path);
+        failed = true;
+    }
+
+    if (failed) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file event.c
+ * @brief Defines the functions used to read events out of an input file
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "event.h"
+
+/**
+* @brief Decodes one line of events. Optional values default to 0 when the line does not carry them
+* @param line: the line
+* @param event: the event to fill in
+* @return true if the line holds an event, false for a blank or malformed line
+*/
+bool parse_event(const char* line, Event_t* event) {
+	Event_t parsed = {0, 0, 0, 0};
+
+	int fields = sscanf(line, "%lld %d %d %lld", &parsed.time, &parsed.operation_code,
+						&parsed.argument, &parsed.extra);
+	if (fields < 2) {
+		return false;
+	}
+	*event = parsed;
+	return true;
+}
+
+/**
+* @brief Reads the next event out of the input file. Each event sits on its own line,
+* blank lines are skipped
+* @param input: the input file, positioned after the simulation parameters
+* @param event: the event to fill in
+* @return true if an event was read, false at the end of the file
+*/
+bool read_event(FILE* input, Event_t* event) {
+	char line[128];
+
+	while (fgets(line, sizeof(line), input) != NULL) {
+		if (parse_event(line, event)) {
+			return true;
+		}
+	}
+
+	return false;
+}
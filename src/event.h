@@ -0,0 +1,37 @@
+/**
+ * @file event.h
+ * @brief Declares the functions used to read simulation events out of an input file
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef EVENT_H
+#define EVENT_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+* @brief Decodes one line of events. Optional values default to 0 when the line does not carry them
+* @param line: the line
+* @param event: the event to fill in
+* @return true if the line holds an event, false for a blank or malformed line
+*/
+bool parse_event(const char* line, Event_t* event);
+
+/**
+* @brief Reads the next event out of the input file. Each event sits on its own line,
+* blank lines are skipped
+* @param input: the input file, positioned after the simulation parameters
+* @param event: the event to fill in
+* @return true if an event was read, false at the end of the file
+*/
+bool read_event(FILE* input, Event_t* event);
+
+#endif //EVENT_H
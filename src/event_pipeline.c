@@ -0,0 +1,245 @@
+/**
+ * @file event_pipeline.c
+ * @brief Defines the event pipeline that overlaps parsing the input file with the simulation
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "event_pipeline.h"
+// Library imports
+#include <stdlib.h>
+#include <sched.h>
+
+#define EVENT_RING_MASK (EVENT_RING_CAPACITY - 1)
+
+/**
+* @brief Makes every written record visible to the consumer
+*/
+static void publish_records(EventPipeline_t* pipeline) {
+	atomic_store_explicit(&pipeline->tail, pipeline->producer_tail, memory_order_release);
+}
+
+/**
+* @brief Hands every read record back to the producer
+*/
+static void release_records(EventPipeline_t* pipeline) {
+	atomic_store_explicit(&pipeline->head, pipeline->consumer_head, memory_order_release);
+}
+
+/**
+* @brief Waits until the ring has room for one more record. Pending records are published
+* first, so the consumer can always drain the ring
+* @return true once there is room, false if the consumer cancelled the pipeline
+*/
+static bool wait_for_space(EventPipeline_t* pipeline) {
+	if (pipeline->producer_tail - pipeline->producer_cached_head < EVENT_RING_CAPACITY) {
+		return true;
+	}
+	pipeline->producer_cached_head = atomic_load_explicit(&pipeline->head, memory_order_acquire);
+	if (pipeline->producer_tail - pipeline->producer_cached_head < EVENT_RING_CAPACITY) {
+		return true;
+	}
+
+	publish_records(pipeline);
+	pipeline->producer_stalls++;
+	while (pipeline->producer_tail - pipeline->producer_cached_head >= EVENT_RING_CAPACITY) {
+		if (atomic_load_explicit(&pipeline->cancelled, memory_order_relaxed)) {
+			return false;
+		}
+		sched_yield();
+		pipeline->producer_cached_head = atomic_load_explicit(&pipeline->head, memory_order_acquire);
+	}
+	return true;
+}
+
+/**
+* @brief Waits until the producer has published a record the consumer has not read yet.
+* Read records are released first, so the producer can always refill the ring
+* @return true once a record is available, false at the end of the input
+*/
+static bool wait_for_records(EventPipeline_t* pipeline) {
+	pipeline->consumer_cached_tail = atomic_load_explicit(&pipeline->tail, memory_order_acquire);
+	if (pipeline->consumer_head != pipeline->consumer_cached_tail) {
+		return true;
+	}
+
+	release_records(pipeline);
+	bool stalled = false;
+	while (true) {
+		// The producer publishes its last records before it sets finished
+		bool finished = atomic_load_explicit(&pipeline->finished, memory_order_acquire);
+		pipeline->consumer_cached_tail = atomic_load_explicit(&pipeline->tail, memory_order_acquire);
+		if (pipeline->consumer_head != pipeline->consumer_cached_tail) {
+			return true;
+		}
+		if (finished) {
+			return false;
+		}
+		if (!stalled) {
+			pipeline->consumer_stalls++;
+			stalled = true;
+		}
+		sched_yield();
+	}
+}
+
+/**
+* @brief Reads the next event out of the input file, or out of the decompressed input, and
+* moves the offset past it
+* @return true if an event was read, false at the end of the input
+*/
+static bool read_input_event(EventPipeline_t* pipeline, Event_t* event) {
+	if (pipeline->compressed_input != NULL) {
+		return read_compressed_event(pipeline->compressed_input, event);
+	}
+	if (!read_event(pipeline->input, event)) {
+		return false;
+	}
+	pipeline->offset = ftell(pipeline->input);
+	return true;
+}
+
+/**
+* @brief Body of the parser thread. Decodes events into the ring, publishing them a batch
+* at a time
+* @param argument: the pipeline
+*/
+static void* run_parser(void* argument) {
+	EventPipeline_t* pipeline = (EventPipeline_t*)argument;
+	unsigned long published = 0;
+	Event_t event;
+
+	while ((pipeline->stop_offset < 0 || pipeline->offset < pipeline->stop_offset)
+		   && read_input_event(pipeline, &event)) {
+		if (!wait_for_space(pipeline)) {
+			break;
+		}
+
+		EventRecord_t* record = &pipeline->records[pipeline->producer_tail & EVENT_RING_MASK];
+		record->event = event;
+		record->next_offset = pipeline->offset;
+		pipeline->producer_tail++;
+		pipeline->records_parsed++;
+
+		if (pipeline->producer_tail - published >= (unsigned long)pipeline->batch_size) {
+			publish_records(pipeline);
+			published = pipeline->producer_tail;
+		}
+	}
+
+	publish_records(pipeline);
+	atomic_store_explicit(&pipeline->finished, true, memory_order_release);
+	return NULL;
+}
+
+/**
+* @brief Starts reading events. With threading enabled a parser thread takes over the input
+* file until the pipeline is stopped
+* @param pipeline: the pipeline to start
+* @param input: the input file, positioned at the first event to read
+* @param compressed_input: the decompressed input to read instead of input, NULL for a plain
+* file. Its offsets are not tracked
+* @param stop_offset: offset at which reading stops, -1 to read to the end of the file
+* @param threaded: whether to parse on a separate thread
+* @param batch_size: records published or released at a time, at most half the ring
+*/
+void start_event_pipeline(EventPipeline_t* pipeline, FILE* input, CompressedInput_t* compressed_input, long stop_offset,
+						  bool threaded, int batch_size) {
+	pipeline->input = input;
+	pipeline->compressed_input = compressed_input;
+	pipeline->offset = compressed_input != NULL ? 0 : ftell(input);
+	pipeline->stop_offset = stop_offset;
+	pipeline->threaded = threaded;
+	pipeline->batch_size = batch_size;
+	pipeline->records = NULL;
+
+	atomic_init(&pipeline->tail, 0);
+	pipeline->producer_tail = 0;
+	pipeline->producer_cached_head = 0;
+	pipeline->producer_stalls = 0;
+	pipeline->records_parsed = 0;
+
+	atomic_init(&pipeline->head, 0);
+	pipeline->consumer_head = 0;
+	pipeline->consumer_cached_tail = 0;
+	pipeline->consumer_stalls = 0;
+
+	atomic_init(&pipeline->finished, false);
+	atomic_init(&pipeline->cancelled, false);
+
+	if (!threaded) {
+		return;
+	}
+
+	pipeline->records = (EventRecord_t*)malloc(EVENT_RING_CAPACITY * sizeof(EventRecord_t));
+	if (!pipeline->records) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	if (pthread_create(&pipeline->parser, NULL, run_parser, pipeline) != 0) {
+		fprintf(stderr, "ERROR: Could not start the parser thread!\n");
+		exit(1);
+	}
+}
+
+/**
+* @brief Takes the next event out of the pipeline
+* @param pipeline: the pipeline
+* @param event: filled in with the event
+* @param next_offset: filled in with the offset of the event after it
+* @return true if an event was read, false at the end of the input
+*/
+bool next_pipeline_event(EventPipeline_t* pipeline, Event_t* event, long* next_offset) {
+	if (!pipeline->threaded) {
+		if ((pipeline->stop_offset >= 0 && pipeline->offset >= pipeline->stop_offset)
+			|| !read_input_event(pipeline, event)) {
+			return false;
+		}
+		*next_offset = pipeline->offset;
+		return true;
+	}
+
+	if (pipeline->consumer_head == pipeline->consumer_cached_tail && !wait_for_records(pipeline)) {
+		return false;
+	}
+
+	const EventRecord_t* record = &pipeline->records[pipeline->consumer_head & EVENT_RING_MASK];
+	*event = record->event;
+	*next_offset = record->next_offset;
+	pipeline->consumer_head++;
+
+	unsigned long released = atomic_load_explicit(&pipeline->head, memory_order_relaxed);
+	if (pipeline->consumer_head - released >= (unsigned long)pipeline->batch_size) {
+		release_records(pipeline);
+	}
+	return true;
+}
+
+/**
+* @brief Stops the parser thread, even if it has not reached the end of the input, and
+* clears the ring from memory
+* @param pipeline: the pipeline to stop
+*/
+void stop_event_pipeline(EventPipeline_t* pipeline) {
+	if (!pipeline->threaded) {
+		return;
+	}
+
+	atomic_store_explicit(&pipeline->cancelled, true, memory_order_relaxed);
+	pthread_join(pipeline->parser, NULL);
+	free(pipeline->records);
+	pipeline->records = NULL;
+}
+
+/**
+* @brief Prints the batch size, record count and stall counters of a threaded pipeline
+* @param pipeline: the stopped pipeline
+*/
+void print_pipeline_summary(const EventPipeline_t* pipeline) {
+	printf("PIPELINE: BATCH SIZE %d, RECORDS %ld, PARSER STALLS %ld, SIMULATION STALLS %ld\n",
+		pipeline->batch_size, pipeline->records_parsed, pipeline->producer_stalls, pipeline->consumer_stalls);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file event_pipeline.h
+ * @brief Declares the event pipeline. A parser thread decodes events out of the input file
+ *		  and hands them to the simulation loop through a lock-free single producer, single
+ *		  consumer ring buffer
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef EVENT_PIPELINE_H
+#define EVENT_PIPELINE_H
+
+// Header imports
+#include "event.h"
+#include "compressed_input.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define CACHE_LINE_SIZE 64
+
+// Number of records in the ring, a power of two
+#define EVENT_RING_CAPACITY 4096
+
+#define DEFAULT_PIPELINE_BATCH_SIZE 64
+
+/**
+* @struct EventRecord_t
+* @brief Defines a decoded event together with the offset of the event after it
+*/
+typedef struct event_record {
+	Event_t event;
+	long next_offset;	// Byte offset of the following event, used by checkpoints
+} EventRecord_t;
+
+/**
+* @struct EventPipeline_t
+* @brief Defines the ring shared by the parser thread and the simulation loop. Each side
+* publishes its index once per batch, and the two sides keep their fields on separate
+* cache lines so they never write to the same line
+*/
+typedef struct event_pipeline {
+	FILE* input;
+	CompressedInput_t* compressed_input;	// Read instead of input when not NULL
+	long stop_offset;		// Reading stops at this offset, -1 to read to the end of the file
+	bool threaded;			// False reads events directly on the simulation thread
+	int batch_size;
+	EventRecord_t* records;
+	pthread_t parser;
+
+	// Producer (parser thread) side. Without threading the simulation thread is the producer
+	_Alignas(CACHE_LINE_SIZE) atomic_ulong tail;	// Records published to the consumer
+	long offset;									// Offset of the next unread event
+	unsigned long producer_tail;					// Records written, published or not
+	unsigned long producer_cached_head;
+	long producer_stalls;							// Times the ring was full
+	long records_parsed;
+
+	// Consumer (simulation loop) side
+	_Alignas(CACHE_LINE_SIZE) atomic_ulong head;	// Records released back to the producer
+	unsigned long consumer_head;					// Records read, released or not
+	unsigned long consumer_cached_tail;
+	long consumer_stalls;							// Times the ring was empty
+
+	// Shutdown flags
+	_Alignas(CACHE_LINE_SIZE) atomic_bool finished;	// Set by the producer at the end of input
+	atomic_bool cancelled;							// Set by the consumer to stop the producer
+} EventPipeline_t;
+
+/**
+* @brief Starts reading events. With threading enabled a parser thread takes over the input
+* file until the pipeline is stopped
+* @param pipeline: the pipeline to start
+* @param input: the input file, positioned at the first event to read
+* @param compressed_input: the decompressed input to read instead of input, NULL for a plain
+* file. Its offsets are not tracked
+* @param stop_offset: offset at which reading stops, -1 to read to the end of the file
+* @param threaded: whether to parse on a separate thread
+* @param batch_size: records published or released at a time, at most half the ring
+*/
+void start_event_pipeline(EventPipeline_t* pipeline, FILE* input, CompressedInput_t* compressed_input, long stop_offset,
+						  bool threaded, int batch_size);
+
+/**
+* @brief Takes the next event out of the pipeline
+* @param pipeline: the pipeline
+* @param event: filled in with the event
+* @param next_offset: filled in with the offset of the event after it
+* @return true if an event was read, false at the end of the input
+*/
+bool next_pipeline_event(EventPipeline_t* pipeline, Event_t* event, long* next_offset);
+
+/**
+* @brief Stops the parser thread, even if it has not reached the end of the input, and
+* clears the ring from memory
+* @param pipeline: the pipeline to stop
+*/
+void stop_event_pipeline(EventPipeline_t* pipeline);
+
+/**
+* @brief Prints the batch size, record count and stall counters of a threaded pipeline
+* @param pipeline: the stopped pipeline
+*/
+void print_pipeline_summary(const EventPipeline_t* pipeline);
+
+#endif //EVENT_PIPELINE_H
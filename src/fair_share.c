@@ -0,0 +1,276 @@
+/**
+ * @file fair_share.c
+ * @brief Defines the two level ready queue of the fair-share policy. Picking a group and
+ *		  updating its virtual time are O(log groups), picking inside a group is O(1)
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "fair_share.h"
+#include "instrumentation.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+
+/**
+* @brief Checks if group a should get the CPU before group b
+*/
+static bool group_before(const FairShareQueue_t* queue, int a, int b) {
+	const FairShareGroup_t* first = &queue->groups[a];
+	const FairShareGroup_t* second = &queue->groups[b];
+	if (first->virtual_time != second->virtual_time) {
+		return first->virtual_time < second->virtual_time;
+	}
+	return first->sequence < second->sequence;
+}
+
+/**
+* @brief Places a group at a heap position and records the position in the group
+*/
+static void place_group(FairShareQueue_t* queue, int position, int group) {
+	queue->heap[position] = group;
+	queue->groups[group].position = position;
+}
+
+/**
+* @brief Moves a group towards the root until its parent comes first
+*/
+static void sift_group_up(FairShareQueue_t* queue, int position) {
+	int group = queue->heap[position];
+	while (position > 0) {
+		int parent = (position - 1) / 2;
+		if (!group_before(queue, group, queue->heap[parent])) {
+			break;
+		}
+		place_group(queue, position, queue->heap[parent]);
+		position = parent;
+	}
+	place_group(queue, position, group);
+}
+
+/**
+* @brief Moves a group towards the leaves until both children come after it
+*/
+static void sift_group_down(FairShareQueue_t* queue, int position) {
+	int group = queue->heap[position];
+	while (true) {
+		int child = 2 * position + 1;
+		if (child >= queue->heap_size) {
+			break;
+		}
+		if (child + 1 < queue->heap_size && group_before(queue, queue->heap[child + 1], queue->heap[child])) {
+			child++;
+		}
+		if (!group_before(queue, queue->heap[child], group)) {
+			break;
+		}
+		place_group(queue, position, queue->heap[child]);
+		position = child;
+	}
+	place_group(queue, position, group);
+}
+
+/**
+* @brief Grows the group table and the heap so that a group id has an entry
+*/
+static void reserve_group(FairShareQueue_t* queue, int group) {
+	if (group < queue->group_capacity) {
+		return;
+	}
+
+	int new_capacity = queue->group_capacity == 0 ? 8 : queue->group_capacity;
+	while (new_capacity <= group) {
+		new_capacity *= 2;
+	}
+	INSTRUMENT_MEMORY_ALLOCATION();
+	FairShareGroup_t* groups = (FairShareGroup_t*)realloc(queue->groups, new_capacity * sizeof(FairShareGroup_t));
+	int* heap = (int*)realloc(queue->heap, new_capacity * sizeof(int));
+	if (!groups || !heap) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	for (int i = queue->group_capacity; i < new_capacity; i++) {
+		initialize_priority_queue(&groups[i].waiting);
+		groups[i].virtual_time = 0;
+		groups[i].sequence = 0;
+		groups[i].position = -1;
+	}
+	queue->groups = groups;
+	queue->heap = heap;
+	queue->group_capacity = new_capacity;
+}
+
+/**
+* @brief Initializes the queue to empty
+* @param queue: the queue to initialize
+*/
+void initialize_fair_share_queue(FairShareQueue_t* queue) {
+	queue->groups = NULL;
+	queue->group_capacity = 0;
+	queue->heap = NULL;
+	queue->heap_size = 0;
+	queue->size = 0;
+	queue->virtual_clock = 0;
+	queue->next_sequence = 0;
+}
+
+/**
+* @brief Adds a process to the queue of its group. A group that had nobody waiting joins the
+* heap, no further behind than the virtual clock so that it cannot claim the CPU time it missed
+* @param queue: the queue
+* @param data: the process
+*/
+void enqueue_fair_share_queue(FairShareQueue_t* queue, PCB_t* data) {
+	reserve_group(queue, data->group);
+	FairShareGroup_t* group = &queue->groups[data->group];
+	enqueue_priority_queue(&group->waiting, data);
+	queue->size++;
+	if (group->position >= 0) {
+		return;
+	}
+
+	if (group->virtual_time < queue->virtual_clock) {
+		group->virtual_time = queue->virtual_clock;
+	}
+	group->sequence = queue->next_sequence++;
+	queue->heap[queue->heap_size] = data->group;
+	sift_group_up(queue, queue->heap_size++);
+}
+
+/**
+* @brief Removes the highest priority process of the group with the smallest virtual time
+* @param queue: the queue, not empty
+* @return the process
+*/
+PCB_t* dequeue_fair_share_queue(FairShareQueue_t* queue) {
+	if (queue->heap_size == 0) {
+		// Queue is empty, throw an error
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Queue is already empty!");
+	}
+
+	int top = queue->heap[0];
+	FairShareGroup_t* group = &queue->groups[top];
+	if (group->virtual_time > queue->virtual_clock) {
+		queue->virtual_clock = group->virtual_time;
+	}
+	PCB_t* data = dequeue_priority_queue(&group->waiting);
+	queue->size--;
+
+	// A group leaves the heap once nobody of it waits
+	if (is_empty_priority_queue(&group->waiting)) {
+		group->position = -1;
+		if (--queue->heap_size > 0) {
+			place_group(queue, 0, queue->heap[queue->heap_size]);
+			sift_group_down(queue, 0);
+		}
+	}
+	return data;
+}
+
+/**
+* @brief Accounts for a process of a group that goes to an idle CPU without waiting in the
+* queue, as if it had been added and picked straight away
+* @param queue: the queue
+* @param group: the group of the process
+*/
+void dispatch_fair_share_group(FairShareQueue_t* queue, int group) {
+	reserve_group(queue, group);
+	FairShareGroup_t* fair_share_group = &queue->groups[group];
+	if (fair_share_group->position >= 0) {
+		return;
+	}
+
+	if (fair_share_group->virtual_time < queue->virtual_clock) {
+		fair_share_group->virtual_time = queue->virtual_clock;
+	}
+	queue->virtual_clock = fair_share_group->virtual_time;
+}
+
+/**
+* @brief Advances the virtual time of a group by the CPU time one of its processes used
+* @param queue: the queue
+* @param group: the group
+* @param cpu_time: CPU time used
+* @param weight: weight of the group, at least 1
+*/
+void charge_fair_share_queue(FairShareQueue_t* queue, int group, Procsim_Time cpu_time, int weight) {
+	reserve_group(queue, group);
+	queue->groups[group].virtual_time += cpu_time * FAIR_SHARE_SCALE / weight;
+
+	// Virtual time only grows, so a waiting group can only move down the heap
+	if (queue->groups[group].position >= 0) {
+		sift_group_down(queue, queue->groups[group].position);
+	}
+}
+
+/**
+* @brief Makes an independent copy of a queue whose processes live in a cloned PCB store
+* @param clone: the queue to fill in, not initialized
+* @param queue: the queue to copy
+* @param pcb_store: the cloned store
+*/
+void clone_fair_share_queue(FairShareQueue_t* clone, const FairShareQueue_t* queue, const PCB_Store_t* pcb_store) {
+	*clone = *queue;
+	if (queue->group_capacity == 0) {
+		return;
+	}
+
+	INSTRUMENT_MEMORY_ALLOCATION();
+	clone->groups = (FairShareGroup_t*)malloc(queue->group_capacity * sizeof(FairShareGroup_t));
+	clone->heap = (int*)malloc(queue->group_capacity * sizeof(int));
+	if (!clone->groups || !clone->heap) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	memcpy(clone->heap, queue->heap, queue->heap_size * sizeof(int));
+	for (int i = 0; i < queue->group_capacity; i++) {
+		clone->groups[i] = queue->groups[i];
+		clone->groups[i].waiting.head = get_cloned_pcb(pcb_store, queue->groups[i].waiting.head);
+		clone->groups[i].waiting.tail = get_cloned_pcb(pcb_store, queue->groups[i].waiting.tail);
+	}
+}
+
+/**
+* @brief Finds how far a group is ahead of the virtual clock
+*/
+static Procsim_Time get_group_lead(const FairShareQueue_t* queue, int group) {
+	if (group >= queue->group_capacity || queue->groups[group].virtual_time <= queue->virtual_clock) {
+		return 0;
+	}
+	return queue->groups[group].virtual_time - queue->virtual_clock;
+}
+
+/**
+* @brief Checks whether two empty queues would order any processes added from now on the same
+* way. A group rejoins the queue or takes an idle CPU no further behind than the virtual clock, so
+* only how far each group is ahead of its clock matters
+* @param queue: an empty queue
+* @param other: another empty queue
+* @return true if every group is as far ahead of the clock in both
+*/
+bool has_same_idle_fair_share_queue(const FairShareQueue_t* queue, const FairShareQueue_t* other) {
+	if (queue->size != 0 || other->size != 0) {
+		return false;
+	}
+
+	int group_capacity = queue->group_capacity > other->group_capacity ? queue->group_capacity : other->group_capacity;
+	for (int i = 0; i < group_capacity; i++) {
+		if (get_group_lead(queue, i) != get_group_lead(other, i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Clears the queue from memory. The PCB's are owned by the PCB store and are left alone
+* @param queue: the queue to clear
+*/
+void free_fair_share_queue(FairShareQueue_t* queue) {
+	free(queue->groups);
+	free(queue->heap);
+	initialize_fair_share_queue(queue);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file fair_share.h
+ * @brief Declares the two level ready queue of the fair-share policy. Each process group waits
+ *		  in its own priority queue, and a heap over the groups ordered by virtual time picks
+ *		  the group that has received the least CPU time for its weight
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef FAIR_SHARE_H
+#define FAIR_SHARE_H
+
+// Header imports
+#include "PCB.h"
+#include "priority_queue.h"
+#include "pcb_store.h"
+
+// Virtual time a group of weight 1 gains per unit of CPU time
+#define FAIR_SHARE_SCALE 1024
+
+/**
+* @struct FairShareGroup_t
+* @brief Defines the waiting processes and the virtual time of one group
+*/
+typedef struct fair_share_group {
+	PriorityQueue_t waiting;	// Highest priority first, arrival order between equals
+	Procsim_Time virtual_time;	// CPU time received, scaled down by the group weight
+	unsigned long sequence;		// Breaks virtual time ties in the order groups became ready
+	int position;				// Index in the group heap, -1 while no process of the group waits
+} FairShareGroup_t;
+
+/**
+* @struct FairShareQueue_t
+* @brief Defines the fair-share ready queue. Only groups with waiting processes are in the heap
+*/
+typedef struct fair_share_queue {
+	FairShareGroup_t* groups;	// Indexed by group id
+	int group_capacity;
+	int* heap;					// Group ids, smallest virtual time first
+	int heap_size;
+	int size;					// Waiting processes over every group
+	Procsim_Time virtual_clock;	// Virtual time of the last group picked, never decreases
+	unsigned long next_sequence;
+} FairShareQueue_t;
+
+/**
+* @brief Initializes the queue to empty
+* @param queue: the queue to initialize
+*/
+void initialize_fair_share_queue(FairShareQueue_t* queue);
+
+/**
+* @brief Adds a process to the queue of its group. A group that had nobody waiting joins the
+* heap, no further behind than the virtual clock so that it cannot claim the CPU time it missed
+* @param queue: the queue
+* @param data: the process
+*/
+void enqueue_fair_share_queue(FairShareQueue_t* queue, PCB_t* data);
+
+/**
+* @brief Removes the highest priority process of the group with the smallest virtual time
+* @param queue: the queue, not empty
+* @return the process
+*/
+PCB_t* dequeue_fair_share_queue(FairShareQueue_t* queue);
+
+/**
+* @brief Accounts for a process of a group that goes to an idle CPU without waiting in the
+* queue, as if it had been added and picked straight away
+* @param queue: the queue
+* @param group: the group of the process
+*/
+void dispatch_fair_share_group(FairShareQueue_t* queue, int group);
+
+/**
+* @brief Advances the virtual time of a group by the CPU time one of its processes used
+* @param queue: the queue
+* @param group: the group
+* @param cpu_time: CPU time used
+* @param weight: weight of the group, at least 1
+*/
+void charge_fair_share_queue(FairShareQueue_t* queue, int group, Procsim_Time cpu_time, int weight);
+
+/**
+* @brief Makes an independent copy of a queue whose processes live in a cloned PCB store
+* @param clone: the queue to fill in, not initialized
+* @param queue: the queue to copy
+* @param pcb_store: the cloned store
+*/
+void clone_fair_share_queue(FairShareQueue_t* clone, const FairShareQueue_t* queue, const PCB_Store_t* pcb_store);
+
+/**
+* @brief Checks whether two empty queues would order any processes added from now on the same
+* way. A group rejoins the queue or takes an idle CPU no further behind than the virtual clock, so
+* only how far each group is ahead of its clock matters
+* @param queue: an empty queue
+* @param other: another empty queue
+* @return true if every group is as far ahead of the clock in both
+*/
+bool has_same_idle_fair_share_queue(const FairShareQueue_t* queue, const FairShareQueue_t* other);
+
+/**
+* @brief Clears the queue from memory. The PCB's are owned by the PCB store and are left alone
+* @param queue: the queue to clear
+*/
+void free_fair_share_queue(FairShareQueue_t* queue);
+
+#endif //FAIR_SHARE_H
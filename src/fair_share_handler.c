@@ -0,0 +1,200 @@
+/**
+ * @file fair_share_handler.c
+ * @brief Defines the fair-share scheduler functions declared in Scheduler.h. The CPU goes to
+ *		  the group that received the least CPU time for its weight, and within that group to
+ *		  the highest priority process. The running process is never preempted
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "Scheduler.h"
+#include "fair_share.h"
+#include "io_device.h"
+#include "PCB.h"
+#include "pcb_store.h"
+
+/**
+* @brief Adds a process to the queue of its group
+*/
+static void make_ready(SchedulerHandler* schedulerHandler, PCB_t* process, Procsim_Time current_time) {
+	process->state = READY;
+	schedulerHandler->pcb_store->start_ready_time[process->slot] = current_time;
+	enqueue_fair_share_queue((FairShareQueue_t*)schedulerHandler->queue, process);
+	log_event(schedulerHandler, LOG_PROCESS_READY, current_time, process, NULL);
+}
+
+/**
+* @brief Gives the CPU to a process and starts timing its run
+*/
+static void run_process(SchedulerHandler* schedulerHandler, PCB_t* process, Procsim_Time current_time) {
+	process->state = RUNNING;
+	schedulerHandler->CPU = process;
+
+	// The run start time of the burst predictions doubles as the start of the group's CPU time
+	schedulerHandler->pcb_store->bursts.run_start_time[process->slot] = current_time;
+	log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, current_time, process, NULL);
+	charge_dispatch(schedulerHandler->pcb_store);
+}
+
+/**
+* @brief Charges the CPU time of the running process to its group as it leaves the CPU
+*/
+static void charge_group(SchedulerHandler* schedulerHandler, const PCB_t* process, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+	Procsim_Time cpu_time = current_time - store->bursts.run_start_time[process->slot];
+	store->groups.cpu_time[process->group] += cpu_time;
+	charge_fair_share_queue((FairShareQueue_t*)schedulerHandler->queue, process->group, cpu_time,
+							store->groups.weight[process->group]);
+}
+
+/**
+* @brief Sends the next process of the group furthest below its share to the CPU, or idles the
+* CPU if none is waiting
+*/
+static void dispatch_next_process(SchedulerHandler* schedulerHandler, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+	FairShareQueue_t* ready_queue = (FairShareQueue_t*)schedulerHandler->queue;
+
+	if (ready_queue->size > 0) {
+		PCB_t* new_process = dequeue_fair_share_queue(ready_queue);
+		run_process(schedulerHandler, new_process, current_time);
+
+		// Process analytics
+		store->total_ready_time[new_process->slot] += current_time - store->start_ready_time[new_process->slot];
+	} else {
+		// If there are no processes in the queue, the CPU goes idle
+		schedulerHandler->CPU = NULL;
+
+		// System analytics
+		schedulerHandler->start_idle_time = current_time;
+	}
+}
+
+/**
+* @brief Handles the event of starting of a process using fair-share scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time) {
+	// Create a new PCB for the new process
+	PCB_t* new_process = allocate_pcb(schedulerHandler->pcb_store);
+	new_process->priority = priority;
+	new_process->PID = *PID_tracker;
+	assign_process_group(schedulerHandler->pcb_store, new_process, group);
+
+	// Iterate the PID tracker so new processes get new ID's
+	(*PID_tracker)++;
+
+	log_event(schedulerHandler, LOG_PROCESS_STARTED, *current_time, new_process, NULL);
+	if (schedulerHandler->CPU == NULL) {
+		// No process is currently running in the CPU, assign new process to CPU
+		dispatch_fair_share_group((FairShareQueue_t*)schedulerHandler->queue, new_process->group);
+		run_process(schedulerHandler, new_process, *current_time);
+
+		// System analytics
+		schedulerHandler->end_idle_time = *current_time;
+		schedulerHandler->total_idle_time += schedulerHandler->end_idle_time - schedulerHandler->start_idle_time;
+	} else {
+		make_ready(schedulerHandler, new_process, *current_time);
+	}
+}
+
+/**
+* @brief Handles the event where an active process requests an I/O device using fair-share
+* scheduling. The CPU time of the process is charged to its group
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Send the current PCB to the desired I/O device
+	PCB_t* io_requested_process = schedulerHandler->CPU;
+	charge_group(schedulerHandler, io_requested_process, *current_time);
+	io_requested_process->state = BLOCKED;
+	io_requested_process->target_io_device = io_device->id;
+	io_requested_process->target_sector = sector;
+
+	// Process analytics
+	store->start_io_blocked_time[io_requested_process->slot] = *current_time;
+
+	add_io_request(io_device, io_requested_process, *current_time);
+	log_event(schedulerHandler, LOG_IO_WAITING, *current_time, io_requested_process, io_device);
+	charge_switch_out(store, io_requested_process, false);
+
+	dispatch_next_process(schedulerHandler, *current_time);
+}
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using fair-share scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Remove the processes from the I/O device. Submitted events always release one, but a
+	// completion with nothing to release leaves everything as it was
+	int request_count = get_io_request_count(io_device);
+	if (request_count == 0) {
+		return;
+	}
+	PCB_t* stack_processes[HANDLER_STACK_PROCESSES];
+	PCB_t** io_processes = get_process_buffer(stack_processes, request_count);
+	int io_device_queue_size = release_io_requests(io_device, PID, *current_time, io_processes);
+	if (io_device_queue_size == 0) {
+		release_process_buffer(io_processes, stack_processes);
+		return;
+	}
+
+	// Process analytics
+	for (int i = 0; i < io_device_queue_size; i++) {
+		store->total_io_blocked_time[io_processes[i]->slot] += *current_time - store->start_io_blocked_time[io_processes[i]->slot];
+		log_event(schedulerHandler, LOG_IO_RELEASED, *current_time, io_processes[i], io_device);
+	}
+	log_event(schedulerHandler, LOG_IO_COMPLETED, *current_time, NULL, io_device);
+	charge_io_interrupt(store);
+
+	// The released processes wait with their groups, an idle CPU takes the first group in line
+	for (int i = 0; i < io_device_queue_size; i++) {
+		make_ready(schedulerHandler, io_processes[i], *current_time);
+	}
+	release_process_buffer(io_processes, stack_processes);
+	if (schedulerHandler->CPU == NULL) {
+		dispatch_next_process(schedulerHandler, *current_time);
+
+		// System analytics
+		schedulerHandler->end_idle_time = *current_time;
+		schedulerHandler->total_idle_time += schedulerHandler->end_idle_time - schedulerHandler->start_idle_time;
+	}
+}
+
+/**
+* @brief Handles the event where an active process terminates using fair-share scheduling.
+* The CPU time of the process is charged to its group
+* @param schedulerHandler: A reference to the current scheduler
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void fair_share_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Retrieve the current process, charge its group and record it in the completed process analytics
+	PCB_t* ended_process = schedulerHandler->CPU;
+	charge_group(schedulerHandler, ended_process, *current_time);
+	log_event(schedulerHandler, LOG_PROCESS_ENDED, *current_time, ended_process, NULL);
+	charge_switch_out(store, ended_process, false);
+	complete_pcb(store, ended_process);
+
+	dispatch_next_process(schedulerHandler, *current_time);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file fatal_error.c
+ * @brief Defines how the library reports the errors it cannot recover from
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+
+static ProcsimFatalHandler fatal_handler = NULL;
+
+/**
+* @brief Sets the function receiving unrecoverable errors, shared by every simulator of the
+* process. Without one the process is aborted
+* @param handler: the function, NULL to restore the default
+*/
+void procsim_set_fatal_handler(ProcsimFatalHandler handler) {
+	fatal_handler = handler;
+}
+
+/**
+* @brief Hands an unrecoverable error to the installed handler and aborts if it returns
+* @param error: the error
+* @param message: a description of the error
+*/
+void report_fatal_error(Procsim_Fatal_Error error, const char* message) {
+	if (fatal_handler != NULL) {
+		fatal_handler(error, message);
+	}
+	abort();
+}
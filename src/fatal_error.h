@@ -0,0 +1,25 @@
+/**
+ * @file fatal_error.h
+ * @brief Declares how the library reports the errors it cannot recover from. The core does
+ *		  no I/O, so the error goes to the handler the caller installed
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef FATAL_ERROR_H
+#define FATAL_ERROR_H
+
+// Header imports
+#include "procsim.h"
+
+/**
+* @brief Hands an unrecoverable error to the installed handler and aborts if it returns
+* @param error: the error
+* @param message: a description of the error
+*/
+void report_fatal_error(Procsim_Fatal_Error error, const char* message) __attribute__((noreturn));
+
+#endif //FATAL_ERROR_H
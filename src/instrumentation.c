@@ -0,0 +1,144 @@
+/**
+ * @file instrumentation.c
+ * @brief Defines the optional self-instrumentation of the simulator. Empty unless
+ *		  PROCSIM_INSTRUMENT is defined
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "instrumentation.h"
+
+#ifdef PROCSIM_INSTRUMENT
+
+// Library imports
+#include <stdio.h>
+
+/**
+* @struct HandlerStats_t
+* @brief Defines the latency histogram and queue depth totals of one handler
+*/
+typedef struct handler_stats {
+	long calls;
+	long total_latency;
+	long min_latency;
+	long max_latency;
+	long buckets[INSTRUMENT_BUCKETS];
+	long total_ready_depth;
+	int max_ready_depth;
+} HandlerStats_t;
+
+static HandlerStats_t handler_stats[INSTRUMENT_HANDLER_COUNT];
+static long pcb_allocations;
+static long reused_pcb_slots;
+static long memory_allocations;
+
+static const char* handler_names[INSTRUMENT_HANDLER_COUNT] = {
+	"PROCESS START", "I/O REQUEST", "I/O COMPLETE", "PROCESS END"
+};
+
+/**
+* @brief Finds the histogram bucket of a latency
+*/
+static int get_latency_bucket(long latency) {
+	int bucket = 0;
+	while (bucket < INSTRUMENT_BUCKETS - 1 && latency >= (1L << bucket)) {
+		bucket++;
+	}
+	return bucket;
+}
+
+/**
+* @brief Finds the bucket holding a percentile of the calls
+* @return the upper bound of the bucket in nanoseconds
+*/
+static long get_latency_percentile(const HandlerStats_t* stats, double percentile) {
+	long rank = (long)(stats->calls * percentile);
+	long seen = 0;
+	for (int i = 0; i < INSTRUMENT_BUCKETS; i++) {
+		seen += stats->buckets[i];
+		if (seen > rank) {
+			return 1L << i;
+		}
+	}
+	return 1L << (INSTRUMENT_BUCKETS - 1);
+}
+
+/**
+* @brief Records one handler call
+* @param handler: the handler
+* @param start: instrument_now() before the call
+* @param ready_depth: ready queue length when the handler was called
+*/
+void record_handler_call(Instrumented_Handler handler, long start, int ready_depth) {
+	long latency = instrument_now() - start;
+	HandlerStats_t* stats = &handler_stats[handler];
+
+	if (stats->calls == 0 || latency < stats->min_latency) {
+		stats->min_latency = latency;
+	}
+	if (latency > stats->max_latency) {
+		stats->max_latency = latency;
+	}
+	stats->calls++;
+	stats->total_latency += latency;
+	stats->buckets[get_latency_bucket(latency)]++;
+
+	stats->total_ready_depth += ready_depth;
+	if (ready_depth > stats->max_ready_depth) {
+		stats->max_ready_depth = ready_depth;
+	}
+}
+
+/**
+* @brief Counts a PCB handed out by the PCB store
+* @param reused: whether a freed slot was reused
+*/
+void record_pcb_allocation(int reused) {
+	pcb_allocations++;
+	if (reused) {
+		reused_pcb_slots++;
+	}
+}
+
+/**
+* @brief Counts a heap allocation or reallocation
+*/
+void record_memory_allocation(void) {
+	memory_allocations++;
+}
+
+/**
+* @brief Prints the latency, queue depth and allocation summary
+*/
+void print_instrumentation_summary(void) {
+	printf("\nINSTRUMENTATION\n");
+	for (int i = 0; i < INSTRUMENT_HANDLER_COUNT; i++) {
+		const HandlerStats_t* stats = &handler_stats[i];
+		if (stats->calls == 0) {
+			printf("%s: CALLS 0\n", handler_names[i]);
+			continue;
+		}
+
+		printf("%s: CALLS %ld, MEAN LATENCY %.1f ns, MIN %ld ns, MAX %ld ns, P50 < %ld ns, P99 < %ld ns, "
+			   "MEAN READY DEPTH %.2f, MAX READY DEPTH %d\n", handler_names[i], stats->calls,
+			   (double)stats->total_latency / stats->calls, stats->min_latency, stats->max_latency,
+			   get_latency_percentile(stats, 0.50), get_latency_percentile(stats, 0.99),
+			   (double)stats->total_ready_depth / stats->calls, stats->max_ready_depth);
+
+		printf("  LATENCY HISTOGRAM:");
+		for (int j = 0; j < INSTRUMENT_BUCKETS; j++) {
+			if (stats->buckets[j] > 0) {
+				printf(" <%ld ns: %ld", 1L << j, stats->buckets[j]);
+			}
+		}
+		printf("\n");
+	}
+	printf("ALLOCATIONS: PCBS %ld, REUSED SLOTS %ld, HEAP ALLOCATIONS %ld\n",
+		   pcb_allocations, reused_pcb_slots, memory_allocations);
+}
+
+#endif //PROCSIM_INSTRUMENT
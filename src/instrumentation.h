@@ -0,0 +1,86 @@
+/**
+ * @file instrumentation.h
+ * @brief Declares the optional self-instrumentation of the simulator: per handler latency
+ *		  histograms, the ready queue depth at each handler call and allocation counts.
+ *		  Everything is compiled in only when PROCSIM_INSTRUMENT is defined (make
+ *		  INSTRUMENT=1), otherwise the macros expand to nothing
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/**
+* Defines the instrumented handlers, in op code order
+*/
+typedef enum instrumented_handler {
+	INSTRUMENT_PROCESS_START,
+	INSTRUMENT_IO_REQUEST,
+	INSTRUMENT_IO_COMPLETE,
+	INSTRUMENT_PROCESS_END,
+	INSTRUMENT_HANDLER_COUNT,
+} Instrumented_Handler;
+
+#ifdef PROCSIM_INSTRUMENT
+
+// Library imports
+#include <time.h>
+
+// Latency buckets, bucket i counts calls that took less than 2^i nanoseconds
+#define INSTRUMENT_BUCKETS 40
+
+/**
+* @brief Reads the monotonic clock
+* @return the time in nanoseconds
+*/
+static inline long instrument_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+* @brief Records one handler call
+* @param handler: the handler
+* @param start: instrument_now() before the call
+* @param ready_depth: ready queue length when the handler was called
+*/
+void record_handler_call(Instrumented_Handler handler, long start, int ready_depth);
+
+/**
+* @brief Counts a PCB handed out by the PCB store
+* @param reused: whether a freed slot was reused
+*/
+void record_pcb_allocation(int reused);
+
+/**
+* @brief Counts a heap allocation or reallocation
+*/
+void record_memory_allocation(void);
+
+/**
+* @brief Prints the latency, queue depth and allocation summary
+*/
+void print_instrumentation_summary(void);
+
+#define INSTRUMENT_BEGIN(ready_depth) int instrument_depth = (ready_depth); long instrument_start = instrument_now()
+#define INSTRUMENT_END(handler) record_handler_call((handler), instrument_start, instrument_depth)
+#define INSTRUMENT_PCB_ALLOCATION(reused) record_pcb_allocation(reused)
+#define INSTRUMENT_MEMORY_ALLOCATION() record_memory_allocation()
+#define INSTRUMENT_REPORT() print_instrumentation_summary()
+
+#else
+
+#define INSTRUMENT_BEGIN(ready_depth) ((void)0)
+#define INSTRUMENT_END(handler) ((void)0)
+#define INSTRUMENT_PCB_ALLOCATION(reused) ((void)0)
+#define INSTRUMENT_MEMORY_ALLOCATION() ((void)0)
+#define INSTRUMENT_REPORT() ((void)0)
+
+#endif //PROCSIM_INSTRUMENT
+
+#endif //INSTRUMENTATION_H
@@ -1,7 +1,7 @@
 /**
  * @file io_device.c
  * @brief defines the attributes and functions of a standard I/O device.
- * This includes the current PCB using the I/O device and a queue for the next PCB's
+ * This includes the PCB's using the I/O device channels and the structures holding the next PCB's
  *
  * Course: CSC3210
  * Section: 003
@@ -11,47 +11,424 @@
 
 // Header imports
 #include "io_device.h"
+#include "instrumentation.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+
+// Policy names, indexed by IO_Policy
+static const char* policy_names[] = {"fifo", "priority", "sstf", "scan", "cscan"};
+
+/**
+* @brief Converts a policy name (fifo, priority, sstf, scan, cscan) into a policy
+* @param name: the policy name
+* @param policy: filled in with the matching policy
+* @return true if the name was recognized, false if not
+*/
+bool parse_io_policy(const char* name, IO_Policy* policy) {
+	for (int i = 0; i <= IO_CSCAN; i++) {
+		if (strcmp(name, policy_names[i]) == 0) {
+			*policy = (IO_Policy)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+* @brief Converts a policy into its name
+* @param policy: the policy
+* @return the policy name
+*/
+const char* get_io_policy_name(IO_Policy policy) {
+	return policy_names[policy];
+}
+
+/**
+* @brief Sets the number of requests the device services in parallel. Must be called
+* before the device receives any request
+* @param io_device: an IO device
+* @param queue_depth: number of service channels, at least 1
+*/
+void set_io_queue_depth(IO_Device_t* io_device, int queue_depth) {
+	INSTRUMENT_MEMORY_ALLOCATION();
+	PCB_t** channels = (PCB_t**)realloc(io_device->in_flight, queue_depth * sizeof(PCB_t*));
+	if (!channels) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	io_device->in_flight = channels;
+	io_device->queue_depth = queue_depth;
+}
+
+/**
+* @brief Adds the in-flight requests since the last change to the occupancy total. Called
+* before every change of the in-flight count
+* @param io_device: an IO device
+* @param current_time: the time of the change
+*/
+static void update_io_occupancy(IO_Device_t* io_device, Procsim_Time current_time) {
+	io_device->total_occupancy += (Procsim_Time)io_device->in_flight_count * (current_time - io_device->last_occupancy_time);
+	io_device->last_occupancy_time = current_time;
+}
+
+/**
+* @brief Starts servicing a PCB on a free channel of the device, moving the head to its sector
+* @param io_device: an IO device with a free channel
+* @param pcb: the PCB to activate
+* @param current_time: the time the request starts being serviced
+*/
+static void activate_io_request(IO_Device_t* io_device, PCB_t* pcb, Procsim_Time current_time) {
+	update_io_occupancy(io_device, current_time);
+	io_device->in_flight[io_device->in_flight_count++] = pcb;
+	if (io_device->in_flight_count > io_device->max_in_flight) {
+		io_device->max_in_flight = io_device->in_flight_count;
+	}
+
+	// Device analytics
+	Procsim_Time queue_delay = current_time - io_device->pcb_store->start_io_blocked_time[pcb->slot];
+	io_device->serviced_requests++;
+	io_device->total_queue_delay += queue_delay;
+	if (queue_delay > io_device->max_queue_delay) {
+		io_device->max_queue_delay = queue_delay;
+	}
+	io_device->total_seek_distance += labs((long)pcb->target_sector - io_device->head_sector);
+	io_device->head_sector = pcb->target_sector;
+}
 
 /**
-* @brief Adds a PCB to the IO devices queue (or automatically into the active IO device
-* category if none are queued
+* @brief Stores a PCB in the waiting request structure of the device policy
+* @param io_device: an IO device
+* @param pcb: the PCB to store
+*/
+static void store_io_request(IO_Device_t* io_device, PCB_t* pcb) {
+	int sector = pcb->target_sector;
+
+	switch (io_device->policy) {
+		case IO_FIFO:
+			enqueue_queue(&io_device->queue, pcb);
+			break;
+		case IO_PRIORITY:
+			// Min-heap, so negate the priority to pop the highest first
+			push_request_heap(&io_device->upper_heap, -(long)pcb->priority, pcb);
+			break;
+		case IO_SSTF:
+			// Lower heap is keyed on the negated sector to pop the closest sector below the head
+			if (sector >= io_device->head_sector) {
+				push_request_heap(&io_device->upper_heap, sector, pcb);
+			} else {
+				push_request_heap(&io_device->lower_heap, -(long)sector, pcb);
+			}
+			break;
+		case IO_SCAN:
+			// A request at the head is serviced next in whatever direction the sweep is going
+			if (sector > io_device->head_sector || (sector == io_device->head_sector && io_device->sweeping_up)) {
+				push_request_heap(&io_device->upper_heap, sector, pcb);
+			} else {
+				push_request_heap(&io_device->lower_heap, -(long)sector, pcb);
+			}
+			break;
+		case IO_CSCAN:
+			// Requests behind the head wait for the next sweep, which also starts from the lowest sector
+			if (sector >= io_device->head_sector) {
+				push_request_heap(&io_device->upper_heap, sector, pcb);
+			} else {
+				push_request_heap(&io_device->lower_heap, sector, pcb);
+			}
+			break;
+	}
+}
+
+/**
+* @brief Removes the next waiting request according to the device policy
+* @param io_device: an IO device with at least one waiting request
+* @return the next PCB to service
+*/
+static PCB_t* select_next_io_request(IO_Device_t* io_device) {
+	RequestHeap_t* upper = &io_device->upper_heap;
+	RequestHeap_t* lower = &io_device->lower_heap;
+
+	switch (io_device->policy) {
+		case IO_FIFO:
+			return dequeue_queue(&io_device->queue);
+		case IO_PRIORITY:
+			return pop_request_heap(upper);
+		case IO_SSTF:
+			if (is_empty_request_heap(lower)) {
+				return pop_request_heap(upper);
+			}
+			if (is_empty_request_heap(upper)) {
+				return pop_request_heap(lower);
+			}
+			// Pick whichever side is closer to the head, ties keep moving up
+			if (peek_key_request_heap(upper) - io_device->head_sector <= io_device->head_sector + peek_key_request_heap(lower)) {
+				return pop_request_heap(upper);
+			}
+			return pop_request_heap(lower);
+		case IO_SCAN:
+			// Reverse the sweep once nothing is left in the current direction
+			if (io_device->sweeping_up && is_empty_request_heap(upper)) {
+				io_device->sweeping_up = false;
+			} else if (!io_device->sweeping_up && is_empty_request_heap(lower)) {
+				io_device->sweeping_up = true;
+			}
+			return pop_request_heap(io_device->sweeping_up ? upper : lower);
+		case IO_CSCAN:
+			if (is_empty_request_heap(upper)) {
+				// Wrap around, the waiting sweep becomes the current sweep
+				RequestHeap_t swap = *upper;
+				*upper = *lower;
+				*lower = swap;
+			}
+			return pop_request_heap(upper);
+	}
+
+	return NULL;
+}
+
+/**
+* @brief Adds a PCB to the IO devices waiting requests (or automatically into a free channel
+* if one is available). The PCB's start_io_blocked_time must already be set in the store
 * @param io_device: an IO device
 * @param pcb: the PCB to add to the I/O queue
+* @param current_time: the time of the request, used for device analytics
 */
-void add_io_request(IO_Device_t* io_device, PCB_t* pcb) {
-	if (io_device->active_pcb == NULL) {
-		// If there is no active IO operation, set the active operation to the inputted PCB
-		io_device->active_pcb = pcb;
+void add_io_request(IO_Device_t* io_device, PCB_t* pcb, Procsim_Time current_time) {
+	if (io_device->first_request_time < 0) {
+		io_device->first_request_time = current_time;
+		io_device->last_occupancy_time = current_time;
+	}
+
+	if (io_device->in_flight_count < io_device->queue_depth) {
+		// If a channel is free, start servicing the inputted PCB right away
+		activate_io_request(io_device, pcb, current_time);
 	} else {
-		// If there is an active IO operation, add the new request to the queue
-		enqueue_queue(&io_device->queue, pcb);
+		// If every channel is busy, hand the new request to the device policy
+		store_io_request(io_device, pcb);
 	}
 }
 
 /**
-* @brief Finishes the current PCB in the io device and activates next one
+* @brief Removes an in-flight request from its channel and fills the channel with the next
+* request chosen by the device policy
 * @param io_device: an IO device
+* @param index: position of the request in the in-flight array
+* @param current_time: the time of the completion
 * @return the completed PCB
 */
-PCB_t* complete_current_io_operation(IO_Device_t* io_device) {
-	// Retrieve the current active PCB
-	PCB_t* current_pcb = io_device->active_pcb;
+static PCB_t* finish_in_flight_request(IO_Device_t* io_device, int index, Procsim_Time current_time) {
+	PCB_t* current_pcb = io_device->in_flight[index];
 
-	if (io_device->queue.size > 0) {
-		// If there is another request in the queue, set the next PCB in queue to active
-		io_device->active_pcb = dequeue_queue(&io_device->queue);
-	} else {
-		// If there are no remaining IO requests in the queue, set active PCB to NULL
-		io_device->active_pcb = NULL;
+	// Close the gap so the in-flight array stays in start order
+	update_io_occupancy(io_device, current_time);
+	for (int i = index + 1; i < io_device->in_flight_count; i++) {
+		io_device->in_flight[i - 1] = io_device->in_flight[i];
+	}
+	io_device->in_flight_count--;
+
+	if (get_io_queue_size(io_device) > 0) {
+		// If there is another request waiting, activate the one picked by the policy
+		activate_io_request(io_device, select_next_io_request(io_device), current_time);
 	}
+
+	// Device analytics
+	io_device->completed_requests++;
+	io_device->last_completion_time = current_time;
+
 	current_pcb->state = READY;
 	return current_pcb;
 }
 
 /**
-* @brief For debugging purposes, prints the contents of the IO devices queue
-* @param io_device: contents to print
+* @brief Finishes the oldest in-flight request in the io device and activates the next one
+* chosen by the device policy
+* @param io_device: an IO device
+* @param current_time: the time of the completion, used for device analytics
+* @return the completed PCB
+*/
+PCB_t* complete_current_io_operation(IO_Device_t* io_device, Procsim_Time current_time) {
+	return finish_in_flight_request(io_device, 0, current_time);
+}
+
+/**
+* @brief Finishes the in-flight request of a specific process and activates the next one
+* chosen by the device policy
+* @param io_device: an IO device
+* @param PID: the process whose request finished
+* @param current_time: the time of the completion, used for device analytics
+* @return the completed PCB, or NULL if the process has no request in flight on the device
+*/
+PCB_t* complete_io_request(IO_Device_t* io_device, Procsim_PID PID, Procsim_Time current_time) {
+	for (int i = 0; i < io_device->in_flight_count; i++) {
+		if (io_device->in_flight[i]->PID == PID) {
+			return finish_in_flight_request(io_device, i, current_time);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+* @brief Checks whether a process has a request in flight on the device
+* @param io_device: an IO device
+* @param PID: the process
+* @return true if one of the channels is servicing the process
+*/
+bool has_io_request_in_flight(const IO_Device_t* io_device, Procsim_PID PID) {
+	for (int i = 0; i < io_device->in_flight_count; i++) {
+		if (io_device->in_flight[i]->PID == PID) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+* @brief Completes requests on the device. A PID of 0 completes every in-flight and waiting
+* request, otherwise only the in-flight request of that process completes
+* @param io_device: an IO device
+* @param PID: the process whose request finished, or 0 for all requests
+* @param current_time: the time of the completion
+* @param released: array of at least get_io_request_count entries, filled with the completed PCB's
+* @return the number of completed PCB's
+*/
+int release_io_requests(IO_Device_t* io_device, Procsim_PID PID, Procsim_Time current_time, PCB_t** released) {
+	if (PID != 0) {
+		released[0] = complete_io_request(io_device, PID, current_time);
+		if (released[0] == NULL) {
+			report_fatal_error(PROCSIM_CORRUPT_STATE, "No I/O request in flight!");
+		}
+		return 1;
+	}
+
+	// Dump all processes into the released array
+	int count = get_io_request_count(io_device);
+	for (int i = 0; i < count; i++) {
+		released[i] = complete_current_io_operation(io_device, current_time);
+	}
+	return count;
+}
+
+/**
+* @brief Counts the requests waiting for a free channel
+* @param io_device: an IO device
+* @return the number of waiting requests
+*/
+int get_io_queue_size(const IO_Device_t* io_device) {
+	return get_size_queue(&io_device->queue) + get_size_request_heap(&io_device->upper_heap)
+		+ get_size_request_heap(&io_device->lower_heap);
+}
+
+/**
+* @brief Counts every request on the device, in flight or waiting
+* @param io_device: an IO device
+* @return the number of requests
+*/
+int get_io_request_count(const IO_Device_t* io_device) {
+	return io_device->in_flight_count + get_io_queue_size(io_device);
+}
+
+/**
+* @brief Fills in the seek distance, queueing delay, throughput and occupancy statistics of the device
+* @param io_device: the device to report on
+* @param stats: the statistics to fill in
+*/
+void get_io_device_stats(const IO_Device_t* io_device, DeviceStats_t* stats) {
+	stats->id = io_device->id;
+	stats->policy = io_device->policy;
+	stats->queue_depth = io_device->queue_depth;
+	stats->configured = io_device->configured;
+	stats->serviced_requests = io_device->serviced_requests;
+	stats->total_seek_distance = io_device->total_seek_distance;
+	stats->average_queue_delay = io_device->serviced_requests > 0
+		? (double)io_device->total_queue_delay / io_device->serviced_requests : 0.0;
+	stats->max_queue_delay = io_device->max_queue_delay;
+
+	// Throughput and occupancy are measured from the first request to the last completion
+	Procsim_Time active_window = io_device->last_completion_time - io_device->first_request_time;
+	stats->throughput = active_window > 0 ? (double)io_device->completed_requests / active_window : 0.0;
+	stats->average_in_flight = active_window > 0 ? (double)io_device->total_occupancy / active_window : 0.0;
+	stats->max_in_flight = io_device->max_in_flight;
+}
+
+/**
+* @brief Makes an independent copy of a device for a cloned simulator
+* @param clone: the device to fill in, not initialized
+* @param io_device: the device to copy
+* @param pcb_store: the cloned store, already holding copies of the device's PCB's
 */
-void dump_io_device(IO_Device_t* io_device) {
-	dump_queue(&io_device->queue);
-}
\ No newline at end of file
+void clone_io_device(IO_Device_t* clone, const IO_Device_t* io_device, PCB_Store_t* pcb_store) {
+	*clone = *io_device;
+	clone->pcb_store = pcb_store;
+
+	INSTRUMENT_MEMORY_ALLOCATION();
+	clone->in_flight = (PCB_t**)malloc(io_device->queue_depth * sizeof(PCB_t*));
+	if (!clone->in_flight) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	for (int i = 0; i < io_device->in_flight_count; i++) {
+		clone->in_flight[i] = get_cloned_pcb(pcb_store, io_device->in_flight[i]);
+	}
+
+	// The FIFO queue links live in the PCB's, which the store clone already repointed
+	clone->queue.head = get_cloned_pcb(pcb_store, io_device->queue.head);
+	clone->queue.tail = get_cloned_pcb(pcb_store, io_device->queue.tail);
+	clone_request_heap(&clone->upper_heap, &io_device->upper_heap, pcb_store);
+	clone_request_heap(&clone->lower_heap, &io_device->lower_heap, pcb_store);
+}
+
+/**
+* @brief Checks whether two devices without requests would service any further requests the same
+* way: same policy, channels and head position
+* @param io_device: an idle IO device
+* @param other: another idle IO device
+* @return true if they match
+*/
+bool has_same_idle_io_device_state(const IO_Device_t* io_device, const IO_Device_t* other) {
+	return io_device->policy == other->policy && io_device->queue_depth == other->queue_depth
+		&& io_device->configured == other->configured && io_device->head_sector == other->head_sector
+		&& io_device->sweeping_up == other->sweeping_up;
+}
+
+/**
+* @brief Adds the analytics an earlier copy of the device gathered before this one took over.
+* Neither device may have requests left
+* @param io_device: the device that took over
+* @param earlier: the device of the run up to the takeover
+*/
+void merge_io_device_statistics(IO_Device_t* io_device, const IO_Device_t* earlier) {
+	io_device->serviced_requests += earlier->serviced_requests;
+	io_device->total_seek_distance += earlier->total_seek_distance;
+	io_device->total_queue_delay += earlier->total_queue_delay;
+	if (earlier->max_queue_delay > io_device->max_queue_delay) {
+		io_device->max_queue_delay = earlier->max_queue_delay;
+	}
+	io_device->total_occupancy += earlier->total_occupancy;
+	if (earlier->max_in_flight > io_device->max_in_flight) {
+		io_device->max_in_flight = earlier->max_in_flight;
+	}
+
+	// The active window runs from the earlier first request to the latest completion
+	if (io_device->completed_requests == 0) {
+		io_device->last_completion_time = earlier->last_completion_time;
+	}
+	io_device->completed_requests += earlier->completed_requests;
+	if (earlier->first_request_time >= 0) {
+		io_device->first_request_time = earlier->first_request_time;
+	}
+	if (io_device->last_occupancy_time < earlier->last_occupancy_time) {
+		io_device->last_occupancy_time = earlier->last_occupancy_time;
+	}
+}
+
+/**
+* @brief clears the waiting request structures of the device from memory
+* @param io_device: the device to clear
+*/
+void free_io_device(IO_Device_t* io_device) {
+	free(io_device->in_flight);
+	free_queue(&io_device->queue);
+	free_request_heap(&io_device->upper_heap);
+	free_request_heap(&io_device->lower_heap);
+}
@@ -1,7 +1,7 @@
 /**
  * @file io_device.h
  * @brief Declares the attributes and functions of a standard I/O device.
- * This includes the current PCB using the I/O device and a queue for the next PCB's
+ * This includes the PCB's using the I/O device channels and the structures holding the next PCB's
  *
  * Course: CSC3210
  * Section: 003
@@ -14,48 +14,189 @@
 
 // Header imports
 #include "queue.h"
+#include "request_heap.h"
 #include "PCB.h"
+#include "pcb_store.h"
+#include "procsim.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdbool.h>
+#include <stdlib.h>
 
 /**
 * @struct IO_Device_t
-* @brief Defines the attributes of an IO device
+* @brief Defines the attributes of an IO device. A device services up to queue_depth
+* requests in parallel, one per channel
 */
 typedef struct IO_DEVICE {
 	int id;
-	PCB_t* active_pcb;
+	PCB_Store_t* pcb_store;	// Statistics of the PCB's passing through the device
+	PCB_t** in_flight;	// Requests being serviced, in the order they were started
+	int in_flight_count;
+	int queue_depth;
+	IO_Policy policy;
+	bool configured;	// Set when the device was configured on the command line
+
+	// Waiting requests. FIFO uses the queue, priority uses upper_heap, and the seek based
+	// policies keep requests at or above the head in upper_heap and the rest in lower_heap
 	Queue_t queue;
+	RequestHeap_t upper_heap;
+	RequestHeap_t lower_heap;
+	int head_sector;
+	bool sweeping_up;
+
+	// Device analytics
+	long serviced_requests;
+	long total_seek_distance;
+	Procsim_Time total_queue_delay;
+	Procsim_Time max_queue_delay;
+	long completed_requests;
+	Procsim_Time first_request_time;
+	Procsim_Time last_completion_time;
+	Procsim_Time last_occupancy_time;
+	Procsim_Time total_occupancy;	// Sum of in-flight requests over time
+	int max_in_flight;
 } IO_Device_t;
 
 /**
 * @brief Initializes the contents of the io device struct
 * @param io_device: the IO device to initialize
 * @param id: the ID of the new I/O device
+* @param pcb_store: the store holding the statistics of the PCB's that will use the device
 */
-static void initialize_io_device(IO_Device_t* io_device, int id){
+static void initialize_io_device(IO_Device_t* io_device, int id, PCB_Store_t* pcb_store){
 	io_device->id = id;
-	io_device->active_pcb = NULL;
+	io_device->pcb_store = pcb_store;
+	io_device->in_flight = (PCB_t**)malloc(sizeof(PCB_t*));
+	if (!io_device->in_flight) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	io_device->in_flight_count = 0;
+	io_device->queue_depth = 1;
+	io_device->policy = IO_FIFO;
+	io_device->configured = false;
 	initialize_queue(&io_device->queue);
+	initialize_request_heap(&io_device->upper_heap);
+	initialize_request_heap(&io_device->lower_heap);
+	io_device->head_sector = 0;
+	io_device->sweeping_up = true;
+	io_device->serviced_requests = 0;
+	io_device->total_seek_distance = 0;
+	io_device->total_queue_delay = 0;
+	io_device->max_queue_delay = 0;
+	io_device->completed_requests = 0;
+	io_device->first_request_time = -1;
+	io_device->last_completion_time = 0;
+	io_device->last_occupancy_time = 0;
+	io_device->total_occupancy = 0;
+	io_device->max_in_flight = 0;
 }
 
 /**
-* @brief Adds a PCB to the IO devices queue (or automatically into the active IO device
-* category if none are queued
+* @brief Sets the number of requests the device services in parallel. Must be called
+* before the device receives any request
+* @param io_device: an IO device
+* @param queue_depth: number of service channels, at least 1
+*/
+void set_io_queue_depth(IO_Device_t* io_device, int queue_depth);
+
+/**
+* @brief Adds a PCB to the IO devices waiting requests (or automatically into a free channel
+* if one is available). The PCB's start_io_blocked_time must already be set in the store
 * @param io_device: an IO device
 * @param pcb: the PCB to add to the I/O queue
+* @param current_time: the time of the request, used for device analytics
+*/
+void add_io_request(IO_Device_t* io_device, PCB_t* pcb, Procsim_Time current_time);
+
+/**
+* @brief Finishes the oldest in-flight request in the io device and activates the next one
+* chosen by the device policy
+* @param io_device: an IO device
+* @param current_time: the time of the completion, used for device analytics
+* @return the completed PCB
+*/
+PCB_t* complete_current_io_operation(IO_Device_t* io_device, Procsim_Time current_time);
+
+/**
+* @brief Finishes the in-flight request of a specific process and activates the next one
+* chosen by the device policy
+* @param io_device: an IO device
+* @param PID: the process whose request finished
+* @param current_time: the time of the completion, used for device analytics
+* @return the completed PCB, or NULL if the process has no request in flight on the device
+*/
+PCB_t* complete_io_request(IO_Device_t* io_device, Procsim_PID PID, Procsim_Time current_time);
+
+/**
+* @brief Checks whether a process has a request in flight on the device
+* @param io_device: an IO device
+* @param PID: the process
+* @return true if one of the channels is servicing the process
+*/
+bool has_io_request_in_flight(const IO_Device_t* io_device, Procsim_PID PID);
+
+/**
+* @brief Completes requests on the device. A PID of 0 completes every in-flight and waiting
+* request, otherwise only the in-flight request of that process completes
+* @param io_device: an IO device
+* @param PID: the process whose request finished, or 0 for all requests
+* @param current_time: the time of the completion
+* @param released: array of at least get_io_request_count entries, filled with the completed PCB's
+* @return the number of completed PCB's
+*/
+int release_io_requests(IO_Device_t* io_device, Procsim_PID PID, Procsim_Time current_time, PCB_t** released);
+
+/**
+* @brief Counts the requests waiting for a free channel
+* @param io_device: an IO device
+* @return the number of waiting requests
 */
-void add_io_request(IO_Device_t* io_device, PCB_t* pcb);
+int get_io_queue_size(const IO_Device_t* io_device);
 
 /**
-* @brief Finishes the current PCB in the io device and activates next one
+* @brief Counts every request on the device, in flight or waiting
 * @param io_device: an IO device
-* @return a list of completed PCB's
+* @return the number of requests
+*/
+int get_io_request_count(const IO_Device_t* io_device);
+
+/**
+* @brief Fills in the seek distance, queueing delay, throughput and occupancy statistics of the device
+* @param io_device: the device to report on
+* @param stats: the statistics to fill in
+*/
+void get_io_device_stats(const IO_Device_t* io_device, DeviceStats_t* stats);
+
+/**
+* @brief Makes an independent copy of a device for a cloned simulator
+* @param clone: the device to fill in, not initialized
+* @param io_device: the device to copy
+* @param pcb_store: the cloned store, already holding copies of the device's PCB's
+*/
+void clone_io_device(IO_Device_t* clone, const IO_Device_t* io_device, PCB_Store_t* pcb_store);
+
+/**
+* @brief Checks whether two devices without requests would service any further requests the same
+* way: same policy, channels and head position
+* @param io_device: an idle IO device
+* @param other: another idle IO device
+* @return true if they match
+*/
+bool has_same_idle_io_device_state(const IO_Device_t* io_device, const IO_Device_t* other);
+
+/**
+* @brief Adds the analytics an earlier copy of the device gathered before this one took over.
+* Neither device may have requests left
+* @param io_device: the device that took over
+* @param earlier: the device of the run up to the takeover
 */
-PCB_t* complete_current_io_operation(IO_Device_t* io_device);
+void merge_io_device_statistics(IO_Device_t* io_device, const IO_Device_t* earlier);
 
 /**
-* @brief For debugging purposes, prints the contents of the IO devices queue
-* @param io_device: contents to print
+* @brief clears the channel and waiting request structures of the device from memory
+* @param io_device: the device to clear
 */
-void dump_io_device(IO_Device_t* io_device);
+void free_io_device(IO_Device_t* io_device);
 
 #endif //IO_DEVICE_H
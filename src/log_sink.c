@@ -0,0 +1,290 @@
+/**
+ * @file log_sink.c
+ * @brief Defines the log sink that moves event output off the simulation thread
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "log_sink.h"
+// Library imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_RING_MASK (LOG_RING_CAPACITY - 1)
+
+/**
+* @brief Formats a record into its event line
+* @param record: the record
+* @param line: buffer of at least LOG_MAX_LINE_LENGTH characters
+* @return the length of the line, 0 for records without a line
+*/
+int format_log_record(const LogRecord_t* record, char* line) {
+	switch (record->kind) {
+		case LOG_PROCESS_STARTED:
+			return snprintf(line, LOG_MAX_LINE_LENGTH, "%lld: Starting process with PID: %lld PRIORITY: %d\n",
+							record->time, record->PID, record->priority);
+		case LOG_PROCESS_SCHEDULED:
+			return snprintf(line, LOG_MAX_LINE_LENGTH, "%lld: Process scheduled to run with PID: %lld PRIORITY: %d\n",
+							record->time, record->PID, record->priority);
+		case LOG_IO_WAITING:
+			return snprintf(line, LOG_MAX_LINE_LENGTH, "%lld: Process with PID: %lld waiting for I/O device %d\n",
+							record->time, record->PID, record->device);
+		case LOG_IO_COMPLETED:
+			return snprintf(line, LOG_MAX_LINE_LENGTH, "%lld: I/O completed for I/O device %d\n",
+							record->time, record->device);
+		case LOG_PROCESS_ENDED:
+			return snprintf(line, LOG_MAX_LINE_LENGTH, "%lld: Ending process with PID: %lld\n",
+							record->time, record->PID);
+		default:
+			return 0;
+	}
+}
+
+/**
+* @brief Looks up the name of an event kind, as used in CSV output
+* @param kind: the kind
+* @return the name
+*/
+const char* get_log_kind_name(int kind) {
+	static const char* names[LOG_KIND_COUNT] = {"start", "dispatch", "io_wait", "io_complete", "end", "preempt",
+											"ready", "io_release"};
+	return kind >= 0 && kind < LOG_KIND_COUNT ? names[kind] : "unknown";
+}
+
+/**
+* @brief Writes a buffer to the sink's output, retrying partial and interrupted writes
+* @return true on success, false if the output can no longer be written
+*/
+static bool write_buffer(LogSink_t* sink, const char* buffer, size_t length) {
+	while (length > 0) {
+		ssize_t written = write(sink->output_fd, buffer, length);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buffer += written;
+		length -= (size_t)written;
+		sink->bytes_written += written;
+	}
+	sink->write_calls++;
+	return true;
+}
+
+/**
+* @brief Adds a record to an output buffer, as an event line or in its binary layout
+* @return the number of bytes added
+*/
+static size_t encode_log_record(const LogSink_t* sink, const LogRecord_t* record, char* buffer) {
+	if (sink->binary_output != NULL) {
+		memcpy(buffer, record, sizeof(LogRecord_t));
+		return sizeof(LogRecord_t);
+	}
+	return (size_t)format_log_record(record, buffer);
+}
+
+/**
+* @brief Body of the writer thread. Encodes published records into a large buffer and writes
+* it whenever it fills up, and once more when the sink is stopped
+* @param argument: the sink
+*/
+static void* run_writer(void* argument) {
+	LogSink_t* sink = (LogSink_t*)argument;
+	char* buffer = (char*)malloc(LOG_WRITE_BUFFER_SIZE);
+	if (!buffer) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	size_t used = 0;
+	unsigned long head = 0;
+	bool writable = true;
+
+	while (true) {
+		// The handlers publish their last records before finished is set
+		bool finished = atomic_load_explicit(&sink->finished, memory_order_acquire);
+		unsigned long tail = atomic_load_explicit(&sink->tail, memory_order_acquire);
+		if (head == tail) {
+			if (finished) {
+				break;
+			}
+			// Nothing to format, give the simulation the processor for a moment
+			struct timespec pause = {0, 100000};
+			nanosleep(&pause, NULL);
+			continue;
+		}
+
+		while (head != tail) {
+			if (LOG_WRITE_BUFFER_SIZE - used < LOG_MAX_LINE_LENGTH) {
+				writable = writable && write_buffer(sink, buffer, used);
+				used = 0;
+			}
+			used += encode_log_record(sink, &sink->records[head & LOG_RING_MASK], buffer + used);
+			head++;
+		}
+		atomic_store_explicit(&sink->head, head, memory_order_release);
+	}
+
+	if (writable && used > 0) {
+		write_buffer(sink, buffer, used);
+	}
+	free(buffer);
+	return NULL;
+}
+
+/**
+* @brief Makes every appended record visible to the writer thread
+*/
+static void publish_log_records(LogSink_t* sink) {
+	atomic_store_explicit(&sink->tail, sink->producer_tail, memory_order_release);
+}
+
+/**
+* @brief Parses the name of a backpressure behavior
+* @param name: block or drop
+* @param backpressure: filled in with the parsed behavior
+* @return true if the name is known, false otherwise
+*/
+bool parse_log_backpressure(const char* name, Log_Backpressure* backpressure) {
+	if (strcmp(name, "block") == 0) {
+		*backpressure = LOG_BLOCK;
+	} else if (strcmp(name, "drop") == 0) {
+		*backpressure = LOG_DROP;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/**
+* @brief Starts the sink. With threading enabled a writer thread takes over its output until
+* the sink is stopped, so anything printed to stdout before must already be flushed
+* @param sink: the sink to start
+* @param threaded: whether to format and write records on a separate thread
+* @param backpressure: what to do when the ring is full
+* @param binary_output: binary log file, written from its header on, or NULL for event lines
+*/
+void start_log_sink(LogSink_t* sink, bool threaded, Log_Backpressure backpressure, FILE* binary_output) {
+	sink->threaded = threaded;
+	sink->backpressure = backpressure;
+	sink->binary_output = binary_output;
+	sink->output_fd = STDOUT_FILENO;
+	sink->records = NULL;
+
+	atomic_init(&sink->tail, 0);
+	sink->producer_tail = 0;
+	sink->producer_cached_head = 0;
+	sink->records_appended = 0;
+	sink->records_dropped = 0;
+	sink->producer_stalls = 0;
+
+	atomic_init(&sink->head, 0);
+	sink->write_calls = 0;
+	sink->bytes_written = 0;
+
+	atomic_init(&sink->finished, false);
+
+	if (binary_output != NULL) {
+		LogFileHeader_t header = {LOG_FILE_MAGIC, LOG_FILE_VERSION, (int)sizeof(LogRecord_t)};
+		fwrite(&header, sizeof(header), 1, binary_output);
+		// The writer thread bypasses the stream, so the header has to reach the file first
+		fflush(binary_output);
+		sink->output_fd = fileno(binary_output);
+	}
+
+	if (!threaded) {
+		return;
+	}
+
+	sink->records = (LogRecord_t*)malloc(LOG_RING_CAPACITY * sizeof(LogRecord_t));
+	if (!sink->records) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	if (pthread_create(&sink->writer, NULL, run_writer, sink) != 0) {
+		fprintf(stderr, "ERROR: Could not start the log writer thread!\n");
+		exit(1);
+	}
+}
+
+/**
+* @brief Appends a scheduling event to the sink
+* @param sink: the sink
+* @param record: the event
+*/
+void append_log_record(LogSink_t* sink, const LogRecord_t* record) {
+	if (!sink->threaded) {
+		if (sink->binary_output != NULL) {
+			fwrite(record, sizeof(LogRecord_t), 1, sink->binary_output);
+		} else {
+			char line[LOG_MAX_LINE_LENGTH];
+			fwrite(line, 1, (size_t)format_log_record(record, line), stdout);
+		}
+		return;
+	}
+
+	sink->records_appended++;
+	if (sink->producer_tail - sink->producer_cached_head >= LOG_RING_CAPACITY) {
+		sink->producer_cached_head = atomic_load_explicit(&sink->head, memory_order_acquire);
+		if (sink->producer_tail - sink->producer_cached_head >= LOG_RING_CAPACITY) {
+			// The writer can only free what it has seen, so publish before waiting or dropping
+			publish_log_records(sink);
+			if (sink->backpressure == LOG_DROP) {
+				sink->records_dropped++;
+				return;
+			}
+
+			sink->producer_stalls++;
+			while (sink->producer_tail - sink->producer_cached_head >= LOG_RING_CAPACITY) {
+				sched_yield();
+				sink->producer_cached_head = atomic_load_explicit(&sink->head, memory_order_acquire);
+			}
+		}
+	}
+
+	sink->records[sink->producer_tail & LOG_RING_MASK] = *record;
+	sink->producer_tail++;
+
+	unsigned long published = atomic_load_explicit(&sink->tail, memory_order_relaxed);
+	if (sink->producer_tail - published >= LOG_PUBLISH_BATCH) {
+		publish_log_records(sink);
+	}
+}
+
+/**
+* @brief Writes every remaining record and stops the writer thread. A binary log file is
+* flushed but left open
+* @param sink: the sink to stop
+*/
+void stop_log_sink(LogSink_t* sink) {
+	if (!sink->threaded) {
+		if (sink->binary_output != NULL) {
+			fflush(sink->binary_output);
+		}
+		return;
+	}
+
+	publish_log_records(sink);
+	atomic_store_explicit(&sink->finished, true, memory_order_release);
+	pthread_join(sink->writer, NULL);
+	free(sink->records);
+	sink->records = NULL;
+}
+
+/**
+* @brief Prints the record, drop, stall and write counts of a threaded sink
+* @param sink: the stopped sink
+*/
+void print_log_sink_summary(const LogSink_t* sink) {
+	printf("LOG: RECORDS %ld, DROPPED %ld, STALLS %ld, WRITES %ld, BYTES %ld\n", sink->records_appended,
+		sink->records_dropped, sink->producer_stalls, sink->write_calls, sink->bytes_written);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file log_sink.h
+ * @brief Declares the log sink. The simulator's compact binary records of scheduling events
+ *		  which are formatted into the event lines or written out as a binary log, either
+ *		  right away or by a writer thread
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define LOG_CACHE_LINE_SIZE 64
+
+// Number of records in the ring, a power of two
+#define LOG_RING_CAPACITY 16384
+
+// Records the handlers append before publishing them to the writer thread
+#define LOG_PUBLISH_BATCH 64
+
+// Size of the output buffer handed to each write() call
+#define LOG_WRITE_BUFFER_SIZE 65536
+
+// Longest line a record formats into
+#define LOG_MAX_LINE_LENGTH 128
+
+// Binary log file header
+#define LOG_FILE_MAGIC 0x474f4c50	// "PLOG"
+#define LOG_FILE_VERSION 2		// Version 2 widened the time and PID of a record to 64 bits
+
+/**
+* Defines what a handler does when the writer thread falls behind and the ring is full
+*/
+typedef enum log_backpressure {
+	LOG_BLOCK,	// Wait for the writer thread, no line is lost
+	LOG_DROP,	// Discard the record and count it
+} Log_Backpressure;
+
+/**
+* @struct LogFileHeader_t
+* @brief Defines the header at the start of a binary log file
+*/
+typedef struct log_file_header {
+	int magic;
+	int version;
+	int record_size;
+} LogFileHeader_t;
+
+/**
+* @struct LogSink_t
+* @brief Defines the sink shared by the handlers and the writer thread. The handler and
+* writer indices sit on separate cache lines
+*/
+typedef struct log_sink {
+	bool threaded;			// False handles every record right away
+	Log_Backpressure backpressure;
+	FILE* binary_output;	// Binary log file, NULL to write event lines to stdout
+	int output_fd;			// Descriptor the writer thread writes to
+	LogRecord_t* records;
+	pthread_t writer;
+
+	// Producer (handler) side
+	_Alignas(LOG_CACHE_LINE_SIZE) atomic_ulong tail;	// Records published to the writer
+	unsigned long producer_tail;						// Records appended, published or not
+	unsigned long producer_cached_head;
+	long records_appended;
+	long records_dropped;
+	long producer_stalls;								// Times a handler waited for the writer
+
+	// Consumer (writer thread) side
+	_Alignas(LOG_CACHE_LINE_SIZE) atomic_ulong head;	// Records the writer has formatted
+	long write_calls;
+	long bytes_written;
+
+	_Alignas(LOG_CACHE_LINE_SIZE) atomic_bool finished;	// Set once the handlers are done
+} LogSink_t;
+
+/**
+* @brief Parses the name of a backpressure behavior
+* @param name: block or drop
+* @param backpressure: filled in with the parsed behavior
+* @return true if the name is known, false otherwise
+*/
+bool parse_log_backpressure(const char* name, Log_Backpressure* backpressure);
+
+/**
+* @brief Formats a record into its event line
+* @param record: the record
+* @param line: buffer of at least LOG_MAX_LINE_LENGTH characters
+* @return the length of the line, 0 for records without a line
+*/
+int format_log_record(const LogRecord_t* record, char* line);
+
+/**
+* @brief Looks up the name of an event kind, as used in CSV output
+* @param kind: the kind
+* @return the name
+*/
+const char* get_log_kind_name(int kind);
+
+/**
+* @brief Starts the sink. With threading enabled a writer thread takes over its output until
+* the sink is stopped, so anything printed to stdout before must already be flushed
+* @param sink: the sink to start
+* @param threaded: whether to format and write records on a separate thread
+* @param backpressure: what to do when the ring is full
+* @param binary_output: binary log file, written from its header on, or NULL for event lines
+*/
+void start_log_sink(LogSink_t* sink, bool threaded, Log_Backpressure backpressure, FILE* binary_output);
+
+/**
+* @brief Appends a scheduling event to the sink
+* @param sink: the sink
+* @param record: the event
+*/
+void append_log_record(LogSink_t* sink, const LogRecord_t* record);
+
+/**
+* @brief Writes every remaining record and stops the writer thread. A binary log file is
+* flushed but left open
+* @param sink: the sink to stop
+*/
+void stop_log_sink(LogSink_t* sink);
+
+/**
+* @brief Prints the record, drop, stall and write counts of a threaded sink
+* @param sink: the stopped sink
+*/
+void print_log_sink_summary(const LogSink_t* sink);
+
+#endif //LOG_SINK_H
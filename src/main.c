@@ -1,6 +1,7 @@
 /**
  * @file main.c
- * @brief Program entry point.  Runs the process scheduler simulation
+ * @brief Program entry point.  Runs the process scheduler simulation on libprocsim, reading
+ *        the input file and writing the event lines, snapshots and analytics around it
  *
  * Course: CSC3210
  * Section: 003
@@ -9,95 +10,1085 @@
  */
 
 // Header imports
-#include "io_device.h"
-#include "Scheduler.h"
-#include "linkedList.h"
+#include "procsim.h"
+#include "event.h"
+#include "snapshot.h"
+#include "trace_index.h"
+#include "event_pipeline.h"
+#include "log_sink.h"
+#include "chrome_trace.h"
+#include "time_series.h"
+#include "report.h"
+#include "instrumentation.h"
+#include "daemon.h"
+#include "parallel_run.h"
+#include "trace_merge.h"
+#include "compressed_input.h"
 // Library imports
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#define IO_DEVICE_COUNT 10
+// Completed processes a daemon keeps the analytics of, older ones only count in the totals
+#define DAEMON_RESULT_RETENTION 4096
+// Group weights the command line can set
+#define MAX_GROUP_WEIGHT_OPTIONS 64
+
+/**
+ * @struct DeviceOption_t
+ * @brief Defines the command line configuration of one I/O device
+ */
+typedef struct device_option {
+    bool has_policy;
+    IO_Policy policy;
+    int queue_depth;    // 0 when not given
+} DeviceOption_t;
+
+/**
+ * @struct GroupWeightOption_t
+ * @brief Defines the command line weight of one process group
+ */
+typedef struct group_weight_option {
+    int group;
+    int weight;
+} GroupWeightOption_t;
+
+/**
+ * @struct SchedulerOption_t
+ * @brief Defines the command line configuration of the CPU scheduler
+ */
+typedef struct scheduler_option {
+    bool has_policy;    // Overrides the first line of the input file
+    Scheduling_Policy policy;
+    int initial_burst;
+    double alpha;
+    bool has_switch_costs;
+    SwitchCosts_t switch_costs;
+    GroupWeightOption_t group_weights[MAX_GROUP_WEIGHT_OPTIONS];
+    int group_weight_count;
+} SchedulerOption_t;
+
+/**
+ * @struct OutputSinks_t
+ * @brief Defines where the simulator's scheduling events go
+ */
+typedef struct output_sinks {
+    LogSink_t* log_sink;
+    ChromeTrace_t* chrome_trace;    // NULL unless a timeline is written
+} OutputSinks_t;
+
+/**
+ * @brief Prints the command line usage of the simulator
+ */
+static void print_usage(void) {
+    printf("Usage: procsim [-d device:policy]... [-q device:depth]... param_file\n");
+    printf("       procsim --merge [-d device:policy]... [-q device:depth]... shard_file...\n");
+    printf("  -d device:policy  I/O service policy of a device: fifo, priority, sstf, scan or cscan\n");
+    printf("  -q device:depth   number of requests a device services in parallel\n");
+    printf("  --scheduler policy      CPU scheduling policy instead of the one in param_file: fifo, priority,\n");
+    printf("                          sjf, srtf or fair\n");
+    printf("  --group-weight group:weight\n");
+    printf("                          CPU share of a process group under fair, 1 by default, repeatable\n");
+    printf("  --switch-costs switch:preempt:interrupt\n");
+    printf("                          CPU time charged per dispatch, per preemption and per I/O completion, and\n");
+    printf("                          report voluntary and involuntary context switches\n");
+    printf("  --burst-prediction initial:alpha\n");
+    printf("                          first predicted CPU burst and weight of the last burst for sjf and srtf,\n");
+    printf("                          %d:%.1f by default\n", DEFAULT_INITIAL_BURST, DEFAULT_BURST_ALPHA);
+    printf("  --checkpoint file       snapshot file written by --checkpoint-at and --checkpoint-every\n");
+    printf("  --checkpoint-at time    write a snapshot before the first event after this time\n");
+    printf("  --checkpoint-every n    write a snapshot after every n events\n");
+    printf("  --resume file           continue the run saved in a snapshot file\n");
+    printf("  --build-index           write the time index of param_file and exit\n");
+    printf("  --index file            time index file, param_file.idx by default\n");
+    printf("  --index-stride n        events between time index entries, %d by default\n", DEFAULT_INDEX_STRIDE);
+    printf("  --window start:end      fast-forward silently to start and only print events up to end\n");
+    printf("  --pipeline              parse the input on a separate thread\n");
+    printf("  --merge                 merge the events of several shard files in time order, sorting the shards\n");
+    printf("                          that are out of order on disk first\n");
+    printf("  --sort-run n            events sorted in memory at a time for an unsorted shard, %d by default\n", DEFAULT_SORT_RUN_SIZE);
+    printf("  --parallel n            simulate the trace in n segments cut at idle points, one thread each\n");
+    printf("  --decompress-thread     decompress a gzip or zstd param_file on a separate thread\n");
+    printf("  --pipeline-batch n      events the parser publishes at a time, %d by default\n", DEFAULT_PIPELINE_BATCH_SIZE);
+    printf("  --async-log             format and write event lines on a separate thread\n");
+    printf("  --log-backpressure mode block or drop event lines when the writer falls behind, block by default\n");
+    printf("  --binary-log file       write scheduling events to a binary log instead of printing them\n");
+    printf("  --chrome-trace file     write a Chrome Trace Event timeline of the CPU and I/O devices\n");
+    printf("  --samples file          write queue lengths, utilization and throughput as a CSV time series\n");
+    printf("  --sample-every n        length of a time series window, 100 by default\n");
+    printf("  --samples-binary        write the time series in binary instead of CSV\n");
+    printf("  --ready-spill n         keep at most n waiting processes of the priority scheduler in memory and\n");
+    printf("                          the rest in a scratch file\n");
+    printf("  --adaptive-queue        move the priority scheduler's ready queue between a list, buckets and a heap\n");
+    printf("                          as it grows, logging each switch to stderr\n");
+    printf("  --what-if time          branch before the first event after time, finish the branch with preemption\n");
+    printf("                          switched (fifo and priority, sjf and srtf, fair to priority) and compare both\n");
+    printf("                          runs\n");
+    printf("  --daemon                read events from param_file as a named pipe or UNIX socket until SIGINT\n");
+    printf("                          or SIGTERM, the first line holding the simulation parameters\n");
+    printf("  --stats-socket path     answer each connection to this UNIX socket with the daemon statistics\n");
+}
+
+/**
+ * @brief Reports an error the simulator cannot recover from and exits
+ * @param error: the error
+ * @param message: a description of the error
+ */
+static void handle_fatal_error(Procsim_Fatal_Error error, const char* message) {
+    (void)error;
+    fprintf(stderr, "ERROR: %s\n", message);
+    exit(1);
+}
+
+/**
+ * @brief Hands a scheduling event to the log sink and the timeline exporter
+ * @param record: the event
+ * @param context: the OutputSinks_t of the run
+ */
+static void handle_record(const LogRecord_t* record, void* context) {
+    OutputSinks_t* sinks = (OutputSinks_t*)context;
+    append_log_record(sinks->log_sink, record);
+    if (sinks->chrome_trace != NULL) {
+        add_chrome_trace_record(sinks->chrome_trace, record);
+    }
+}
+
+/**
+ * @brief Logs a switch of the adaptive ready queue between backends
+ * @param record: the switch
+ * @param context: unused
+ */
+static void handle_queue_switch(const ReadyQueueSwitch_t* record, void* context) {
+    (void)context;
+    fprintf(stderr, "READY QUEUE: TIME %lld, %s -> %s, DEPTH %d, PRIORITIES %d, RANGE %lld, OPERATIONS %ld, "
+            "NS PER OPERATION %.1f, MIGRATION NS %.0f\n", record->time, get_ready_queue_backend_name(record->from),
+            get_ready_queue_backend_name(record->to), record->depth, record->distinct_priorities, record->priority_range,
+            record->operations, record->nanoseconds_per_operation, record->migration_nanoseconds);
+}
+
+/**
+ * @brief Writes a checkpoint of the run, reporting failures without stopping the run
+ * @param path: the snapshot file
+ * @param state: the state to save
+ */
+static void write_checkpoint(const char* path, const SnapshotState_t* state) {
+    if (!save_snapshot(path, state)) {
+        fprintf(stderr, "ERROR: Could not write snapshot %s\n", path);
+    }
+}
+
+/**
+ * @brief Reads a -d device:policy option
+ * @param option: the option argument
+ * @param device_options: the configuration of every device
+ * @return 0 on success, 1 if the option is malformed
+ */
+static int configure_io_device(const char* option, DeviceOption_t* device_options) {
+    int id;
+    char policy_name[16];
+    IO_Policy policy;
+
+    if (sscanf(option, "%d:%15s", &id, policy_name) != 2 || id < 0 || id >= IO_DEVICE_COUNT
+        || !parse_io_policy(policy_name, &policy)) {
+        fprintf(stderr, "ERROR: Invalid I/O device option: %s\n", option);
+        return 1;
+    }
+
+    device_options[id].has_policy = true;
+    device_options[id].policy = policy;
+    return 0;
+}
+
+/**
+ * @brief Reads a -q device:depth option
+ * @param option: the option argument
+ * @param device_options: the configuration of every device
+ * @return 0 on success, 1 if the option is malformed
+ */
+static int configure_io_queue_depth(const char* option, DeviceOption_t* device_options) {
+    int id;
+    int depth;
+
+    if (sscanf(option, "%d:%d", &id, &depth) != 2 || id < 0 || id >= IO_DEVICE_COUNT || depth < 1) {
+        fprintf(stderr, "ERROR: Invalid I/O queue depth option: %s\n", option);
+        return 1;
+    }
+
+    device_options[id].queue_depth = depth;
+    return 0;
+}
+
+/**
+ * @brief Reads the initial burst prediction and its weight, given as initial:alpha
+ * @param option: the option value
+ * @param scheduler_option: the scheduler configuration to update
+ * @return 0 on success, 1 on an invalid option
+ */
+static int configure_burst_prediction(const char* option, SchedulerOption_t* scheduler_option) {
+    int initial_burst = 0;
+    double alpha = 0.0;
+    if (sscanf(option, "%d:%lf", &initial_burst, &alpha) != 2 || initial_burst < 0 || !(alpha >= 0.0 && alpha <= 1.0)) {
+        fprintf(stderr, "ERROR: Invalid burst prediction option: %s\n", option);
+        return 1;
+    }
+
+    scheduler_option->initial_burst = initial_burst;
+    scheduler_option->alpha = alpha;
+    return 0;
+}
+
+/**
+ * @brief Reads the context switch, preemption and I/O interrupt costs, given as switch:preempt:interrupt
+ * @param option: the option value
+ * @param scheduler_option: the scheduler configuration to update
+ * @return 0 on success, 1 on an invalid option
+ */
+static int configure_switch_costs(const char* option, SchedulerOption_t* scheduler_option) {
+    SwitchCosts_t* costs = &scheduler_option->switch_costs;
+    if (sscanf(option, "%d:%d:%d", &costs->context_switch, &costs->preemption, &costs->io_interrupt) != 3
+        || costs->context_switch < 0 || costs->preemption < 0 || costs->io_interrupt < 0) {
+        fprintf(stderr, "ERROR: Invalid switch costs option: %s\n", option);
+        return 1;
+    }
+
+    scheduler_option->has_switch_costs = true;
+    return 0;
+}
+
+/**
+ * @brief Reads the weight of a process group, given as group:weight
+ * @param option: the option value
+ * @param scheduler_option: the scheduler configuration to update
+ * @return 0 on success, 1 on an invalid option
+ */
+static int configure_group_weight(const char* option, SchedulerOption_t* scheduler_option) {
+    int group = 0;
+    int weight = 0;
+    if (sscanf(option, "%d:%d", &group, &weight) != 2 || group < 0 || group >= PROCSIM_MAX_GROUPS || weight < 1
+        || scheduler_option->group_weight_count == MAX_GROUP_WEIGHT_OPTIONS) {
+        fprintf(stderr, "ERROR: Invalid group weight option: %s\n", option);
+        return 1;
+    }
+
+    GroupWeightOption_t* group_weight = &scheduler_option->group_weights[scheduler_option->group_weight_count++];
+    group_weight->group = group;
+    group_weight->weight = weight;
+    return 0;
+}
+
+/**
+ * @brief Picks the scheduling policy of a run and announces the start of the simulation
+ * @param scheduler: the first line of the input file, 0 to 4 as in Scheduling_Policy
+ * @param scheduler_option: the scheduler configuration, which can override the input file
+ * @return the policy
+ */
+static Scheduling_Policy start_scheduling_policy(int scheduler, const SchedulerOption_t* scheduler_option) {
+    Scheduling_Policy policy = scheduler > 0 && scheduler < SCHEDULE_POLICY_COUNT ? (Scheduling_Policy)scheduler : SCHEDULE_FIFO;
+    if (scheduler_option->has_policy) {
+        policy = scheduler_option->policy;
+    }
+
+    bool preemptive = policy == SCHEDULE_PRIORITY || policy == SCHEDULE_SRTF;
+    if (policy >= SCHEDULE_SJF) {
+        printf("Simulation Starting. Scheduler: %s, Preemption: %s\n\n", get_scheduling_policy_name(policy),
+               preemptive ? "true" : "false");
+    } else {
+        printf("Simulation Starting. Preemption: %s\n\n", preemptive ? "true" : "false");
+    }
+    return policy;
+}
+
+/**
+ * @brief Pairs each policy with the one that differs only in preemption, which a what-if branch switches to
+ * @param policy: the policy
+ * @return the counterpart policy
+ */
+static Scheduling_Policy get_counterpart_policy(Scheduling_Policy policy) {
+    switch (policy) {
+        case SCHEDULE_FIFO:
+            return SCHEDULE_PRIORITY;
+        case SCHEDULE_PRIORITY:
+            return SCHEDULE_FIFO;
+        case SCHEDULE_SJF:
+            return SCHEDULE_SRTF;
+        case SCHEDULE_SRTF:
+            return SCHEDULE_SJF;
+        default:
+            // Fair-share orders each group by priority, so its preemptive counterpart is priority scheduling
+            return SCHEDULE_PRIORITY;
+    }
+}
+
+/**
+ * @brief Creates the simulator and applies the scheduler and device options to it
+ * @param policy: the scheduling policy
+ * @param scheduler_option: the scheduler configuration
+ * @param device_options: the configuration of every device
+ * @return the simulator
+ */
+static Procsim_t* create_simulator(Scheduling_Policy policy, const SchedulerOption_t* scheduler_option,
+                                   const DeviceOption_t* device_options) {
+    Procsim_t* simulator = procsim_create(false, IO_DEVICE_COUNT);
+    procsim_set_scheduling_policy(simulator, policy);
+    procsim_set_burst_prediction(simulator, scheduler_option->initial_burst, scheduler_option->alpha);
+    if (scheduler_option->has_switch_costs) {
+        procsim_set_switch_costs(simulator, &scheduler_option->switch_costs);
+    }
+    for (int i = 0; i < scheduler_option->group_weight_count; i++) {
+        procsim_set_group_weight(simulator, scheduler_option->group_weights[i].group, scheduler_option->group_weights[i].weight);
+    }
+    for (int i = 0; i < IO_DEVICE_COUNT; i++) {
+        if (device_options[i].has_policy) {
+            procsim_set_device_policy(simulator, i, device_options[i].policy);
+        }
+        if (device_options[i].queue_depth > 0) {
+            procsim_set_device_queue_depth(simulator, i, device_options[i].queue_depth);
+        }
+    }
+    return simulator;
+}
+
+/**
+ * @brief Runs the simulator as a daemon fed from a named pipe or UNIX socket and prints the
+ *        analytics once it is stopped
+ * @param event_path: the named pipe or socket path
+ * @param stats_path: the statistics socket path, NULL for none
+ * @param scheduler_option: the scheduler configuration
+ * @param device_options: the configuration of every device
+ * @param async_log: whether event lines are written on a separate thread
+ * @param log_backpressure: what the log sink does when the writer falls behind
+ * @param binary_log_path: the binary log file, NULL to print event lines
+ * @param chrome_trace_path: the timeline file, NULL for none
+ * @return the exit status
+ */
+static int serve_daemon(const char* event_path, const char* stats_path, const SchedulerOption_t* scheduler_option,
+                        const DeviceOption_t* device_options, bool async_log, Log_Backpressure log_backpressure, const char* binary_log_path,
+                        const char* chrome_trace_path) {
+    // Output files are opened first, so a failure leaves no socket behind
+    FILE* binary_log = NULL;
+    if (binary_log_path != NULL) {
+        binary_log = fopen(binary_log_path, "wb");
+        if (binary_log == NULL) {
+            fprintf(stderr, "ERROR: Could not open %s\n", binary_log_path);
+            return 1;
+        }
+        setvbuf(binary_log, NULL, _IOFBF, LOG_WRITE_BUFFER_SIZE);
+    }
+    ChromeTrace_t chrome_trace;
+    if (chrome_trace_path != NULL && !open_chrome_trace(&chrome_trace, chrome_trace_path)) {
+        fprintf(stderr, "ERROR: Could not open %s\n", chrome_trace_path);
+        return 1;
+    }
+
+    // The daemon holds its 64 KB read buffer, so it lives on the heap
+    Daemon_t* daemon = (Daemon_t*)malloc(sizeof(Daemon_t));
+    if (daemon == NULL) {
+        fprintf(stderr, "ERROR: Memory allocation failed!\n");
+        return 1;
+    }
+    if (!open_daemon(daemon, event_path, stats_path)) {
+        if (stats_path != NULL) {
+            fprintf(stderr, "ERROR: Could not open %s or %s\n", event_path, stats_path);
+        } else {
+            fprintf(stderr, "ERROR: Could not open %s\n", event_path);
+        }
+        free(daemon);
+        return 1;
+    }
+
+    Scheduling_Policy header_policy;
+    if (!read_daemon_header(daemon, &header_policy)) {
+        fprintf(stderr, "ERROR: No simulation parameters received\n");
+        close_daemon(daemon);
+        free(daemon);
+        return 1;
+    }
+    Scheduling_Policy policy = start_scheduling_policy(header_policy, scheduler_option);
+    Procsim_t* simulator = create_simulator(policy, scheduler_option, device_options);
+    procsim_set_result_retention(simulator, DAEMON_RESULT_RETENTION);
+
+    LogSink_t log_sink;
+    fflush(stdout);
+    start_log_sink(&log_sink, async_log, log_backpressure, binary_log);
+    OutputSinks_t output_sinks = {&log_sink, chrome_trace_path != NULL ? &chrome_trace : NULL};
+    procsim_set_record_callback(simulator, &handle_record, &output_sinks);
+
+    run_daemon(daemon, simulator);
+    close_daemon(daemon);
+
+    ProcsimStats_t stats;
+    procsim_get_stats(simulator, &stats);
+    stop_log_sink(&log_sink);
+    if (binary_log != NULL) {
+        fclose(binary_log);
+    }
+    if (chrome_trace_path != NULL && !close_chrome_trace(&chrome_trace, stats.last_event_time)) {
+        fprintf(stderr, "ERROR: Could not write %s\n", chrome_trace_path);
+    }
+
+    // Analytics outputs
+    printf("\nSimulation ended at time: %lld\n", stats.last_event_time);
+    printf("System idle time: %lld\n\n", stats.idle_time);
+    print_process_summaries(simulator);
+    print_io_device_summaries(simulator);
+    print_daemon_summary(daemon);
+    if (async_log) {
+        print_log_sink_summary(&log_sink);
+    }
+    INSTRUMENT_REPORT();
+
+    procsim_destroy(simulator);
+    free(daemon);
+    return 0;
+}
+
+/**
+ * @brief Reads the next event of the run, out of the shard merge or the pipeline
+ * @param pipeline: the pipeline, unused when merging
+ * @param trace_merge: the shard merge, NULL to read the pipeline
+ * @param event: filled in with the event
+ * @param next_offset: filled in with the offset of the event after it, 0 when merging
+ * @return true if an event was read, false at the end of the input
+ */
+static bool next_input_event(EventPipeline_t* pipeline, TraceMerge_t* trace_merge, Event_t* event, long* next_offset) {
+    if (trace_merge != NULL) {
+        *next_offset = 0;
+        return next_merged_event(trace_merge, event);
+    }
+    return next_pipeline_event(pipeline, event, next_offset);
+}
+
+/**
+ * @brief Runs the simulator over the input file on several threads and prints the analytics
+ * @param simulator: the configured simulator, which has not handled any event
+ * @param input: the input file, positioned at the first event
+ * @param trace_path: path of the input file
+ * @param thread_count: number of threads
+ * @return the exit status
+ */
+static int run_parallel_simulation(Procsim_t* simulator, FILE* input, const char* trace_path, int thread_count) {
+    Procsim_Status status;
+    Event_t rejected_event;
+    ParallelRunStats_t parallel_stats;
+    simulator = run_parallel(simulator, input, trace_path, thread_count, &status, &rejected_event, &parallel_stats);
+    fclose(input);
+    if (status != PROCSIM_OK) {
+        fprintf(stderr, "ERROR: Rejected event at time %lld: %s\n", rejected_event.time, procsim_get_status_message(status));
+        procsim_destroy(simulator);
+        return 1;
+    }
+
+    // Analytics outputs
+    ProcsimStats_t stats;
+    procsim_get_stats(simulator, &stats);
+    printf("\nSimulation ended at time: %lld\n", stats.last_event_time);
+    printf("System idle time: %lld\n\n", stats.idle_time);
+    print_process_summaries(simulator);
+    print_io_device_summaries(simulator);
+    print_parallel_run_summary(&parallel_stats);
+
+    procsim_destroy(simulator);
+    return 0;
+}
 
 /**
  * @brief Program entry procedure for the process scheduler simulation
  */
 int main(int argc, char* argv[]) {
 
-    if(argc != 2) {
-        printf("Usage: procsim param_file\n");
+    // The library hands back the errors it cannot recover from
+    procsim_set_fatal_handler(&handle_fatal_error);
+
+    // Read the command line options
+    DeviceOption_t device_options[IO_DEVICE_COUNT] = {{false, IO_FIFO, 0}};
+    SchedulerOption_t scheduler_option = {false, SCHEDULE_FIFO, DEFAULT_INITIAL_BURST, DEFAULT_BURST_ALPHA, false, {0, 0, 0}, {{0, 0}}, 0};
+    const char* checkpoint_path = NULL;
+    const char* resume_path = NULL;
+    Procsim_Time checkpoint_time = -1;
+    long checkpoint_interval = 0;
+    bool build_index = false;
+    const char* index_path = NULL;
+    long index_stride = DEFAULT_INDEX_STRIDE;
+    bool has_window = false;
+    Procsim_Time window_start = 0;
+    Procsim_Time window_end = 0;
+    bool pipelined = false;
+    int pipeline_batch_size = DEFAULT_PIPELINE_BATCH_SIZE;
+    bool async_log = false;
+    Log_Backpressure log_backpressure = LOG_BLOCK;
+    const char* binary_log_path = NULL;
+    const char* chrome_trace_path = NULL;
+    const char* samples_path = NULL;
+    Procsim_Time sample_interval = 100;
+    bool samples_binary = false;
+    Procsim_Time what_if_time = -1;
+    bool daemon_mode = false;
+    const char* stats_socket_path = NULL;
+    int parallel_threads = 0;
+    bool merge_input = false;
+    bool decompress_thread = false;
+    long sort_run_size = DEFAULT_SORT_RUN_SIZE;
+    int ready_spill_limit = 0;
+    bool adaptive_queue = false;
+    const struct option long_options[] = {
+        {"checkpoint", required_argument, NULL, 'c'},
+        {"checkpoint-at", required_argument, NULL, 't'},
+        {"checkpoint-every", required_argument, NULL, 'n'},
+        {"resume", required_argument, NULL, 'r'},
+        {"build-index", no_argument, NULL, 'b'},
+        {"index", required_argument, NULL, 'i'},
+        {"index-stride", required_argument, NULL, 's'},
+        {"window", required_argument, NULL, 'w'},
+        {"pipeline", no_argument, NULL, 'p'},
+        {"pipeline-batch", required_argument, NULL, 'B'},
+        {"parallel", required_argument, NULL, 'j'},
+        {"merge", no_argument, NULL, 'm'},
+        {"decompress-thread", no_argument, NULL, 'Z'},
+        {"sort-run", required_argument, NULL, 'R'},
+        {"async-log", no_argument, NULL, 'a'},
+        {"log-backpressure", required_argument, NULL, 'L'},
+        {"binary-log", required_argument, NULL, 'o'},
+        {"chrome-trace", required_argument, NULL, 'T'},
+        {"samples", required_argument, NULL, 'S'},
+        {"sample-every", required_argument, NULL, 'N'},
+        {"samples-binary", no_argument, NULL, 'Y'},
+        {"what-if", required_argument, NULL, 'W'},
+        {"daemon", no_argument, NULL, 'D'},
+        {"stats-socket", required_argument, NULL, 'u'},
+        {"scheduler", required_argument, NULL, 'P'},
+        {"burst-prediction", required_argument, NULL, 'E'},
+        {"switch-costs", required_argument, NULL, 'C'},
+        {"group-weight", required_argument, NULL, 'G'},
+        {"ready-spill", required_argument, NULL, 'M'},
+        {"adaptive-queue", no_argument, NULL, 'A'},
+        {NULL, 0, NULL, 0}
+    };
+    int option;
+    while ((option = getopt_long(argc, argv, "d:q:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 'd':
+                if (configure_io_device(optarg, device_options) != 0) {
+                    return 1;
+                }
+                break;
+            case 'q':
+                if (configure_io_queue_depth(optarg, device_options) != 0) {
+                    return 1;
+                }
+                break;
+            case 'c':
+                checkpoint_path = optarg;
+                break;
+            case 't':
+                checkpoint_time = atoll(optarg);
+                break;
+            case 'n':
+                checkpoint_interval = atol(optarg);
+                break;
+            case 'r':
+                resume_path = optarg;
+                break;
+            case 'b':
+                build_index = true;
+                break;
+            case 'i':
+                index_path = optarg;
+                break;
+            case 's':
+                index_stride = atol(optarg);
+                break;
+            case 'w':
+                if (sscanf(optarg, "%lld:%lld", &window_start, &window_end) != 2 || window_end < window_start) {
+                    fprintf(stderr, "ERROR: Invalid window: %s\n", optarg);
+                    return 1;
+                }
+                has_window = true;
+                break;
+            case 'p':
+                pipelined = true;
+                break;
+            case 'B':
+                pipeline_batch_size = atoi(optarg);
+                break;
+            case 'j':
+                parallel_threads = atoi(optarg);
+                if (parallel_threads < 1 || parallel_threads > MAX_PARALLEL_THREADS) {
+                    fprintf(stderr, "ERROR: Invalid thread count: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'm':
+                merge_input = true;
+                break;
+            case 'R':
+                sort_run_size = atol(optarg);
+                break;
+            case 'Z':
+                decompress_thread = true;
+                break;
+            case 'a':
+                async_log = true;
+                break;
+            case 'L':
+                if (!parse_log_backpressure(optarg, &log_backpressure)) {
+                    fprintf(stderr, "ERROR: Invalid log backpressure: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'o':
+                binary_log_path = optarg;
+                break;
+            case 'T':
+                chrome_trace_path = optarg;
+                break;
+            case 'S':
+                samples_path = optarg;
+                break;
+            case 'N':
+                sample_interval = atoll(optarg);
+                break;
+            case 'Y':
+                samples_binary = true;
+                break;
+            case 'W':
+                what_if_time = atoll(optarg);
+                break;
+            case 'D':
+                daemon_mode = true;
+                break;
+            case 'u':
+                stats_socket_path = optarg;
+                break;
+            case 'P':
+                if (!parse_scheduling_policy(optarg, &scheduler_option.policy)) {
+                    fprintf(stderr, "ERROR: Invalid scheduler: %s\n", optarg);
+                    return 1;
+                }
+                scheduler_option.has_policy = true;
+                break;
+            case 'E':
+                if (configure_burst_prediction(optarg, &scheduler_option) != 0) {
+                    return 1;
+                }
+                break;
+            case 'C':
+                if (configure_switch_costs(optarg, &scheduler_option) != 0) {
+                    return 1;
+                }
+                break;
+            case 'G':
+                if (configure_group_weight(optarg, &scheduler_option) != 0) {
+                    return 1;
+                }
+                break;
+            case 'M':
+                ready_spill_limit = atoi(optarg);
+                if (ready_spill_limit < 2) {
+                    fprintf(stderr, "ERROR: Invalid ready spill limit: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'A':
+                adaptive_queue = true;
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+
+    if(argc - optind < 1 || (!merge_input && argc - optind != 1) || sort_run_size < 1 || (checkpoint_path == NULL && (checkpoint_time >= 0 || checkpoint_interval > 0))
+       || index_stride < 1 || sample_interval < 1 || pipeline_batch_size < 1 || pipeline_batch_size > EVENT_RING_CAPACITY / 2) {
+        print_usage();
         return 1;
     }
+    const char* trace_path = argv[optind];
 
-    // Initialize I/O Devices
-    IO_Device_t io_devices[10];
-    for (int i = 0; i < 10; i++) {
-        initialize_io_device(&io_devices[i], i);
+    if (daemon_mode) {
+        // A live stream cannot be indexed, sought in or replayed
+        if (resume_path != NULL || checkpoint_path != NULL || build_index || has_window || pipelined
+            || samples_path != NULL || what_if_time >= 0 || parallel_threads > 0 || merge_input || ready_spill_limit > 0 || adaptive_queue) {
+            fprintf(stderr, "ERROR: --daemon only combines with -d, -q, --stats-socket, --scheduler, "
+                    "--burst-prediction, --switch-costs, --group-weight, --async-log, --log-backpressure, --binary-log and "
+                    "--chrome-trace\n");
+            return 1;
+        }
+        return serve_daemon(trace_path, stats_socket_path, &scheduler_option, device_options, async_log, log_backpressure,
+                            binary_log_path, chrome_trace_path);
+    }
+    if (stats_socket_path != NULL) {
+        print_usage();
+        return 1;
+    }
+    if (parallel_threads > 0) {
+        // Segments are cut by file offset and their event lines printed once committed, so the run
+        // can neither be saved, sought in nor tapped by another sink
+        if (resume_path != NULL || checkpoint_path != NULL || has_window || pipelined || async_log
+            || binary_log_path != NULL || chrome_trace_path != NULL || samples_path != NULL || what_if_time >= 0
+            || ready_spill_limit > 0 || adaptive_queue) {
+            fprintf(stderr, "ERROR: --parallel only combines with -d, -q, --scheduler, --burst-prediction, "
+                    "--switch-costs and --group-weight\n");
+            return 1;
+        }
+#ifdef PROCSIM_INSTRUMENT
+        // The instrumentation counters are shared by every thread
+        fprintf(stderr, "ERROR: --parallel is not available in instrumented builds\n");
+        return 1;
+#endif
+    }
+    if (merge_input && (resume_path != NULL || checkpoint_path != NULL || build_index || has_window || pipelined
+                        || parallel_threads > 0)) {
+        // A merged stream has no single file offset to save, index or cut at
+        fprintf(stderr, "ERROR: --merge cannot be combined with checkpoints, --resume, the time index, --window, "
+                "--pipeline or --parallel\n");
+        return 1;
     }
 
-    FILE* input = fopen(argv[1], "r");
+    if (ready_spill_limit > 0 && (resume_path != NULL || checkpoint_path != NULL || what_if_time >= 0)) {
+        // A snapshot saves the ready queue from memory, not the processes in the scratch file, and
+        // a branch brings every spilled process back into memory
+        fprintf(stderr, "ERROR: --ready-spill cannot be combined with checkpoints, --resume or --what-if\n");
+        return 1;
+    }
+    if (adaptive_queue && (resume_path != NULL || checkpoint_path != NULL || ready_spill_limit > 0)) {
+        // A snapshot saves the ready queue list, not the processes held by another backend
+        fprintf(stderr, "ERROR: --adaptive-queue cannot be combined with checkpoints, --resume or --ready-spill\n");
+        return 1;
+    }
 
-    // Read in the simulation parameters
-    int preemptive_scheduler;
-    fscanf(input, "%d", &preemptive_scheduler);
-    printf("Simulation Starting. Preemption: %s\n\n", preemptive_scheduler == 1 ? "true" : "false");
+    // A compressed input file is read as a stream, which cannot be sought in
+    Input_Compression compression = merge_input ? INPUT_PLAIN : detect_input_compression(trace_path);
+    if (compression != INPUT_PLAIN) {
+        if (!is_compression_supported(compression)) {
+            fprintf(stderr, "ERROR: %s is %s compressed, which needs a build with make ZSTD=1\n", trace_path,
+                    get_compression_name(compression));
+            return 1;
+        }
+        if (resume_path != NULL || checkpoint_path != NULL || build_index || has_window || parallel_threads > 0) {
+            fprintf(stderr, "ERROR: A compressed input file cannot be combined with checkpoints, --resume, the time index, "
+                    "--window or --parallel\n");
+            return 1;
+        }
+    }
 
-    // Read each event
-    int event_time;
-    int operation_code;
-    int priority;
-    int io_device;
-
-    // PID tracker instantiates process at 1 and iterates up as processes are added
-    int PID_tracker = 1;
-
-    // Instantiate and initialize scheduler handler. Specifics of its functions are defined in
-    // non_preempting_handler.c and preempting_handler.c
-    SchedulerHandler scheduler_handler;
-    initialize_scheduler_handler(&scheduler_handler, io_devices, &preemptive_scheduler);
-
-    // Linked list to track process analytics
-    LL_Node* process_analytics_data = NULL;
-
-    // Process events (shared logic)
-    while (fscanf(input, "%d %d", &event_time, &operation_code) == 2) {
-        switch (operation_code) {
-            case 1: {
-                // Handle process start
-                fscanf(input, "%d", &priority);
-                scheduler_handler.handle_process_start(&scheduler_handler, priority, &PID_tracker, &event_time);
-                break;
+    // The time index sits next to the input file unless told otherwise
+    char default_index_path[strlen(trace_path) + 5];
+    snprintf(default_index_path, sizeof(default_index_path), "%s.idx", trace_path);
+    if (index_path == NULL) {
+        index_path = default_index_path;
+    }
+
+    if (build_index) {
+        TraceIndex_t trace_index;
+        if (!build_trace_index(trace_path, index_path, index_stride, &trace_index)) {
+            fprintf(stderr, "ERROR: Could not build index %s\n", index_path);
+            return 1;
+        }
+        printf("Indexed %ld events into %d entries: %s\n", trace_index.total_events, trace_index.size, index_path);
+        free_trace_index(&trace_index);
+        return 0;
+    }
+
+    // With an up to date index, reading stops at the first indexed event past the window
+    // instead of parsing the rest of the file
+    long window_stop_offset = -1;
+    if (has_window) {
+        TraceIndex_t trace_index;
+        if (load_trace_index(trace_path, index_path, &trace_index)) {
+            const IndexEntry_t* stop_entry = find_index_entry_after(&trace_index, window_end);
+            if (stop_entry != NULL) {
+                window_stop_offset = stop_entry->offset;
             }
-            case 2: {
-                // Handle I/O request
-                fscanf(input, "%d", &io_device);
-                scheduler_handler.handle_io_request(&scheduler_handler, &scheduler_handler.io_devices[io_device], &event_time);
+            free_trace_index(&trace_index);
+        }
+    }
+
+    // Shards are merged into one stream instead of reading a single input file, and a compressed
+    // input file is decompressed on the fly
+    FILE* input = NULL;
+    TraceMerge_t trace_merge;
+    int merge_scheduler = 0;
+    CompressedInput_t compressed_input;
+    if (merge_input) {
+        if (!open_trace_merge(&trace_merge, &argv[optind], argc - optind, sort_run_size, &merge_scheduler)) {
+            fprintf(stderr, "ERROR: Could not open or sort the shard files\n");
+            return 1;
+        }
+    } else if (compression != INPUT_PLAIN) {
+        if (!open_compressed_input(&compressed_input, trace_path, compression, decompress_thread)) {
+            fprintf(stderr, "ERROR: Could not open %s\n", trace_path);
+            return 1;
+        }
+    } else {
+        input = fopen(trace_path, "r");
+        if (input == NULL) {
+            fprintf(stderr, "ERROR: Could not open %s\n", trace_path);
+            return 1;
+        }
+    }
+
+    // Read each event
+    Event_t event = {0, 0, 0, 0};
+    long events_processed = 0;
+
+    // The simulator owns the scheduler, devices and PCB's. Its handlers are defined in
+    // non_preempting_handler.c, preempting_handler.c, shortest_job_handler.c and fair_share_handler.c
+    Procsim_t* simulator;
+
+    // Everything a snapshot saves or restores
+    SnapshotState_t snapshot_state = {0, 0, 0, NULL};
+
+    if (resume_path != NULL) {
+        // Continue a saved run from the event after the snapshot, which brings its own scheduler
+        simulator = create_simulator(SCHEDULE_FIFO, &scheduler_option, device_options);
+        snapshot_state.simulator = simulator;
+        if (!load_snapshot(resume_path, &snapshot_state)) {
+            fprintf(stderr, "ERROR: Could not restore snapshot %s\n", resume_path);
+            return 1;
+        }
+        event.time = snapshot_state.event_time;
+        events_processed = snapshot_state.events_processed;
+        fseek(input, snapshot_state.input_offset, SEEK_SET);
+    } else {
+        // Read in the simulation parameters
+        int scheduler = merge_scheduler;
+        char parameters[128];
+        if (input != NULL) {
+            fscanf(input, "%d", &scheduler);
+        } else if (compression != INPUT_PLAIN && read_compressed_line(&compressed_input, parameters, sizeof(parameters))) {
+            sscanf(parameters, "%d", &scheduler);
+        }
+        Scheduling_Policy policy = start_scheduling_policy(scheduler, &scheduler_option);
+        simulator = create_simulator(policy, &scheduler_option, device_options);
+        snapshot_state.simulator = simulator;
+    }
+    // The scratch file of --ready-spill is removed once it is closed
+    FILE* spill_file = NULL;
+    if (ready_spill_limit > 0) {
+        if (procsim_get_scheduling_policy(simulator) != SCHEDULE_PRIORITY) {
+            fprintf(stderr, "ERROR: --ready-spill needs the priority scheduler\n");
+            return 1;
+        }
+        spill_file = tmpfile();
+        if (spill_file == NULL || !procsim_set_ready_spill(simulator, ready_spill_limit, fileno(spill_file))) {
+            fprintf(stderr, "ERROR: Could not create the scratch file of --ready-spill\n");
+            return 1;
+        }
+    }
+    if (adaptive_queue) {
+        if (procsim_get_scheduling_policy(simulator) != SCHEDULE_PRIORITY) {
+            fprintf(stderr, "ERROR: --adaptive-queue needs the priority scheduler\n");
+            return 1;
+        }
+        procsim_set_adaptive_ready_queue(simulator, &handle_queue_switch, NULL);
+    }
+    if (parallel_threads > 0) {
+        return run_parallel_simulation(simulator, input, trace_path, parallel_threads);
+    }
+
+    // Scheduling events go through the log sink, as event lines or as a binary log. The writer
+    // thread of --async-log writes to stdout directly, so everything printed so far is flushed first
+    FILE* binary_log = NULL;
+    if (binary_log_path != NULL) {
+        binary_log = fopen(binary_log_path, "wb");
+        if (binary_log == NULL) {
+            fprintf(stderr, "ERROR: Could not open %s\n", binary_log_path);
+            return 1;
+        }
+        setvbuf(binary_log, NULL, _IOFBF, LOG_WRITE_BUFFER_SIZE);
+    }
+    LogSink_t log_sink;
+    fflush(stdout);
+    start_log_sink(&log_sink, async_log, log_backpressure, binary_log);
+    OutputSinks_t output_sinks = {&log_sink, NULL};
+
+    ChromeTrace_t chrome_trace;
+    if (chrome_trace_path != NULL) {
+        if (!open_chrome_trace(&chrome_trace, chrome_trace_path)) {
+            fprintf(stderr, "ERROR: Could not open %s\n", chrome_trace_path);
+            return 1;
+        }
+        output_sinks.chrome_trace = &chrome_trace;
+    }
+    procsim_set_record_callback(simulator, &handle_record, &output_sinks);
+
+    TimeSeries_t time_series;
+    if (samples_path != NULL && !open_time_series(&time_series, samples_path, samples_binary, sample_interval,
+                                                  simulator, event.time)) {
+        fprintf(stderr, "ERROR: Could not open %s\n", samples_path);
+        return 1;
+    }
+
+    // Process events (shared logic). With --pipeline a parser thread reads ahead of the loop
+    long event_offset = 0;
+    EventPipeline_t pipeline;
+    if (input != NULL) {
+        event_offset = ftell(input);
+        start_event_pipeline(&pipeline, input, NULL, window_stop_offset, pipelined, pipeline_batch_size);
+    } else if (compression != INPUT_PLAIN) {
+        start_event_pipeline(&pipeline, NULL, &compressed_input, -1, pipelined, pipeline_batch_size);
+    }
+    long next_offset;
+    Procsim_Time last_event_time = event.time;
+    bool rejected = false;
+    Procsim_t* branch = NULL;
+    Procsim_Time branch_time = 0;
+    bool branch_stopped = false;
+    Event_t run[PROCSIM_START_BATCH_SIZE];
+    bool held = false;
+    while (held || next_input_event(&pipeline, merge_input ? &trace_merge : NULL, &event, &next_offset)) {
+        // Process starts at the same time are read ahead into one run, which the simulator
+        // handles in one step. A run never crosses a checkpoint interval
+        held = false;
+        int run_length = 1;
+        long run_offset = next_offset;
+        run[0] = event;
+        while (event.operation_code == 1 && run_length < PROCSIM_START_BATCH_SIZE
+               && (checkpoint_interval == 0 || (events_processed + run_length) % checkpoint_interval != 0)
+               && next_input_event(&pipeline, merge_input ? &trace_merge : NULL, &event, &next_offset)) {
+            if (event.operation_code != 1 || event.time != run[0].time) {
+                held = true;
                 break;
             }
-            case 3: {
-                // Handle I/O request complete
-                fscanf(input, "%d", &io_device);
-                scheduler_handler.handle_io_complete(&scheduler_handler, &scheduler_handler.io_devices[io_device], &event_time);
+            run[run_length++] = event;
+            run_offset = next_offset;
+        }
+        Procsim_Time run_time = run[0].time;
+
+        if (has_window) {
+            // Fast-forward without printing until the window starts, stop once it ends
+            if (run_time > window_end) {
                 break;
             }
+            procsim_set_reporting(simulator, run_time >= window_start);
+        }
 
-            case 4: {
-                // Handle process end
-                PCB_t ended_process = scheduler_handler.handle_process_end(&scheduler_handler, &event_time);
-                append_to_linked_list(&process_analytics_data, ended_process);
-                break;
+        if (checkpoint_time >= 0 && run_time > checkpoint_time && last_event_time <= checkpoint_time) {
+            // Save the run as it was before this event
+            snapshot_state.input_offset = event_offset;
+            snapshot_state.event_time = last_event_time;
+            snapshot_state.events_processed = events_processed;
+            write_checkpoint(checkpoint_path, &snapshot_state);
+        }
+
+        if (samples_path != NULL) {
+            advance_time_series(&time_series, run_time);
+        }
+
+        if (what_if_time >= 0 && branch == NULL && run_time > what_if_time) {
+            // The shared prefix ends here, the branch finishes the trace silently on the other scheduler
+            branch = procsim_fork(simulator);
+            branch_time = last_event_time;
+            procsim_set_record_callback(branch, NULL, NULL);
+            procsim_set_scheduling_policy(branch, get_counterpart_policy(procsim_get_scheduling_policy(simulator)));
+        }
+        if (branch != NULL && !branch_stopped) {
+            Procsim_Status branch_status;
+            procsim_submit_events(branch, run, run_length, &branch_status);
+            if (branch_status != PROCSIM_OK) {
+                // A trace naming specific processes can stop making sense once scheduling diverges
+                fprintf(stderr, "ERROR: Branch rejected event at time %lld: %s\n", run_time,
+                        procsim_get_status_message(branch_status));
+                branch_stopped = true;
             }
+        }
 
-            default: break;
+        Procsim_Status status;
+        long handled = procsim_submit_events(simulator, run, run_length, &status);
+        events_processed += handled;
+        if (status != PROCSIM_OK) {
+            fprintf(stderr, "ERROR: Rejected event at time %lld: %s\n", run_time, procsim_get_status_message(status));
+            rejected = true;
+            break;
+        }
+
+        if (samples_path != NULL) {
+            update_time_series(&time_series, simulator);
+        }
+
+        event_offset = run_offset;
+        last_event_time = run_time;
+
+        if (checkpoint_interval > 0 && events_processed % checkpoint_interval == 0) {
+            snapshot_state.input_offset = event_offset;
+            snapshot_state.event_time = run_time;
+            snapshot_state.events_processed = events_processed;
+            write_checkpoint(checkpoint_path, &snapshot_state);
         }
     }
 
-    fclose(input);
+    if (input != NULL) {
+        stop_event_pipeline(&pipeline);
+        fclose(input);
+    } else if (compression != INPUT_PLAIN) {
+        stop_event_pipeline(&pipeline);
+        close_compressed_input(&compressed_input);
+        if (compressed_input.failed && !rejected) {
+            fprintf(stderr, "ERROR: %s is corrupt or cut short\n", trace_path);
+            rejected = true;
+        }
+    } else {
+        close_trace_merge(&trace_merge);
+    }
+    stop_log_sink(&log_sink);
+    if (binary_log != NULL) {
+        fclose(binary_log);
+    }
+    if (chrome_trace_path != NULL && !close_chrome_trace(&chrome_trace, last_event_time)) {
+        fprintf(stderr, "ERROR: Could not write %s\n", chrome_trace_path);
+    }
+    if (samples_path != NULL && !close_time_series(&time_series, last_event_time)) {
+        fprintf(stderr, "ERROR: Could not write %s\n", samples_path);
+    }
+    if (rejected) {
+        if (branch != NULL) {
+            procsim_destroy(branch);
+        }
+        procsim_destroy(simulator);
+        if (spill_file != NULL) {
+            fclose(spill_file);
+        }
+        return 1;
+    }
 
     // Analytics outputs
-    printf("\nSimulation ended at time: %d\n", event_time);
-    printf("System idle time: %d\n\n", scheduler_handler.total_idle_time);
-    print_list(process_analytics_data);
+    ProcsimStats_t stats;
+    procsim_get_stats(simulator, &stats);
+    printf("\nSimulation ended at time: %lld\n", last_event_time);
+    printf("System idle time: %lld\n\n", stats.idle_time);
+    print_process_summaries(simulator);
+
+    // Per-device analytics are only reported for devices configured on the command line
+    print_io_device_summaries(simulator);
+    if (branch != NULL) {
+        print_branch_comparison(simulator, branch, branch_time);
+    }
+    if (pipelined) {
+        print_pipeline_summary(&pipeline);
+    }
+    if (merge_input) {
+        print_trace_merge_summary(&trace_merge);
+    }
+    if (compression != INPUT_PLAIN && decompress_thread) {
+        print_compressed_input_summary(&compressed_input);
+    }
+    if (async_log) {
+        print_log_sink_summary(&log_sink);
+    }
+    print_ready_spill_summary(simulator);
+    print_ready_queue_summary(simulator);
+    INSTRUMENT_REPORT();
 
     // Memory management
-    free_scheduler_handler(&scheduler_handler, &preemptive_scheduler);
-    free_list(process_analytics_data);
+    if (branch != NULL) {
+        procsim_destroy(branch);
+    }
+    procsim_destroy(simulator);
+    if (spill_file != NULL) {
+        fclose(spill_file);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -13,32 +13,37 @@
 #include "queue.h"
 #include "io_device.h"
 #include "PCB.h"
+#include "pcb_store.h"
 
 /**
 * @brief Handles the event of starting of a process using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param priority: a new processes priority
+* @param group: the process group of the new process
 * @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
 * @param current_time: reference to the current time, used for analytics marking events
 */
-void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int* PID_tracker, int* current_time){
+void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time){
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
 	// Create a new PCB for the new process
-	PCB_t* new_process = (PCB_t*)malloc(sizeof(PCB_t));  // Dynamically allocate memory
-	initialize_PCB(new_process);
+	PCB_t* new_process = allocate_pcb(store);
 	new_process->priority = priority;
 	new_process->PID = *PID_tracker;
+	assign_process_group(store, new_process, group);
 
 	// Iterate the PID tracker so new processes get new ID's
 	(*PID_tracker)++;
 
-	printf("%d: Starting process with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+	log_event(schedulerHandler, LOG_PROCESS_STARTED, *current_time, new_process, NULL);
 
 	// Add the new process to the queue. If no process is currently active, assign straight to CPU
 	if (schedulerHandler->CPU == NULL){
 		// No process is currently running in the CPU, assign new process to CPU
 		new_process->state = RUNNING;
 		schedulerHandler->CPU = new_process;
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// System Analytics
 		schedulerHandler->end_idle_time = *current_time;
@@ -47,9 +52,10 @@ void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priori
 		// CPU is currently occupied, add to queue
 		new_process->state = READY;
 		enqueue_queue(schedulerHandler->queue, new_process);
+		log_event(schedulerHandler, LOG_PROCESS_READY, *current_time, new_process, NULL);
 
 		// Process analytics
-		new_process->start_ready_time = *current_time;
+		store->start_ready_time[new_process->slot] = *current_time;
 	}
 }
 
@@ -57,17 +63,24 @@ void non_preemptive_process_start(SchedulerHandler* schedulerHandler, int priori
 * @brief Handles the event where an active process requests an I/O device using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
 * @param current_time: reference to the current time, used for analytics marking events
 */
-void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t *io_device, int* current_time){
+void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time){
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
 	// Send the current PCB to the desired I/O device
 	PCB_t* io_requested_process = schedulerHandler->CPU;
 	io_requested_process->state = BLOCKED;
-	printf("%d: Process with PID: %d waiting for I/O device %d\n", *current_time, io_requested_process->PID, io_device->id);
-	add_io_request(io_device, io_requested_process);
+	io_requested_process->target_io_device = io_device->id;
+	io_requested_process->target_sector = sector;
 
 	// Process analytics
-	io_requested_process->start_io_blocked_time = *current_time;
+	store->start_io_blocked_time[io_requested_process->slot] = *current_time;
+
+	add_io_request(io_device, io_requested_process, *current_time);
+	log_event(schedulerHandler, LOG_IO_WAITING, *current_time, io_requested_process, io_device);
+	charge_switch_out(store, io_requested_process, false);
 
 	// CPU next process logic
 	if (get_size_queue(schedulerHandler->queue) > 0){
@@ -76,11 +89,11 @@ void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t *
 		new_process->state = RUNNING;
 
 		schedulerHandler->CPU = new_process;  // Assign the new process to the CPU
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// Process analytics
-		new_process->end_ready_time = *current_time;
-		new_process->total_ready_time += new_process->end_ready_time - new_process->start_ready_time;
+		store->total_ready_time[new_process->slot] += *current_time - store->start_ready_time[new_process->slot];
 	} else {
 		// If there are no processes in the queue, the CPU goes idle
 		schedulerHandler->CPU = NULL;
@@ -94,25 +107,35 @@ void non_preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t *
 * @brief Handles the event where an I/O device completes its tasks using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
 * @param current_time: reference to the current time, used for analytics marking events
 */
-void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t *io_device, int* current_time){
-	// Remove the processes from the I/O device
-	int io_device_queue_size = io_device->queue.size + 1;
-	PCB_t* io_processes[io_device_queue_size];
-	// Dump all processes into the temp array
-	for (int i = 0; i < io_device_queue_size; i++) {
-		io_processes[i] = complete_current_io_operation(io_device);
+void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time){
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Remove the processes from the I/O device. Submitted events always release one, but a
+	// completion with nothing to release leaves everything as it was
+	int request_count = get_io_request_count(io_device);
+	if (request_count == 0) {
+		return;
+	}
+	PCB_t* stack_processes[HANDLER_STACK_PROCESSES];
+	PCB_t** io_processes = get_process_buffer(stack_processes, request_count);
+	int io_device_queue_size = release_io_requests(io_device, PID, *current_time, io_processes);
+	if (io_device_queue_size == 0) {
+		release_process_buffer(io_processes, stack_processes);
+		return;
 	}
 
 	// Process analytics
 	for (int i = 0; i < io_device_queue_size; i++) {
-		io_processes[i]->end_io_blocked_time = *current_time;
-		io_processes[i]->total_io_blocked_time += io_processes[i]->end_io_blocked_time - io_processes[i]->start_io_blocked_time;
+		store->total_io_blocked_time[io_processes[i]->slot] += *current_time - store->start_io_blocked_time[io_processes[i]->slot];
+		log_event(schedulerHandler, LOG_IO_RELEASED, *current_time, io_processes[i], io_device);
 	}
 
 	// Print IO completed for this device
-	printf("%d: I/O completed for I/O device %d\n", *current_time, io_device->id);
+	log_event(schedulerHandler, LOG_IO_COMPLETED, *current_time, NULL, io_device);
+	charge_io_interrupt(store);
 
 	// CPU next process logic
 	if (schedulerHandler->CPU == NULL){
@@ -120,13 +143,15 @@ void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t
 		// and the rest to the queue
 		io_processes[0]->state = RUNNING;
 		schedulerHandler->CPU = io_processes[0];
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, io_processes[0]->PID, io_processes[0]->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, io_processes[0], NULL);
+		charge_dispatch(store);
 
 		// Queue remaining processes
 		for (int i = 1; i < io_device_queue_size; i++) {
 			io_processes[i]->state = READY;
-			io_processes[i]->start_ready_time = *current_time;
+			store->start_ready_time[io_processes[i]->slot] = *current_time;
 			enqueue_queue(schedulerHandler->queue, io_processes[i]);
+			log_event(schedulerHandler, LOG_PROCESS_READY, *current_time, io_processes[i], NULL);
 		}
 
 		// System analytics
@@ -136,24 +161,27 @@ void non_preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t
 		// If there is a process currently running in the CPU, send all processes to the queue
 		for (int i = 0; i < io_device_queue_size; i++) {
 			io_processes[i]->state = READY;
-			io_processes[i]->start_ready_time = *current_time;
+			store->start_ready_time[io_processes[i]->slot] = *current_time;
 			enqueue_queue(schedulerHandler->queue, io_processes[i]);
+			log_event(schedulerHandler, LOG_PROCESS_READY, *current_time, io_processes[i], NULL);
 		}
 	}
+	release_process_buffer(io_processes, stack_processes);
 }
 
 /**
 * @brief Handles the event where an active process terminates using non-preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param current_time: reference to the current time, used for analytics marking events
-* @return a copy of the completed process
 */
-PCB_t non_preemptive_process_end(SchedulerHandler* schedulerHandler, int* current_time){
-	// Retrieve and free memory of current process
+void non_preemptive_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time){
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Retrieve the current process and record it in the completed process analytics
 	PCB_t* ended_process = schedulerHandler->CPU;
-	const PCB_t temp = *ended_process;
-	printf("%d: Ending process with PID: %d\n", *current_time, ended_process->PID);
-	free(ended_process);
+	log_event(schedulerHandler, LOG_PROCESS_ENDED, *current_time, ended_process, NULL);
+	charge_switch_out(store, ended_process, false);
+	complete_pcb(store, ended_process);
 
 	// CPU next process logic
 	if (get_size_queue(schedulerHandler->queue) > 0){
@@ -162,11 +190,11 @@ PCB_t non_preemptive_process_end(SchedulerHandler* schedulerHandler, int* curren
 		new_process->state = RUNNING;
 
 		schedulerHandler->CPU = new_process;  // Assign the new process to the CPU
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// Process analytics
-		new_process->end_ready_time = *current_time;
-		new_process->total_ready_time += new_process->end_ready_time - new_process->start_ready_time;
+		store->total_ready_time[new_process->slot] += *current_time - store->start_ready_time[new_process->slot];
 	} else {
 		// If there are no processes in the queue, the CPU goes idle
 		schedulerHandler->CPU = NULL;
@@ -174,6 +202,4 @@ PCB_t non_preemptive_process_end(SchedulerHandler* schedulerHandler, int* curren
 		// System analytics
 		schedulerHandler->start_idle_time = *current_time;
 	}
-
-	return temp;
 }
\ No newline at end of file
@@ -0,0 +1,481 @@
+/**
+ * @file parallel_run.c
+ * @brief Defines the parallel run. Every event goes through the one CPU, so the trace is split
+ *		  in time instead of by component: at an idle point only the PID counter, the idle
+ *		  start, the device heads and the fair-share virtual times carry over, and all of them
+ *		  can be guessed from a quick pass over the events before the cut
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "parallel_run.h"
+#include "event.h"
+#include "log_sink.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define EVENT_LINE_LENGTH 128
+#define SEGMENT_COPY_BUFFER_SIZE 65536
+
+/**
+* @struct TraceSummary_t
+* @brief Defines what the events up to a point tell about the simulator state at that point
+*/
+typedef struct trace_summary {
+	long starts;			// Op code 1 events
+	long ends;				// Op code 4 events
+	bool has_event;
+	Procsim_Time last_event_time;
+	bool has_end;
+	Procsim_Time last_end_time;	// The CPU went idle at the last process end
+	int device_count;
+	int* head_sectors;		// Sector of the last request on each device
+	bool* has_head_sector;
+} TraceSummary_t;
+
+/**
+* @struct Segment_t
+* @brief Defines one segment of the trace and the thread that simulates it
+*/
+typedef struct segment {
+	int index;
+	const char* trace_path;
+	long range_start;		// Offset the byte range of the segment starts at
+	long range_end;			// Offset the next range starts at, -1 for the last range
+	TraceSummary_t range_summary;	// Events of the range, filled in by the first pass
+	TraceSummary_t guess;			// Events before the range, then before the cut
+	bool summarized;		// Whether the first pass read the range
+
+	// Speculative simulation, filled in by the thread of the segment
+	bool launched;
+	bool speculated;		// False if the segment could not be simulated in parallel
+	long cut_offset;		// Offset of the first event, -1 if the range holds no idle point
+	long stop_offset;		// Offset of the first event of the next segment
+	Procsim_t* simulator;
+	Procsim_t* start_state;	// Copy of the simulator as guessed at the cut
+	FILE* output;			// Event lines, printed once the segment is committed
+	long events;
+	Procsim_Status status;
+	Event_t rejected_event;
+	pthread_t thread;
+} Segment_t;
+
+/**
+* @brief Writes the event line of a scheduling event
+* @param record: the event
+* @param context: the FILE the line goes to
+*/
+static void write_record(const LogRecord_t* record, void* context) {
+	char line[LOG_MAX_LINE_LENGTH];
+	fwrite(line, 1, (size_t)format_log_record(record, line), (FILE*)context);
+}
+
+/**
+* @brief Initializes a summary to that of no events
+*/
+static void initialize_trace_summary(TraceSummary_t* summary, int device_count) {
+	summary->starts = 0;
+	summary->ends = 0;
+	summary->has_event = false;
+	summary->last_event_time = 0;
+	summary->has_end = false;
+	summary->last_end_time = 0;
+	summary->device_count = device_count;
+	summary->head_sectors = (int*)calloc(device_count > 0 ? device_count : 1, sizeof(int));
+	summary->has_head_sector = (bool*)calloc(device_count > 0 ? device_count : 1, sizeof(bool));
+	if (!summary->head_sectors || !summary->has_head_sector) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+}
+
+/**
+* @brief Clears a summary from memory
+*/
+static void free_trace_summary(TraceSummary_t* summary) {
+	free(summary->head_sectors);
+	free(summary->has_head_sector);
+}
+
+/**
+* @brief Adds an event to a summary
+*/
+static void track_event(TraceSummary_t* summary, const Event_t* event) {
+	summary->has_event = true;
+	summary->last_event_time = event->time;
+	switch (event->operation_code) {
+		case 1:
+			summary->starts++;
+			break;
+		case 2:
+			if (event->argument >= 0 && event->argument < summary->device_count) {
+				summary->head_sectors[event->argument] = (int)event->extra;
+				summary->has_head_sector[event->argument] = true;
+			}
+			break;
+		case 4:
+			summary->ends++;
+			summary->has_end = true;
+			summary->last_end_time = event->time;
+			break;
+		default: break;
+	}
+}
+
+/**
+* @brief Adds the summary of the events that follow those of another summary
+*/
+static void add_trace_summary(TraceSummary_t* summary, const TraceSummary_t* later) {
+	summary->starts += later->starts;
+	summary->ends += later->ends;
+	if (later->has_event) {
+		summary->has_event = true;
+		summary->last_event_time = later->last_event_time;
+	}
+	if (later->has_end) {
+		summary->has_end = true;
+		summary->last_end_time = later->last_end_time;
+	}
+	for (int i = 0; i < summary->device_count; i++) {
+		if (later->has_head_sector[i]) {
+			summary->head_sectors[i] = later->head_sectors[i];
+			summary->has_head_sector[i] = true;
+		}
+	}
+}
+
+/**
+* @brief Reads the next event line, keeping track of the offset of every line
+* @param input: the input file
+* @param offset: offset of the next line, moved past the lines read
+* @param line_offset: filled in with the offset of the event line
+* @param event: filled in with the event
+* @return true if an event was read, false at the end of the file
+*/
+static bool next_event_line(FILE* input, long* offset, long* line_offset, Event_t* event) {
+	char line[EVENT_LINE_LENGTH];
+
+	while (fgets(line, sizeof(line), input) != NULL) {
+		*line_offset = *offset;
+		*offset += (long)strlen(line);
+		if (parse_event(line, event)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Opens the input file at the first line of the range of a segment. A range other than
+* the first starts at the first line that starts in it
+* @param segment: the segment
+* @param offset: filled in with the offset of that line
+* @return the input file, NULL if it could not be opened
+*/
+static FILE* open_range(const Segment_t* segment, long* offset) {
+	FILE* input = fopen(segment->trace_path, "r");
+	if (input == NULL) {
+		return NULL;
+	}
+	if (segment->index == 0 || segment->range_start == 0) {
+		fseek(input, segment->range_start, SEEK_SET);
+	} else {
+		fseek(input, segment->range_start - 1, SEEK_SET);
+		int character;
+		while ((character = fgetc(input)) != EOF && character != '\n') {
+		}
+	}
+	*offset = ftell(input);
+	return input;
+}
+
+/**
+* @brief First pass of a thread, summarizing the events of its range
+* @param argument: the Segment_t
+*/
+static void* summarize_range(void* argument) {
+	Segment_t* segment = (Segment_t*)argument;
+	long offset;
+	FILE* input = open_range(segment, &offset);
+	if (input == NULL) {
+		return NULL;
+	}
+
+	long line_offset;
+	Event_t event;
+	while (next_event_line(input, &offset, &line_offset, &event)
+		   && (segment->range_end < 0 || line_offset < segment->range_end)) {
+		track_event(&segment->range_summary, &event);
+	}
+	fclose(input);
+	segment->summarized = true;
+	return NULL;
+}
+
+/**
+* @brief Simulates events from an idle point up to the first idle point at or past the end of
+* a range, or up to the end of the file
+* @param simulator: the simulator, idle
+* @param input: the input file, positioned at the first event
+* @param offset: offset of the first event
+* @param range_end: offset the range ends at, -1 to simulate to the end of the file
+* @param status: filled in with PROCSIM_OK, or the status of the rejected event
+* @param rejected_event: filled in with the rejected event
+* @param stop_offset: filled in with the offset of the event simulation stopped at
+* @return the number of events handled
+*/
+static long simulate_range(Procsim_t* simulator, FILE* input, long offset, long range_end, Procsim_Status* status,
+						   Event_t* rejected_event, long* stop_offset) {
+	long open_processes = 0;
+	long events = 0;
+	long line_offset;
+	Event_t event;
+
+	*status = PROCSIM_OK;
+	while (next_event_line(input, &offset, &line_offset, &event)) {
+		if (range_end >= 0 && line_offset >= range_end && open_processes == 0) {
+			*stop_offset = line_offset;
+			return events;
+		}
+
+		*status = procsim_submit_event(simulator, &event);
+		if (*status != PROCSIM_OK) {
+			*rejected_event = event;
+			*stop_offset = line_offset;
+			return events;
+		}
+		events++;
+		if (event.operation_code == 1) {
+			open_processes++;
+		} else if (event.operation_code == 4) {
+			open_processes--;
+		}
+	}
+	*stop_offset = offset;
+	return events;
+}
+
+/**
+* @brief Second pass of a thread. Finds the first idle point of its range, sets its simulator
+* up as guessed from the events before it and simulates the segment into a temporary file
+* @param argument: the Segment_t
+*/
+static void* run_segment(void* argument) {
+	Segment_t* segment = (Segment_t*)argument;
+	long offset;
+	FILE* input = open_range(segment, &offset);
+	if (input == NULL) {
+		return NULL;
+	}
+
+	// The cut is the first event line with every process that started ended before it
+	TraceSummary_t* guess = &segment->guess;
+	long line_offset = -1;
+	Event_t event;
+	bool found = false;
+	while (next_event_line(input, &offset, &line_offset, &event)) {
+		if (guess->starts == guess->ends) {
+			found = true;
+			break;
+		}
+		track_event(guess, &event);
+	}
+	if (!found || (segment->range_end >= 0 && line_offset >= segment->range_end)) {
+		fclose(input);
+		segment->speculated = true;
+		return NULL;
+	}
+
+	segment->output = tmpfile();
+	if (segment->output == NULL) {
+		fclose(input);
+		return NULL;
+	}
+	procsim_start_idle_segment(segment->simulator, guess->starts + 1, guess->last_end_time, guess->last_event_time);
+	for (int i = 0; i < guess->device_count; i++) {
+		if (guess->has_head_sector[i]) {
+			procsim_set_device_head(segment->simulator, i, guess->head_sectors[i]);
+		}
+	}
+	segment->start_state = procsim_fork(segment->simulator);
+	procsim_set_record_callback(segment->simulator, &write_record, segment->output);
+
+	segment->cut_offset = line_offset;
+	fseek(input, line_offset, SEEK_SET);
+	segment->events = simulate_range(segment->simulator, input, line_offset, segment->range_end, &segment->status,
+									 &segment->rejected_event, &segment->stop_offset);
+	fclose(input);
+	segment->speculated = true;
+	return NULL;
+}
+
+/**
+* @brief Copies the event lines of a committed segment to stdout
+*/
+static void print_segment_output(FILE* output) {
+	char buffer[SEGMENT_COPY_BUFFER_SIZE];
+	size_t length;
+
+	rewind(output);
+	while ((length = fread(buffer, 1, sizeof(buffer), output)) > 0) {
+		fwrite(buffer, 1, length, stdout);
+	}
+}
+
+/**
+* @brief Clears what a segment holds besides the committed simulator from memory
+*/
+static void free_segment(Segment_t* segment) {
+	if (segment->simulator != NULL) {
+		procsim_destroy(segment->simulator);
+	}
+	if (segment->start_state != NULL) {
+		procsim_destroy(segment->start_state);
+	}
+	if (segment->output != NULL) {
+		fclose(segment->output);
+	}
+	free_trace_summary(&segment->range_summary);
+	free_trace_summary(&segment->guess);
+}
+
+/**
+* @brief Simulates the events of an input file on several threads. The event lines come out on
+* stdout in the order and with the text the sequential loop prints them
+* @param simulator: a configured simulator that has not handled any event, it simulates the
+* first segment. The run takes over its record callback
+* @param input: the input file, positioned at the first event
+* @param trace_path: path of the input file, which each thread opens for itself
+* @param thread_count: number of segments, 1 to MAX_PARALLEL_THREADS
+* @param status: filled in with PROCSIM_OK, or the status of the first rejected event
+* @param rejected_event: filled in with the first rejected event
+* @param stats: filled in with how the segments went
+* @return the simulator holding the state after the last event handled, which replaces the one
+* given
+*/
+Procsim_t* run_parallel(Procsim_t* simulator, FILE* input, const char* trace_path, int thread_count,
+						Procsim_Status* status, Event_t* rejected_event, ParallelRunStats_t* stats) {
+	memset(stats, 0, sizeof(ParallelRunStats_t));
+	stats->threads = thread_count;
+	int device_count = procsim_get_device_count(simulator);
+
+	// Split the events into byte ranges of about the same size
+	long event_offset = ftell(input);
+	fseek(input, 0, SEEK_END);
+	long file_size = ftell(input);
+	fseek(input, event_offset, SEEK_SET);
+	Segment_t* segments = (Segment_t*)calloc(thread_count, sizeof(Segment_t));
+	if (segments == NULL) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		Segment_t* segment = &segments[i];
+		segment->index = i;
+		segment->trace_path = trace_path;
+		segment->range_start = event_offset + (file_size - event_offset) * i / thread_count;
+		segment->cut_offset = -1;
+		initialize_trace_summary(&segment->range_summary, device_count);
+		initialize_trace_summary(&segment->guess, device_count);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		segments[i].range_end = i + 1 < thread_count ? segments[i + 1].range_start : -1;
+	}
+
+	// First pass: every range but the last is summarized, the guess of a range adds up those before it
+	for (int i = 0; i + 1 < thread_count; i++) {
+		if (pthread_create(&segments[i].thread, NULL, summarize_range, &segments[i]) != 0) {
+			fprintf(stderr, "ERROR: Could not start a parallel run thread!\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i + 1 < thread_count; i++) {
+		pthread_join(segments[i].thread, NULL);
+	}
+	int speculated_count = 1;
+	while (speculated_count < thread_count && segments[speculated_count - 1].summarized) {
+		const Segment_t* previous = &segments[speculated_count - 1];
+		add_trace_summary(&segments[speculated_count].guess, &previous->guess);
+		add_trace_summary(&segments[speculated_count].guess, &previous->range_summary);
+		speculated_count++;
+	}
+
+	// Second pass: each segment past the first runs on its own thread from a fork of the configured
+	// simulator. A range the first pass could not read leaves the segments after it without a guess
+	for (int i = 1; i < speculated_count; i++) {
+		Segment_t* segment = &segments[i];
+		segment->simulator = procsim_fork(simulator);
+		if (pthread_create(&segment->thread, NULL, run_segment, segment) != 0) {
+			fprintf(stderr, "ERROR: Could not start a parallel run thread!\n");
+			exit(1);
+		}
+		segment->launched = true;
+	}
+
+	// The first segment starts from the real state, on this thread
+	Procsim_t* committed = simulator;
+	procsim_set_record_callback(committed, &write_record, stdout);
+	long committed_stop;
+	long events = simulate_range(committed, input, event_offset, segments[0].range_end, status, rejected_event,
+								 &committed_stop);
+	stats->segments = 1;
+	stats->committed = 1;
+	stats->speculative_events = events;
+
+	// Segments commit in order. Each one's guessed start state is checked against the state the
+	// run is really in at its cut, and a wrong guess is rolled back by simulating the segment again
+	for (int i = 1; i < thread_count; i++) {
+		Segment_t* segment = &segments[i];
+		if (segment->launched) {
+			pthread_join(segment->thread, NULL);
+		}
+		if (*status != PROCSIM_OK || (segment->speculated && segment->cut_offset < 0)) {
+			free_segment(segment);
+			continue;
+		}
+
+		stats->segments++;
+		if (segment->speculated && segment->cut_offset == committed_stop
+			&& procsim_has_same_idle_state(committed, segment->start_state)) {
+			print_segment_output(segment->output);
+			procsim_absorb_statistics(segment->simulator, committed);
+			procsim_destroy(committed);
+			committed = segment->simulator;
+			segment->simulator = NULL;
+			procsim_set_record_callback(committed, &write_record, stdout);
+			committed_stop = segment->stop_offset;
+			*status = segment->status;
+			*rejected_event = segment->rejected_event;
+			stats->committed++;
+			stats->speculative_events += segment->events;
+		} else {
+			fseek(input, committed_stop, SEEK_SET);
+			stats->replayed_events += simulate_range(committed, input, committed_stop, segment->range_end, status,
+													 rejected_event, &committed_stop);
+			stats->rolled_back++;
+		}
+		free_segment(segment);
+	}
+
+	free_trace_summary(&segments[0].range_summary);
+	free_trace_summary(&segments[0].guess);
+	free(segments);
+	procsim_set_record_callback(committed, NULL, NULL);
+	return committed;
+}
+
+/**
+* @brief Prints the segment counts of a parallel run
+* @param stats: the parallel run
+*/
+void print_parallel_run_summary(const ParallelRunStats_t* stats) {
+	printf("PARALLEL RUN: THREADS %d, SEGMENTS %d, COMMITTED %d, ROLLED BACK %d, SPECULATIVE EVENTS %ld, REPLAYED EVENTS %ld\n",
+		stats->threads, stats->segments, stats->committed, stats->rolled_back, stats->speculative_events,
+		stats->replayed_events);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file parallel_run.h
+ * @brief Declares the parallel run. The input file is cut at idle points, where every process
+ *		  that started has ended, into one segment per thread. Each thread simulates its segment
+ *		  from a guess of the state at its cut, and the segments are committed in order once the
+ *		  guess is checked against the state the segment before it ended in. A segment whose
+ *		  guess was wrong is rolled back and simulated again from the real state
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef PARALLEL_RUN_H
+#define PARALLEL_RUN_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+
+#define MAX_PARALLEL_THREADS 64
+
+/**
+* @struct ParallelRunStats_t
+* @brief Defines how the segments of a parallel run went
+*/
+typedef struct parallel_run_stats {
+	int threads;
+	int segments;				// Segments holding at least one event
+	int committed;				// Segments whose guessed start state held, the first one included
+	int rolled_back;			// Segments simulated again from the state the one before ended in
+	long speculative_events;	// Events of the committed segments, handled in parallel
+	long replayed_events;		// Events of the rolled back segments, handled again in order
+} ParallelRunStats_t;
+
+/**
+* @brief Simulates the events of an input file on several threads. The event lines come out on
+* stdout in the order and with the text the sequential loop prints them
+* @param simulator: a configured simulator that has not handled any event, it simulates the
+* first segment. The run takes over its record callback
+* @param input: the input file, positioned at the first event
+* @param trace_path: path of the input file, which each thread opens for itself
+* @param thread_count: number of segments, 1 to MAX_PARALLEL_THREADS
+* @param status: filled in with PROCSIM_OK, or the status of the first rejected event
+* @param rejected_event: filled in with the first rejected event
+* @param stats: filled in with how the segments went
+* @return the simulator holding the state after the last event handled, which replaces the one
+* given
+*/
+Procsim_t* run_parallel(Procsim_t* simulator, FILE* input, const char* trace_path, int thread_count,
+						Procsim_Status* status, Event_t* rejected_event, ParallelRunStats_t* stats);
+
+/**
+* @brief Prints the segment counts of a parallel run
+* @param stats: the parallel run
+*/
+void print_parallel_run_summary(const ParallelRunStats_t* stats);
+
+#endif //PARALLEL_RUN_H
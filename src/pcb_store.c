@@ -0,0 +1,614 @@
+/**
+ * @file pcb_store.c
+ * @brief Defines the PCB store, which keeps hot scheduling fields and cold runtime
+ *		  statistics of processes apart
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "pcb_store.h"
+#include "instrumentation.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+
+/**
+* @brief Grows an array, reporting a fatal error if memory runs out
+*/
+static void* grow_array(void* array, int capacity, size_t element_size) {
+	INSTRUMENT_MEMORY_ALLOCATION();
+	void* grown = realloc(array, capacity * element_size);
+	if (!grown) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	return grown;
+}
+
+/**
+* @brief Looks up the PCB stored in a slot
+*/
+static PCB_t* get_slot(const PCB_Store_t* store, int slot) {
+	return &store->chunks[slot / PCB_CHUNK_SIZE][slot % PCB_CHUNK_SIZE];
+}
+
+/**
+* @brief Adds a chunk of PCB's and grows the statistic arrays to match
+*/
+static void add_pcb_chunk(PCB_Store_t* store) {
+	INSTRUMENT_MEMORY_ALLOCATION();
+	PCB_t** chunks = (PCB_t**)realloc(store->chunks, (store->chunk_count + 1) * sizeof(PCB_t*));
+	if (!chunks) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	store->chunks = chunks;
+	INSTRUMENT_MEMORY_ALLOCATION();
+	store->chunks[store->chunk_count] = (PCB_t*)malloc(PCB_CHUNK_SIZE * sizeof(PCB_t));
+	if (!store->chunks[store->chunk_count]) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	store->chunk_count++;
+
+	// Every slot has a free-list position and a set of statistics
+	store->stats_capacity = store->chunk_count * PCB_CHUNK_SIZE;
+	store->free_slots = grow_array(store->free_slots, store->stats_capacity, sizeof(*store->free_slots));
+	store->start_ready_time = grow_array(store->start_ready_time, store->stats_capacity, sizeof(*store->start_ready_time));
+	store->total_ready_time = grow_array(store->total_ready_time, store->stats_capacity, sizeof(*store->total_ready_time));
+	store->start_io_blocked_time = grow_array(store->start_io_blocked_time, store->stats_capacity, sizeof(*store->start_io_blocked_time));
+	store->total_io_blocked_time = grow_array(store->total_io_blocked_time, store->stats_capacity, sizeof(*store->total_io_blocked_time));
+	store->bursts.predicted_burst = grow_array(store->bursts.predicted_burst, store->stats_capacity, sizeof(*store->bursts.predicted_burst));
+	store->bursts.burst_time = grow_array(store->bursts.burst_time, store->stats_capacity, sizeof(*store->bursts.burst_time));
+	store->bursts.run_start_time = grow_array(store->bursts.run_start_time, store->stats_capacity, sizeof(*store->bursts.run_start_time));
+	store->switches.voluntary = grow_array(store->switches.voluntary, store->stats_capacity, sizeof(*store->switches.voluntary));
+	store->switches.involuntary = grow_array(store->switches.involuntary, store->stats_capacity, sizeof(*store->switches.involuntary));
+}
+
+/**
+* @brief Initializes the store to empty
+* @param store: the store to initialize
+*/
+void initialize_pcb_store(PCB_Store_t* store) {
+	store->chunks = NULL;
+	store->chunk_count = 0;
+	store->free_slots = NULL;
+	store->free_count = 0;
+	store->next_slot = 0;
+	store->live_count = 0;
+	store->start_ready_time = NULL;
+	store->total_ready_time = NULL;
+	store->start_io_blocked_time = NULL;
+	store->total_io_blocked_time = NULL;
+	store->stats_capacity = 0;
+
+	store->bursts.predicted_burst = NULL;
+	store->bursts.burst_time = NULL;
+	store->bursts.run_start_time = NULL;
+	store->bursts.initial_burst = DEFAULT_INITIAL_BURST;
+	store->bursts.alpha = DEFAULT_BURST_ALPHA;
+	store->bursts.bursts = 0;
+	store->bursts.total_error = 0;
+	store->bursts.max_error = 0;
+
+	store->switches.voluntary = NULL;
+	store->switches.involuntary = NULL;
+	store->switches.costs.context_switch = 0;
+	store->switches.costs.preemption = 0;
+	store->switches.costs.io_interrupt = 0;
+	store->switches.costs_set = false;
+	store->switches.dispatches = 0;
+	store->switches.voluntary_total = 0;
+	store->switches.involuntary_total = 0;
+	store->switches.io_interrupts = 0;
+	store->switches.overhead_time = 0;
+
+	store->groups.weight = NULL;
+	store->groups.processes_started = NULL;
+	store->groups.processes_completed = NULL;
+	store->groups.cpu_time = NULL;
+	store->groups.total_ready_wait_time = NULL;
+	store->groups.max_ready_wait_time = NULL;
+	store->groups.count = 0;
+	store->groups.capacity = 0;
+
+	store->completed.PID = NULL;
+	store->completed.priority = NULL;
+	store->completed.ready_wait_time = NULL;
+	store->completed.io_wait_time = NULL;
+	store->completed.voluntary_switches = NULL;
+	store->completed.involuntary_switches = NULL;
+	store->completed.size = 0;
+	store->completed.capacity = 0;
+	store->completed.retention = 0;
+	store->completed.discarded = 0;
+	store->completed.discarded_ready_wait_time = 0;
+	store->completed.discarded_max_ready_wait_time = 0;
+	store->completed.discarded_io_wait_time = 0;
+	store->completed.discarded_max_io_wait_time = 0;
+}
+
+/**
+* @brief Hands out an initialized PCB with zeroed statistics
+* @param store: the store
+* @return the new PCB
+*/
+PCB_t* allocate_pcb(PCB_Store_t* store) {
+	int slot;
+	if (store->free_count > 0) {
+		// Reuse the most recently freed slot, it is the most likely to still be cached
+		slot = store->free_slots[--store->free_count];
+		INSTRUMENT_PCB_ALLOCATION(1);
+	} else {
+		if (store->next_slot == store->stats_capacity) {
+			add_pcb_chunk(store);
+		}
+		slot = store->next_slot++;
+		INSTRUMENT_PCB_ALLOCATION(0);
+	}
+	store->live_count++;
+
+	PCB_t* pcb = get_slot(store, slot);
+	initialize_PCB(pcb);
+	pcb->slot = slot;
+
+	store->start_ready_time[slot] = 0;
+	store->total_ready_time[slot] = 0;
+	store->start_io_blocked_time[slot] = 0;
+	store->total_io_blocked_time[slot] = 0;
+	store->bursts.predicted_burst[slot] = store->bursts.initial_burst;
+	store->bursts.burst_time[slot] = 0;
+	store->bursts.run_start_time[slot] = 0;
+	store->switches.voluntary[slot] = 0;
+	store->switches.involuntary[slot] = 0;
+	return pcb;
+}
+
+/**
+* @brief Returns a PCB's slot to the store without recording it as completed
+* @param store: the store
+* @param pcb: the PCB to release
+*/
+void release_pcb(PCB_Store_t* store, PCB_t* pcb) {
+	store->free_slots[store->free_count++] = pcb->slot;
+	store->live_count--;
+}
+
+/**
+* @brief Records a finished process in the completed analytics and releases its PCB
+* @param store: the store
+* @param pcb: the finished PCB
+*/
+void complete_pcb(PCB_Store_t* store, PCB_t* pcb) {
+	ProcessResult_t result = {pcb->PID, pcb->priority, store->total_ready_time[pcb->slot], store->total_io_blocked_time[pcb->slot],
+		store->switches.voluntary[pcb->slot], store->switches.involuntary[pcb->slot]};
+	append_completed_process(&store->completed, &result);
+
+	ProcessGroups_t* groups = &store->groups;
+	groups->processes_completed[pcb->group]++;
+	groups->total_ready_wait_time[pcb->group] += result.ready_wait_time;
+	if (result.ready_wait_time > groups->max_ready_wait_time[pcb->group]) {
+		groups->max_ready_wait_time[pcb->group] = result.ready_wait_time;
+	}
+	release_pcb(store, pcb);
+}
+
+/**
+* @brief Makes sure a group has an entry in the group analytics
+* @param store: the store
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+*/
+void reserve_process_group(PCB_Store_t* store, int group) {
+	ProcessGroups_t* groups = &store->groups;
+	if (group < groups->count) {
+		return;
+	}
+
+	if (group >= groups->capacity) {
+		int new_capacity = groups->capacity == 0 ? 8 : groups->capacity;
+		while (new_capacity <= group) {
+			new_capacity *= 2;
+		}
+		groups->weight = grow_array(groups->weight, new_capacity, sizeof(*groups->weight));
+		groups->processes_started = grow_array(groups->processes_started, new_capacity, sizeof(*groups->processes_started));
+		groups->processes_completed = grow_array(groups->processes_completed, new_capacity, sizeof(*groups->processes_completed));
+		groups->cpu_time = grow_array(groups->cpu_time, new_capacity, sizeof(*groups->cpu_time));
+		groups->total_ready_wait_time = grow_array(groups->total_ready_wait_time, new_capacity, sizeof(*groups->total_ready_wait_time));
+		groups->max_ready_wait_time = grow_array(groups->max_ready_wait_time, new_capacity, sizeof(*groups->max_ready_wait_time));
+		groups->capacity = new_capacity;
+	}
+	for (int i = groups->count; i <= group; i++) {
+		groups->weight[i] = 1;
+		groups->processes_started[i] = 0;
+		groups->processes_completed[i] = 0;
+		groups->cpu_time[i] = 0;
+		groups->total_ready_wait_time[i] = 0;
+		groups->max_ready_wait_time[i] = 0;
+	}
+	groups->count = group + 1;
+}
+
+/**
+* @brief Places a new process in a group and counts it in the group analytics
+* @param store: the store
+* @param pcb: the new process
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+*/
+void assign_process_group(PCB_Store_t* store, PCB_t* pcb, int group) {
+	reserve_process_group(store, group);
+	pcb->group = (unsigned short)group;
+	store->groups.processes_started[group]++;
+}
+
+/**
+* @brief Ends the current CPU burst of a process, records the prediction error and predicts
+* the next burst from the exponential average
+* @param store: the store
+* @param pcb: the running process
+* @param time: the time the burst ended
+*/
+void end_cpu_burst(PCB_Store_t* store, const PCB_t* pcb, Procsim_Time time) {
+	BurstPredictions_t* bursts = &store->bursts;
+	int slot = pcb->slot;
+	Procsim_Time actual = bursts->burst_time[slot] + time - bursts->run_start_time[slot];
+	Procsim_Time predicted = bursts->predicted_burst[slot];
+
+	Procsim_Time error = actual > predicted ? actual - predicted : predicted - actual;
+	bursts->bursts++;
+	bursts->total_error += error;
+	if (error > bursts->max_error) {
+		bursts->max_error = error;
+	}
+
+	bursts->predicted_burst[slot] = (Procsim_Time)(bursts->alpha * actual + (1.0 - bursts->alpha) * predicted + 0.5);
+	bursts->burst_time[slot] = 0;
+}
+
+/**
+* @brief Charges the context switch cost for giving the CPU to a process
+* @param store: the store
+*/
+void charge_dispatch(PCB_Store_t* store) {
+	store->switches.dispatches++;
+	store->switches.overhead_time += store->switches.costs.context_switch;
+}
+
+/**
+* @brief Counts a process leaving the CPU, charging the preemption cost if it was preempted
+* @param store: the store
+* @param pcb: the process leaving the CPU
+* @param preempted: whether the switch is involuntary
+*/
+void charge_switch_out(PCB_Store_t* store, const PCB_t* pcb, bool preempted) {
+	ContextSwitches_t* switches = &store->switches;
+	if (preempted) {
+		switches->involuntary[pcb->slot]++;
+		switches->involuntary_total++;
+		switches->overhead_time += switches->costs.preemption;
+	} else {
+		switches->voluntary[pcb->slot]++;
+		switches->voluntary_total++;
+	}
+}
+
+/**
+* @brief Charges the interrupt cost of an I/O completion
+* @param store: the store
+*/
+void charge_io_interrupt(PCB_Store_t* store) {
+	store->switches.io_interrupts++;
+	store->switches.overhead_time += store->switches.costs.io_interrupt;
+}
+
+/**
+* @brief Sums and finds the maximum of a wait time array. Written as a single simd
+* reduction so the compiler vectorizes it
+* @param values: the wait times
+* @param count: number of wait times
+* @param total: filled in with the sum
+* @param maximum: filled in with the maximum, 0 for an empty array
+*/
+static void reduce_wait_times(const Procsim_Time* values, int count, Procsim_Time* total, Procsim_Time* maximum) {
+	Procsim_Time sum = 0;
+	Procsim_Time largest = 0;
+
+	#pragma omp simd reduction(+:sum) reduction(max:largest)
+	for (int i = 0; i < count; i++) {
+		sum += values[i];
+		largest = values[i] > largest ? values[i] : largest;
+	}
+
+	*total = sum;
+	*maximum = largest;
+}
+
+/**
+* @brief Folds the oldest processes of the completed analytics into the running totals
+* @param completed: the completed analytics
+* @param count: number of processes to fold, at most the size
+*/
+void discard_completed_processes(CompletedProcesses_t* completed, int count) {
+	Procsim_Time total;
+	Procsim_Time maximum;
+	reduce_wait_times(completed->ready_wait_time, count, &total, &maximum);
+	completed->discarded_ready_wait_time += total;
+	if (maximum > completed->discarded_max_ready_wait_time) {
+		completed->discarded_max_ready_wait_time = maximum;
+	}
+	reduce_wait_times(completed->io_wait_time, count, &total, &maximum);
+	completed->discarded_io_wait_time += total;
+	if (maximum > completed->discarded_max_io_wait_time) {
+		completed->discarded_max_io_wait_time = maximum;
+	}
+	completed->discarded += count;
+
+	int kept = completed->size - count;
+	memmove(completed->PID, completed->PID + count, kept * sizeof(*completed->PID));
+	memmove(completed->priority, completed->priority + count, kept * sizeof(*completed->priority));
+	memmove(completed->ready_wait_time, completed->ready_wait_time + count, kept * sizeof(*completed->ready_wait_time));
+	memmove(completed->io_wait_time, completed->io_wait_time + count, kept * sizeof(*completed->io_wait_time));
+	memmove(completed->voluntary_switches, completed->voluntary_switches + count, kept * sizeof(*completed->voluntary_switches));
+	memmove(completed->involuntary_switches, completed->involuntary_switches + count, kept * sizeof(*completed->involuntary_switches));
+	completed->size = kept;
+}
+
+/**
+* @brief Appends a finished process to the completed analytics
+* @param completed: the completed analytics
+* @param result: the analytics of the process
+*/
+void append_completed_process(CompletedProcesses_t* completed, const ProcessResult_t* result) {
+	if (completed->retention > 0 && completed->size == completed->retention) {
+		// Keep the newer half, so folding happens once per retention / 2 completions
+		discard_completed_processes(completed, completed->size - completed->retention / 2);
+	}
+	if (completed->size == completed->capacity) {
+		completed->capacity = completed->capacity == 0 ? 256 : completed->capacity * 2;
+		completed->PID = grow_array(completed->PID, completed->capacity, sizeof(*completed->PID));
+		completed->priority = grow_array(completed->priority, completed->capacity, sizeof(*completed->priority));
+		completed->ready_wait_time = grow_array(completed->ready_wait_time, completed->capacity, sizeof(*completed->ready_wait_time));
+		completed->io_wait_time = grow_array(completed->io_wait_time, completed->capacity, sizeof(*completed->io_wait_time));
+		completed->voluntary_switches = grow_array(completed->voluntary_switches, completed->capacity, sizeof(*completed->voluntary_switches));
+		completed->involuntary_switches = grow_array(completed->involuntary_switches, completed->capacity, sizeof(*completed->involuntary_switches));
+	}
+
+	int i = completed->size++;
+	completed->PID[i] = result->PID;
+	completed->priority[i] = result->priority;
+	completed->ready_wait_time[i] = result->ready_wait_time;
+	completed->io_wait_time[i] = result->io_wait_time;
+	completed->voluntary_switches[i] = result->voluntary_switches;
+	completed->involuntary_switches[i] = result->involuntary_switches;
+}
+
+/**
+* @brief Allocates an array holding a copy of the first entries of another
+*/
+static void* copy_array(const void* array, int count, int capacity, size_t element_size) {
+	void* copy = grow_array(NULL, capacity, element_size);
+	memcpy(copy, array, count * element_size);
+	return copy;
+}
+
+/**
+* @brief Copies the completed process analytics into arrays of their own
+*/
+static void copy_completed_processes(CompletedProcesses_t* copy, const CompletedProcesses_t* completed) {
+	*copy = *completed;
+	if (completed->capacity > 0) {
+		copy->PID = copy_array(completed->PID, completed->size, completed->capacity, sizeof(*completed->PID));
+		copy->priority = copy_array(completed->priority, completed->size, completed->capacity, sizeof(*completed->priority));
+		copy->ready_wait_time = copy_array(completed->ready_wait_time, completed->size, completed->capacity, sizeof(*completed->ready_wait_time));
+		copy->io_wait_time = copy_array(completed->io_wait_time, completed->size, completed->capacity, sizeof(*completed->io_wait_time));
+		copy->voluntary_switches = copy_array(completed->voluntary_switches, completed->size, completed->capacity, sizeof(*completed->voluntary_switches));
+		copy->involuntary_switches = copy_array(completed->involuntary_switches, completed->size, completed->capacity, sizeof(*completed->involuntary_switches));
+	}
+}
+
+/**
+* @brief Makes an independent copy of a store. Chunks and statistic arrays are copied whole,
+* and the queue links inside the copied PCB's are repointed at the copy
+* @param clone: the store to fill in, not initialized
+* @param store: the store to copy
+*/
+void clone_pcb_store(PCB_Store_t* clone, const PCB_Store_t* store) {
+	*clone = *store;
+
+	// Only handed out slots hold anything worth copying, but the capacities stay the same
+	INSTRUMENT_MEMORY_ALLOCATION();
+	clone->chunks = (PCB_t**)malloc((store->chunk_count > 0 ? store->chunk_count : 1) * sizeof(PCB_t*));
+	if (!clone->chunks) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	for (int i = 0; i < store->chunk_count; i++) {
+		INSTRUMENT_MEMORY_ALLOCATION();
+		clone->chunks[i] = (PCB_t*)malloc(PCB_CHUNK_SIZE * sizeof(PCB_t));
+		if (!clone->chunks[i]) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+		memcpy(clone->chunks[i], store->chunks[i], PCB_CHUNK_SIZE * sizeof(PCB_t));
+	}
+	for (int slot = 0; slot < store->next_slot; slot++) {
+		PCB_t* pcb = get_slot(clone, slot);
+		pcb->next = get_cloned_pcb(clone, pcb->next);
+	}
+
+	if (store->stats_capacity > 0) {
+		clone->free_slots = copy_array(store->free_slots, store->free_count, store->stats_capacity, sizeof(*store->free_slots));
+		clone->start_ready_time = copy_array(store->start_ready_time, store->next_slot, store->stats_capacity, sizeof(*store->start_ready_time));
+		clone->total_ready_time = copy_array(store->total_ready_time, store->next_slot, store->stats_capacity, sizeof(*store->total_ready_time));
+		clone->start_io_blocked_time = copy_array(store->start_io_blocked_time, store->next_slot, store->stats_capacity, sizeof(*store->start_io_blocked_time));
+		clone->total_io_blocked_time = copy_array(store->total_io_blocked_time, store->next_slot, store->stats_capacity, sizeof(*store->total_io_blocked_time));
+		clone->bursts.predicted_burst = copy_array(store->bursts.predicted_burst, store->next_slot, store->stats_capacity, sizeof(*store->bursts.predicted_burst));
+		clone->bursts.burst_time = copy_array(store->bursts.burst_time, store->next_slot, store->stats_capacity, sizeof(*store->bursts.burst_time));
+		clone->bursts.run_start_time = copy_array(store->bursts.run_start_time, store->next_slot, store->stats_capacity, sizeof(*store->bursts.run_start_time));
+		clone->switches.voluntary = copy_array(store->switches.voluntary, store->next_slot, store->stats_capacity, sizeof(*store->switches.voluntary));
+		clone->switches.involuntary = copy_array(store->switches.involuntary, store->next_slot, store->stats_capacity, sizeof(*store->switches.involuntary));
+	}
+
+	const ProcessGroups_t* groups = &store->groups;
+	if (groups->capacity > 0) {
+		clone->groups.weight = copy_array(groups->weight, groups->count, groups->capacity, sizeof(*groups->weight));
+		clone->groups.processes_started = copy_array(groups->processes_started, groups->count, groups->capacity, sizeof(*groups->processes_started));
+		clone->groups.processes_completed = copy_array(groups->processes_completed, groups->count, groups->capacity, sizeof(*groups->processes_completed));
+		clone->groups.cpu_time = copy_array(groups->cpu_time, groups->count, groups->capacity, sizeof(*groups->cpu_time));
+		clone->groups.total_ready_wait_time = copy_array(groups->total_ready_wait_time, groups->count, groups->capacity, sizeof(*groups->total_ready_wait_time));
+		clone->groups.max_ready_wait_time = copy_array(groups->max_ready_wait_time, groups->count, groups->capacity, sizeof(*groups->max_ready_wait_time));
+	}
+
+	copy_completed_processes(&clone->completed, &store->completed);
+}
+
+/**
+* @brief Checks whether two stores predict bursts, charge switches, weigh groups and retain
+* results the same way
+* @param store: a store
+* @param other: another store
+* @return true if every setting matches
+*/
+bool has_same_pcb_store_settings(const PCB_Store_t* store, const PCB_Store_t* other) {
+	if (store->bursts.initial_burst != other->bursts.initial_burst || store->bursts.alpha != other->bursts.alpha
+		|| store->switches.costs_set != other->switches.costs_set
+		|| store->switches.costs.context_switch != other->switches.costs.context_switch
+		|| store->switches.costs.preemption != other->switches.costs.preemption
+		|| store->switches.costs.io_interrupt != other->switches.costs.io_interrupt
+		|| store->completed.retention != other->completed.retention) {
+		return false;
+	}
+
+	// Groups without an entry have the default weight
+	int group_count = store->groups.count > other->groups.count ? store->groups.count : other->groups.count;
+	for (int i = 0; i < group_count; i++) {
+		int weight = i < store->groups.count ? store->groups.weight[i] : 1;
+		int other_weight = i < other->groups.count ? other->groups.weight[i] : 1;
+		if (weight != other_weight) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Adds the statistics an earlier store gathered before this one took over the run. The
+* earlier completed processes come first, and the live PCB's of the earlier store are ignored
+* @param store: the store that took over
+* @param earlier: the store of the run up to the takeover
+*/
+void merge_pcb_store_statistics(PCB_Store_t* store, const PCB_Store_t* earlier) {
+	BurstPredictions_t* bursts = &store->bursts;
+	bursts->bursts += earlier->bursts.bursts;
+	bursts->total_error += earlier->bursts.total_error;
+	if (earlier->bursts.max_error > bursts->max_error) {
+		bursts->max_error = earlier->bursts.max_error;
+	}
+
+	ContextSwitches_t* switches = &store->switches;
+	switches->dispatches += earlier->switches.dispatches;
+	switches->voluntary_total += earlier->switches.voluntary_total;
+	switches->involuntary_total += earlier->switches.involuntary_total;
+	switches->io_interrupts += earlier->switches.io_interrupts;
+	switches->overhead_time += earlier->switches.overhead_time;
+
+	const ProcessGroups_t* earlier_groups = &earlier->groups;
+	ProcessGroups_t* groups = &store->groups;
+	if (earlier_groups->count > 0) {
+		reserve_process_group(store, earlier_groups->count - 1);
+	}
+	for (int i = 0; i < earlier_groups->count; i++) {
+		groups->processes_started[i] += earlier_groups->processes_started[i];
+		groups->processes_completed[i] += earlier_groups->processes_completed[i];
+		groups->cpu_time[i] += earlier_groups->cpu_time[i];
+		groups->total_ready_wait_time[i] += earlier_groups->total_ready_wait_time[i];
+		if (earlier_groups->max_ready_wait_time[i] > groups->max_ready_wait_time[i]) {
+			groups->max_ready_wait_time[i] = earlier_groups->max_ready_wait_time[i];
+		}
+	}
+
+	// Completions are appended after the earlier ones, folding as they would have in a single run
+	CompletedProcesses_t later = store->completed;
+	CompletedProcesses_t* completed = &store->completed;
+	copy_completed_processes(completed, &earlier->completed);
+	completed->retention = later.retention;
+	for (int i = 0; i < later.size; i++) {
+		ProcessResult_t result = {later.PID[i], later.priority[i], later.ready_wait_time[i], later.io_wait_time[i],
+			later.voluntary_switches[i], later.involuntary_switches[i]};
+		append_completed_process(completed, &result);
+	}
+
+	// Completions the later store already folded only count in the totals
+	completed->discarded += later.discarded;
+	completed->discarded_ready_wait_time += later.discarded_ready_wait_time;
+	if (later.discarded_max_ready_wait_time > completed->discarded_max_ready_wait_time) {
+		completed->discarded_max_ready_wait_time = later.discarded_max_ready_wait_time;
+	}
+	completed->discarded_io_wait_time += later.discarded_io_wait_time;
+	if (later.discarded_max_io_wait_time > completed->discarded_max_io_wait_time) {
+		completed->discarded_max_io_wait_time = later.discarded_max_io_wait_time;
+	}
+	free(later.PID);
+	free(later.priority);
+	free(later.ready_wait_time);
+	free(later.io_wait_time);
+	free(later.voluntary_switches);
+	free(later.involuntary_switches);
+}
+
+/**
+* @brief Sums and finds the maxima of the ready and I/O wait times of the completed processes
+* @param store: the store
+* @param stats: filled in with the completed count and the wait time totals and maxima
+*/
+void get_wait_time_totals(const PCB_Store_t* store, ProcsimStats_t* stats) {
+	const CompletedProcesses_t* completed = &store->completed;
+	stats->processes_completed = completed->discarded + completed->size;
+	reduce_wait_times(completed->ready_wait_time, completed->size, &stats->total_ready_wait_time, &stats->max_ready_wait_time);
+	reduce_wait_times(completed->io_wait_time, completed->size, &stats->total_io_wait_time, &stats->max_io_wait_time);
+
+	// Processes folded out of the arrays still count
+	stats->total_ready_wait_time += completed->discarded_ready_wait_time;
+	if (completed->discarded_max_ready_wait_time > stats->max_ready_wait_time) {
+		stats->max_ready_wait_time = completed->discarded_max_ready_wait_time;
+	}
+	stats->total_io_wait_time += completed->discarded_io_wait_time;
+	if (completed->discarded_max_io_wait_time > stats->max_io_wait_time) {
+		stats->max_io_wait_time = completed->discarded_max_io_wait_time;
+	}
+}
+
+/**
+* @brief clears every PCB and statistic of the store from memory
+* @param store: the store to clear
+*/
+void free_pcb_store(PCB_Store_t* store) {
+	for (int i = 0; i < store->chunk_count; i++) {
+		free(store->chunks[i]);
+	}
+	free(store->chunks);
+	free(store->free_slots);
+	free(store->start_ready_time);
+	free(store->total_ready_time);
+	free(store->start_io_blocked_time);
+	free(store->total_io_blocked_time);
+	free(store->bursts.predicted_burst);
+	free(store->bursts.burst_time);
+	free(store->bursts.run_start_time);
+	free(store->switches.voluntary);
+	free(store->switches.involuntary);
+
+	free(store->groups.weight);
+	free(store->groups.processes_started);
+	free(store->groups.processes_completed);
+	free(store->groups.cpu_time);
+	free(store->groups.total_ready_wait_time);
+	free(store->groups.max_ready_wait_time);
+
+	free(store->completed.PID);
+	free(store->completed.priority);
+	free(store->completed.ready_wait_time);
+	free(store->completed.io_wait_time);
+	free(store->completed.voluntary_switches);
+	free(store->completed.involuntary_switches);
+	initialize_pcb_store(store);
+}
@@ -0,0 +1,275 @@
+/**
+ * @file pcb_store.h
+ * @brief Declares the PCB store. The store owns every PCB of a run, keeping the hot
+ *		  scheduling fields packed in PCB_t and the runtime statistics in separate
+ *		  arrays indexed by the PCB's slot
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef PCB_STORE_H
+#define PCB_STORE_H
+
+// Header imports
+#include "PCB.h"
+#include "procsim.h"
+
+// Number of PCB's per chunk. Chunks never move, so PCB pointers stay valid as the store grows
+#define PCB_CHUNK_SIZE 1024
+
+/**
+* @struct CompletedProcesses_t
+* @brief Defines the analytics of finished processes, one array per field in completion order.
+* With a retention limit, the oldest half is folded into running totals whenever the arrays fill
+*/
+typedef struct completed_processes {
+	Procsim_PID* PID;
+	int* priority;
+	Procsim_Time* ready_wait_time;
+	Procsim_Time* io_wait_time;
+	int* voluntary_switches;
+	int* involuntary_switches;
+	int size;
+	int capacity;
+	int retention;			// Most processes kept in the arrays, 0 keeps every process
+
+	// Totals of the processes no longer in the arrays
+	long discarded;
+	Procsim_Time discarded_ready_wait_time;
+	Procsim_Time discarded_max_ready_wait_time;
+	Procsim_Time discarded_io_wait_time;
+	Procsim_Time discarded_max_io_wait_time;
+} CompletedProcesses_t;
+
+/**
+* @struct BurstPredictions_t
+* @brief Defines the CPU burst predictions of the SJF and SRTF policies. A burst runs from the
+* dispatch that follows a start or an I/O completion to the next I/O request or end of the process
+*/
+typedef struct burst_predictions {
+	Procsim_Time* predicted_burst;	// Prediction of the current burst, indexed by slot
+	Procsim_Time* burst_time;		// CPU time the current burst used up to its last preemption, indexed by slot
+	Procsim_Time* run_start_time;	// Time the process was last dispatched, indexed by slot
+	int initial_burst;		// Prediction of the first burst of every process
+	double alpha;			// Weight of the last burst in the exponential average
+
+	// Prediction accuracy over every finished burst
+	long bursts;
+	Procsim_Time total_error;
+	Procsim_Time max_error;
+} BurstPredictions_t;
+
+/**
+* @struct ContextSwitches_t
+* @brief Defines the context switches of the run and the CPU time charged for them. A switch is
+* voluntary when the process gives up the CPU for I/O or to end, involuntary when preempted
+*/
+typedef struct context_switches {
+	int* voluntary;			// Voluntary switches of each process, indexed by slot
+	int* involuntary;		// Involuntary switches of each process, indexed by slot
+	SwitchCosts_t costs;
+	bool costs_set;
+
+	// Totals over the whole run
+	long dispatches;
+	long voluntary_total;
+	long involuntary_total;
+	long io_interrupts;
+	Procsim_Time overhead_time;
+} ContextSwitches_t;
+
+/**
+* @struct ProcessGroups_t
+* @brief Defines the weight and the analytics of every process group, indexed by group id
+*/
+typedef struct process_groups {
+	int* weight;					// Share of the CPU under the fair-share policy, 1 by default
+	long* processes_started;
+	long* processes_completed;
+	Procsim_Time* cpu_time;					// CPU time used, measured under the fair-share policy
+	Procsim_Time* total_ready_wait_time;	// Ready wait time of the completed processes
+	Procsim_Time* max_ready_wait_time;
+	int count;						// One more than the highest group id seen
+	int capacity;
+} ProcessGroups_t;
+
+/**
+* @struct PCB_Store_t
+* @brief Defines the storage of live PCB's, their statistics and the completed process analytics
+*/
+typedef struct pcb_store {
+	// Hot scheduling fields, in fixed size chunks
+	PCB_t** chunks;
+	int chunk_count;
+
+	// Slot bookkeeping. Freed slots are reused before new ones are handed out
+	int* free_slots;
+	int free_count;
+	int next_slot;
+	int live_count;
+
+	// Cold runtime statistics, indexed by slot. A wait adds up as it ends, so only its start is kept
+	Procsim_Time* start_ready_time;
+	Procsim_Time* total_ready_time;
+	Procsim_Time* start_io_blocked_time;
+	Procsim_Time* total_io_blocked_time;
+	int stats_capacity;
+
+	BurstPredictions_t bursts;
+	ContextSwitches_t switches;
+	ProcessGroups_t groups;
+	CompletedProcesses_t completed;
+} PCB_Store_t;
+
+/**
+* @brief Initializes the store to empty
+* @param store: the store to initialize
+*/
+void initialize_pcb_store(PCB_Store_t* store);
+
+/**
+* @brief Hands out an initialized PCB with zeroed statistics
+* @param store: the store
+* @return the new PCB
+*/
+PCB_t* allocate_pcb(PCB_Store_t* store);
+
+/**
+* @brief Returns a PCB's slot to the store without recording it as completed
+* @param store: the store
+* @param pcb: the PCB to release
+*/
+void release_pcb(PCB_Store_t* store, PCB_t* pcb);
+
+/**
+* @brief Records a finished process in the completed analytics and releases its PCB
+* @param store: the store
+* @param pcb: the finished PCB
+*/
+void complete_pcb(PCB_Store_t* store, PCB_t* pcb);
+
+/**
+* @brief Appends a finished process to the completed analytics
+* @param completed: the completed analytics
+* @param result: the analytics of the process
+*/
+void append_completed_process(CompletedProcesses_t* completed, const ProcessResult_t* result);
+
+/**
+* @brief Folds the oldest processes of the completed analytics into the running totals
+* @param completed: the completed analytics
+* @param count: number of processes to fold, at most the size
+*/
+void discard_completed_processes(CompletedProcesses_t* completed, int count);
+
+/**
+* @brief Makes an independent copy of a store. Chunks and statistic arrays are copied whole,
+* and the queue links inside the copied PCB's are repointed at the copy
+* @param clone: the store to fill in, not initialized
+* @param store: the store to copy
+*/
+void clone_pcb_store(PCB_Store_t* clone, const PCB_Store_t* store);
+
+/**
+* @brief Checks whether two stores predict bursts, charge switches, weigh groups and retain
+* results the same way
+* @param store: a store
+* @param other: another store
+* @return true if every setting matches
+*/
+bool has_same_pcb_store_settings(const PCB_Store_t* store, const PCB_Store_t* other);
+
+/**
+* @brief Adds the statistics an earlier store gathered before this one took over the run. The
+* earlier completed processes come first, and the live PCB's of the earlier store are ignored
+* @param store: the store that took over
+* @param earlier: the store of the run up to the takeover
+*/
+void merge_pcb_store_statistics(PCB_Store_t* store, const PCB_Store_t* earlier);
+
+/**
+* @brief Finds the copy of a PCB in a cloned store. A PCB keeps its slot in the clone
+* @param clone: the cloned store
+* @param pcb: a PCB of the original store, or NULL
+* @return the PCB in the clone, or NULL
+*/
+static inline PCB_t* get_cloned_pcb(const PCB_Store_t* clone, const PCB_t* pcb) {
+	if (pcb == NULL) {
+		return NULL;
+	}
+	return &clone->chunks[pcb->slot / PCB_CHUNK_SIZE][pcb->slot % PCB_CHUNK_SIZE];
+}
+
+/**
+* @brief Predicts how much of its current burst a waiting process has left, the key of the
+* SJF and SRTF ready queue
+* @param store: the store
+* @param pcb: the process, not running
+* @return the predicted remaining burst, at least 0
+*/
+static inline Procsim_Time get_remaining_burst(const PCB_Store_t* store, const PCB_t* pcb) {
+	Procsim_Time remaining = store->bursts.predicted_burst[pcb->slot] - store->bursts.burst_time[pcb->slot];
+	return remaining > 0 ? remaining : 0;
+}
+
+/**
+* @brief Ends the current CPU burst of a process, records the prediction error and predicts
+* the next burst from the exponential average
+* @param store: the store
+* @param pcb: the running process
+* @param time: the time the burst ended
+*/
+void end_cpu_burst(PCB_Store_t* store, const PCB_t* pcb, Procsim_Time time);
+
+/**
+* @brief Makes sure a group has an entry in the group analytics
+* @param store: the store
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+*/
+void reserve_process_group(PCB_Store_t* store, int group);
+
+/**
+* @brief Places a new process in a group and counts it in the group analytics
+* @param store: the store
+* @param pcb: the new process
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+*/
+void assign_process_group(PCB_Store_t* store, PCB_t* pcb, int group);
+
+/**
+* @brief Charges the context switch cost for giving the CPU to a process
+* @param store: the store
+*/
+void charge_dispatch(PCB_Store_t* store);
+
+/**
+* @brief Counts a process leaving the CPU, charging the preemption cost if it was preempted
+* @param store: the store
+* @param pcb: the process leaving the CPU
+* @param preempted: whether the switch is involuntary
+*/
+void charge_switch_out(PCB_Store_t* store, const PCB_t* pcb, bool preempted);
+
+/**
+* @brief Charges the interrupt cost of an I/O completion
+* @param store: the store
+*/
+void charge_io_interrupt(PCB_Store_t* store);
+
+/**
+* @brief Sums and finds the maxima of the ready and I/O wait times of the completed processes
+* @param store: the store
+* @param stats: filled in with the completed count and the wait time totals and maxima
+*/
+void get_wait_time_totals(const PCB_Store_t* store, ProcsimStats_t* stats);
+
+/**
+* @brief clears every PCB and statistic of the store from memory
+* @param store: the store to clear
+*/
+void free_pcb_store(PCB_Store_t* store);
+
+#endif //PCB_STORE_H
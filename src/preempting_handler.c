@@ -13,6 +13,7 @@
 #include "priority_queue.h"
 #include "io_device.h"
 #include "PCB.h"
+#include "pcb_store.h"
 // Library imports
 #include <stdlib.h>
 
@@ -20,81 +21,165 @@
 static int compare_priority(const void* a, const void* b);
 
 /**
-* @brief Handles the event of starting of a process using preemptive scheduling
+* @brief Takes the first process of the ready queue, through the spill if the waiting processes
+* are bounded, or the adaptive backend if there is one
+* @param schedulerHandler: A reference to the current scheduler
+* @param time: the current time
+* @return the process, the queue must not be empty
+*/
+static PCB_t* dequeue_ready_process(SchedulerHandler* schedulerHandler, Procsim_Time time) {
+	if (schedulerHandler->adaptive_queue != NULL) {
+		return dequeue_adaptive_queue(schedulerHandler->adaptive_queue, (PriorityQueue_t*)schedulerHandler->queue, time);
+	}
+	if (schedulerHandler->ready_spill == NULL) {
+		return dequeue_priority_queue((PriorityQueue_t*)schedulerHandler->queue);
+	}
+	return dequeue_ready_spill(schedulerHandler->ready_spill, schedulerHandler->pcb_store, (PriorityQueue_t*)schedulerHandler->queue);
+}
+
+/**
+* @brief Starts a process, preempting the running process if the new one has a higher priority.
+* The process left waiting, the new one or the preempted one, is logged as ready and counted as
+* pending, and the caller merges it into the ready queue
 * @param schedulerHandler: A reference to the current scheduler
 * @param priority: a new processes priority
+* @param group: the process group of the new process
 * @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
-* @param current_time: reference to the current time, used for analytics marking events
+* @param current_time: the current time, used for analytics marking events
+* @return the process that waits, NULL if the new process took the idle CPU
 */
-void preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int* PID_tracker, int* current_time) {
+static PCB_t* admit_process(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
 	// Create a new PCB for the new process
-	PCB_t* new_process = (PCB_t*)malloc(sizeof(PCB_t));  // Dynamically allocate memory
-	initialize_PCB(new_process);
+	PCB_t* new_process = allocate_pcb(store);
 	new_process->priority = priority;
 	new_process->PID = *PID_tracker;
+	assign_process_group(store, new_process, group);
 
 	// Iterate the PID tracker so new processes get new ID's
 	(*PID_tracker)++;
 
-	printf("%d: Starting process with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+	log_event(schedulerHandler, LOG_PROCESS_STARTED, current_time, new_process, NULL);
 	// Add the new process to the queue. If no process is currently active/current process is
 	// of lower priority, assign straight to CPU
 	if (schedulerHandler->CPU == NULL){
 		// No process is currently running in the CPU, assign new process to CPU
 		new_process->state = RUNNING;
 		schedulerHandler->CPU = new_process;
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// System analytics
-		schedulerHandler->end_idle_time = *current_time;
+		schedulerHandler->end_idle_time = current_time;
 		schedulerHandler->total_idle_time += schedulerHandler->end_idle_time - schedulerHandler->start_idle_time;
-	} else if (schedulerHandler->CPU->priority < new_process->priority) {
+		return NULL;
+	}
+
+	if (schedulerHandler->CPU->priority < new_process->priority) {
 		// New process is of higher priority than current process, assign new process to CPU
-		schedulerHandler->CPU->state = READY;
-		schedulerHandler->CPU->start_ready_time = *current_time;
-		enqueue_priority_queue(schedulerHandler->queue, schedulerHandler->CPU);
+		PCB_t* preempted_process = schedulerHandler->CPU;
+		preempted_process->state = READY;
+		store->start_ready_time[preempted_process->slot] = current_time;
+		schedulerHandler->ready_pending++;
+		log_event(schedulerHandler, LOG_PROCESS_PREEMPTED, current_time, preempted_process, NULL);
+		charge_switch_out(store, preempted_process, true);
 
 		new_process->state = RUNNING;
 		schedulerHandler->CPU = new_process;
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
-	} else {
-		// New process is of lower or equal priority than current process, add to queue
-		new_process->state = READY;
-		enqueue_priority_queue(schedulerHandler->queue, new_process);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, current_time, new_process, NULL);
+		charge_dispatch(store);
+		return preempted_process;
+	}
 
-		// Process analytics
-		new_process->start_ready_time = *current_time;
+	// New process is of lower or equal priority than current process, add to queue
+	new_process->state = READY;
+	schedulerHandler->ready_pending++;
+	log_event(schedulerHandler, LOG_PROCESS_READY, current_time, new_process, NULL);
+
+	// Process analytics
+	store->start_ready_time[new_process->slot] = current_time;
+	return new_process;
+}
+
+/**
+* @brief Handles the event of starting of a process using preemptive scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics marking events
+*/
+void preemptive_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time) {
+	PCB_t* waiting_process = admit_process(schedulerHandler, priority, group, PID_tracker, *current_time);
+	if (waiting_process != NULL) {
+		schedulerHandler->ready_pending = 0;
+		enqueue_ready_processes(schedulerHandler, &waiting_process, 1, *current_time);
+	}
+}
+
+/**
+* @brief Handles a run of process starts at the same time using preemptive scheduling. The
+* scheduling events match starting them one at a time, and the processes left waiting join
+* the ready queue in one merge
+* @param schedulerHandler: A reference to the current scheduler
+* @param events: the op code 1 events, all at the current time
+* @param count: number of events
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to each new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void preemptive_process_start_batch(SchedulerHandler* schedulerHandler, const Event_t* events, int count, Procsim_PID* PID_tracker, Procsim_Time* current_time) {
+	// Each start leaves at most one process waiting
+	PCB_t* stack_waiting[HANDLER_STACK_PROCESSES];
+	PCB_t** waiting_processes = get_process_buffer(stack_waiting, count);
+	int waiting_count = 0;
+	for (int i = 0; i < count; i++) {
+		PCB_t* waiting_process = admit_process(schedulerHandler, events[i].argument, (int)events[i].extra, PID_tracker, *current_time);
+		if (waiting_process != NULL) {
+			waiting_processes[waiting_count++] = waiting_process;
+		}
 	}
+
+	schedulerHandler->ready_pending = 0;
+	enqueue_ready_processes(schedulerHandler, waiting_processes, waiting_count, *current_time);
+	release_process_buffer(waiting_processes, stack_waiting);
 }
 
 /**
 * @brief Handles the event where an active process requests an I/O device using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
 * @param current_time: reference to the current time, used for analytics marking events
 */
-void preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time) {
+void preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
 	// Send the current PCB to the desired I/O device
 	PCB_t* io_requested_process = schedulerHandler->CPU;
 	io_requested_process->state = BLOCKED;
-	printf("%d: Process with PID: %d waiting for I/O device %d\n", *current_time, io_requested_process->PID, io_device->id);
-	add_io_request(io_device, io_requested_process);
+	io_requested_process->target_io_device = io_device->id;
+	io_requested_process->target_sector = sector;
 
 	// Process analytics
-	io_requested_process->start_io_blocked_time = *current_time;
+	store->start_io_blocked_time[io_requested_process->slot] = *current_time;
+
+	add_io_request(io_device, io_requested_process, *current_time);
+	log_event(schedulerHandler, LOG_IO_WAITING, *current_time, io_requested_process, io_device);
+	charge_switch_out(store, io_requested_process, false);
 
 	// CPU next process logic
-	if (get_size_priority_queue(schedulerHandler->queue) > 0){
+	if (get_ready_queue_length(schedulerHandler) > 0){
 		// If there are processes in the queue, send the first in line to the CPU
-		PCB_t* new_process = dequeue_priority_queue((PriorityQueue_t*)schedulerHandler->queue);
+		PCB_t* new_process = dequeue_ready_process(schedulerHandler, *current_time);
 		new_process->state = RUNNING;
 
 		schedulerHandler->CPU = new_process;  // Assign the new process to the CPU
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// Process analytics
-		new_process->end_ready_time = *current_time;
-		new_process->total_ready_time += new_process->end_ready_time - new_process->start_ready_time;
+		store->total_ready_time[new_process->slot] += *current_time - store->start_ready_time[new_process->slot];
 	} else {
 		// If there are no processes in the queue, the CPU goes idle
 		schedulerHandler->CPU = NULL;
@@ -108,21 +193,30 @@ void preemptive_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_d
 * @brief Handles the event where an I/O device completes its tasks using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
 * @param current_time: reference to the current time, used for analytics marking events
 */
-void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int* current_time) {
-	/// Remove the processes from the I/O device
-	int io_device_queue_size = io_device->queue.size + 1;
-	PCB_t* io_processes[io_device_queue_size];
-	// Dump all processes into the temp array
-	for (int i = 0; i < io_device_queue_size; i++) {
-		io_processes[i] = complete_current_io_operation(io_device);
+void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Remove the processes from the I/O device. Submitted events always release one, but a
+	// completion with nothing to release leaves everything as it was
+	int request_count = get_io_request_count(io_device);
+	if (request_count == 0) {
+		return;
+	}
+	PCB_t* stack_processes[HANDLER_STACK_PROCESSES];
+	PCB_t** io_processes = get_process_buffer(stack_processes, request_count);
+	int io_device_queue_size = release_io_requests(io_device, PID, *current_time, io_processes);
+	if (io_device_queue_size == 0) {
+		release_process_buffer(io_processes, stack_processes);
+		return;
 	}
 
 	// Process analytics
 	for (int i = 0; i < io_device_queue_size; i++) {
-		io_processes[i]->end_io_blocked_time = *current_time;
-		io_processes[i]->total_io_blocked_time += io_processes[i]->end_io_blocked_time - io_processes[i]->start_io_blocked_time;
+		store->total_io_blocked_time[io_processes[i]->slot] += *current_time - store->start_io_blocked_time[io_processes[i]->slot];
+		log_event(schedulerHandler, LOG_IO_RELEASED, *current_time, io_processes[i], io_device);
 	}
 
 	// If necessary, sort the io processes array based on priority of the processes
@@ -132,22 +226,21 @@ void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_
 	}
 
 	// Print IO complete for this device
-	printf("%d: I/O completed for I/O device %d\n", *current_time, io_device->id);
+	log_event(schedulerHandler, LOG_IO_COMPLETED, *current_time, NULL, io_device);
+	charge_io_interrupt(store);
 
-	// CPU next process logic
+	// CPU next process logic. The processes left waiting join the queue in one merge
+	PCB_t* stack_waiting[HANDLER_STACK_PROCESSES];
+	PCB_t** waiting_processes = get_process_buffer(stack_waiting, io_device_queue_size + 1);
+	int waiting_count = 0;
+	int first_waiting = 1;
 	if (schedulerHandler->CPU == NULL){
 		// If no process is currently running in the CPU, send the first process to the CPU
 		// and the rest to the queue
 		io_processes[0]->state = RUNNING;
 		schedulerHandler->CPU = io_processes[0];
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, io_processes[0]->PID, io_processes[0]->priority);
-
-		// Queue remaining processes
-		for (int i = 1; i < io_device_queue_size; i++) {
-			io_processes[i]->state = READY;
-			io_processes[i]->start_ready_time = *current_time;
-			enqueue_priority_queue(schedulerHandler->queue, io_processes[i]);
-		}
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, io_processes[0], NULL);
+		charge_dispatch(store);
 
 		// System analytics
 		schedulerHandler->end_idle_time = *current_time;
@@ -155,55 +248,62 @@ void preemptive_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_
 	} else if (schedulerHandler->CPU->priority < io_processes[0]->priority) {
 		// First process is of higher priority than current process, assign new process to CPU
 		// and the rest to the queue
-		schedulerHandler->CPU->state = READY;
-		schedulerHandler->CPU->start_ready_time = *current_time;
-		enqueue_priority_queue(schedulerHandler->queue, schedulerHandler->CPU);
+		PCB_t* preempted_process = schedulerHandler->CPU;
+		preempted_process->state = READY;
+		store->start_ready_time[preempted_process->slot] = *current_time;
+		waiting_processes[waiting_count++] = preempted_process;
+		schedulerHandler->ready_pending++;
+		log_event(schedulerHandler, LOG_PROCESS_PREEMPTED, *current_time, preempted_process, NULL);
+		charge_switch_out(store, preempted_process, true);
 		io_processes[0]->state = RUNNING;
 		schedulerHandler->CPU = io_processes[0];
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, io_processes[0]->PID, io_processes[0]->priority);
-
-		// Queue remaining processes
-		for (int i = 1; i < io_device_queue_size; i++) {
-			io_processes[i]->state = READY;
-			io_processes[i]->start_ready_time = *current_time;
-			enqueue_priority_queue(schedulerHandler->queue, io_processes[i]);
-		}
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, io_processes[0], NULL);
+		charge_dispatch(store);
 	} else {
 		// First process is of lower or equal priority than current process, add all processes to queue
-		for (int i = 0; i < io_device_queue_size; i++) {
-			io_processes[i]->state = READY;
-			io_processes[i]->start_ready_time = *current_time;
-			enqueue_priority_queue(schedulerHandler->queue, io_processes[i]);
-		}
+		first_waiting = 0;
 	}
 
+	// Queue remaining processes
+	for (int i = first_waiting; i < io_device_queue_size; i++) {
+		io_processes[i]->state = READY;
+		store->start_ready_time[io_processes[i]->slot] = *current_time;
+		waiting_processes[waiting_count++] = io_processes[i];
+		schedulerHandler->ready_pending++;
+		log_event(schedulerHandler, LOG_PROCESS_READY, *current_time, io_processes[i], NULL);
+	}
+	schedulerHandler->ready_pending = 0;
+	enqueue_ready_processes(schedulerHandler, waiting_processes, waiting_count, *current_time);
+	release_process_buffer(waiting_processes, stack_waiting);
+	release_process_buffer(io_processes, stack_processes);
 }
 
 /**
 * @brief Handles the event where an active process terminates using preemptive scheduling
 * @param schedulerHandler: A reference to the current scheduler
 * @param current_time: reference to the current time, used for analytics marking events
-* @return a copy of the completed process
 */
-PCB_t preemptive_process_end(SchedulerHandler* schedulerHandler, int* current_time) {
-	// Retrieve and free memory of current process
+void preemptive_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Retrieve the current process and record it in the completed process analytics
 	PCB_t* ended_process = schedulerHandler->CPU;
-	const PCB_t temp = *ended_process;
-	printf("%d: Ending process with PID: %d\n", *current_time, ended_process->PID);
-	free(ended_process);
+	log_event(schedulerHandler, LOG_PROCESS_ENDED, *current_time, ended_process, NULL);
+	charge_switch_out(store, ended_process, false);
+	complete_pcb(store, ended_process);
 
 	// CPU next process logic
-	if (get_size_priority_queue(schedulerHandler->queue) > 0){
+	if (get_ready_queue_length(schedulerHandler) > 0){
 		// If there are processes in the queue, send the first in line to the CPU
-		PCB_t* new_process = dequeue_priority_queue((PriorityQueue_t*)schedulerHandler->queue);
+		PCB_t* new_process = dequeue_ready_process(schedulerHandler, *current_time);
 		new_process->state = RUNNING;
 
 		schedulerHandler->CPU = new_process;  // Assign the new process to the CPU
-		printf("%d: Process scheduled to run with PID: %d PRIORITY: %d\n", *current_time, new_process->PID, new_process->priority);
+		log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, *current_time, new_process, NULL);
+		charge_dispatch(store);
 
 		// Process analytics
-		new_process->end_ready_time = *current_time;
-		new_process->total_ready_time += new_process->end_ready_time - new_process->start_ready_time;
+		store->total_ready_time[new_process->slot] += *current_time - store->start_ready_time[new_process->slot];
 	} else {
 		// If there are no processes in the queue, the CPU goes idle
 		schedulerHandler->CPU = NULL;
@@ -211,8 +311,6 @@ PCB_t preemptive_process_end(SchedulerHandler* schedulerHandler, int* current_ti
 		// System analytics
 		schedulerHandler->start_idle_time = *current_time;
 	}
-
-	return temp;
 }
 
 // Comparison function for sorting in descending order
@@ -11,10 +11,55 @@
 
 // Header imports
 #include "priority_queue.h"
+#include "fatal_error.h"
 // Library imports
-#include <stdio.h>
 #include <stdlib.h>
 
+// Batch entries kept on the stack, larger batches are allocated
+#define BATCH_STACK_ENTRIES 256
+
+/**
+* @struct BatchEntry_t
+* @brief Defines a PCB of a batch with where one-at-a-time enqueueing would put it among the
+* PCB's of equal priority. The list is ordered by priority, and between equals a PCB goes
+* after the others when its priority is the lowest in the list, right after the first one
+* when its priority is the highest, and before them otherwise
+*/
+typedef struct batch_entry {
+	PCB_t* pcb;
+	int index;			// Position in the batch
+	int highest;		// Highest and lowest priority in the list when the PCB would be enqueued
+	int lowest;
+	bool list_empty;
+	int order;			// Position among equal priorities. Below 0 goes before the first PCB
+						// already in the list, 0 starts a new priority, up to 2 * count goes
+						// right after the first PCB, above that after the last
+} BatchEntry_t;
+
+/**
+* @brief Orders batch entries by priority, highest first, then by position in the batch
+*/
+static int compare_batch_index(const void* a, const void* b) {
+	const BatchEntry_t* first = (const BatchEntry_t*)a;
+	const BatchEntry_t* second = (const BatchEntry_t*)b;
+	if (first->pcb->priority != second->pcb->priority) {
+		return second->pcb->priority - first->pcb->priority;
+	}
+	return first->index - second->index;
+}
+
+/**
+* @brief Orders batch entries by priority, highest first, then by their order among equals
+*/
+static int compare_batch_order(const void* a, const void* b) {
+	const BatchEntry_t* first = (const BatchEntry_t*)a;
+	const BatchEntry_t* second = (const BatchEntry_t*)b;
+	if (first->pcb->priority != second->pcb->priority) {
+		return second->pcb->priority - first->pcb->priority;
+	}
+	return first->order - second->order;
+}
+
 /**
 * @brief Initializes the contents of the priority queue struct to null
 * @param queue: the queue to initialize
@@ -31,39 +76,166 @@ void initialize_priority_queue(PriorityQueue_t* queue) {
 * @param data: PCB data to add
 */
 void enqueue_priority_queue(PriorityQueue_t* queue, PCB_t* data) {
-	Node* newNode = createNode(data);
+	data->next = NULL;
 	if (is_empty_priority_queue(queue)) {
-		// Initialize queue with head and tail pointers to first node
-		queue->head = newNode;
-		queue->tail = newNode;
-	} else if (data->priority > queue->head->data->priority) {
+		// Initialize queue with head and tail pointers to first PCB
+		queue->head = data;
+		queue->tail = data;
+	} else if (data->priority > queue->head->priority) {
 		// If the new PCB has higher priority than the head, insert at the head
-		newNode->next = queue->head;
-		queue->head = newNode;
-	} else if (newNode->data->priority <= queue->tail->data->priority) {
+		data->next = queue->head;
+		queue->head = data;
+	} else if (data->priority <= queue->tail->priority) {
 		// If the new PCB has a lower priority than the tail, insert at the tail
-		queue->tail->next = newNode;
-		queue->tail = newNode;
+		queue->tail->next = data;
+		queue->tail = data;
 	} else {
-		// Create pointer to traverse priority queue and search for
-		// insertion point
-		Node* temp = queue->head;
-
-		// If it's not higher priority than head, traverse the queue till
-		// an insertion point is found
-		while (temp->next != NULL && newNode->data->priority < temp->next->data->priority) {
-			temp = temp->next;
-		}
+		insert_priority_queue_after_head(queue, data);
+		return;
+	}
+
+	queue->size++;
+}
 
-		// Insert new node in between current two nodes
-		Node* oldNext = temp->next;
-		temp->next = newNode;
-		newNode->next = oldNext;
+/**
+* @brief Adds a PCB to a non-empty priority queue the way enqueue_priority_queue places a
+* priority between the head and tail ones: before the first PCB past the head whose priority
+* is not above its own, or at the tail if there is none
+* @param queue: The head of priority queue
+* @param data: PCB data to add
+*/
+void insert_priority_queue_after_head(PriorityQueue_t* queue, PCB_t* data) {
+	// Create pointer to traverse priority queue and search for
+	// insertion point
+	PCB_t* temp = queue->head;
+
+	// If it's not higher priority than head, traverse the queue till
+	// an insertion point is found
+	while (temp->next != NULL && data->priority < temp->next->priority) {
+		temp = temp->next;
+	}
+
+	// Insert new PCB in between current two PCB's
+	data->next = temp->next;
+	temp->next = data;
+	if (data->next == NULL) {
+		queue->tail = data;
 	}
 
 	queue->size++;
 }
 
+/**
+* @brief Adds PCBs to the priority queue in one merge. The queue ends up exactly as enqueueing
+* them one at a time in array order would leave it
+* @param queue: The head of priority queue
+* @param data: PCB's to add
+* @param count: number of PCB's
+*/
+void enqueue_batch_priority_queue(PriorityQueue_t* queue, PCB_t** data, int count) {
+	if (count == 1) {
+		enqueue_priority_queue(queue, data[0]);
+	}
+	if (count <= 1) {
+		return;
+	}
+
+	// Track the priority range the list would have as each PCB arrives. A batch can be the whole
+	// request list of a device on an I/O completion, or the whole ready queue on a policy switch
+	BatchEntry_t stack_entries[BATCH_STACK_ENTRIES];
+	BatchEntry_t* entries = stack_entries;
+	if (count > BATCH_STACK_ENTRIES) {
+		entries = (BatchEntry_t*)malloc(count * sizeof(BatchEntry_t));
+		if (entries == NULL) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+	}
+	bool list_empty = is_empty_priority_queue(queue);
+	int highest = list_empty ? 0 : queue->head->priority;
+	int lowest = list_empty ? 0 : queue->tail->priority;
+	for (int i = 0; i < count; i++) {
+		int priority = data[i]->priority;
+		entries[i].pcb = data[i];
+		entries[i].index = i;
+		entries[i].highest = highest;
+		entries[i].lowest = lowest;
+		entries[i].list_empty = list_empty;
+		if (list_empty || priority > highest) {
+			highest = priority;
+		}
+		if (list_empty || priority < lowest) {
+			lowest = priority;
+		}
+		list_empty = false;
+	}
+
+	// Find where each PCB goes among equal priorities, walking the list once to see which
+	// priorities it already holds
+	qsort(entries, count, sizeof(BatchEntry_t), compare_batch_index);
+	const PCB_t* old = queue->head;
+	for (int i = 0; i < count; i++) {
+		BatchEntry_t* entry = &entries[i];
+		int priority = entry->pcb->priority;
+		bool has_equal = i > 0 && entries[i - 1].pcb->priority == priority;
+		if (!has_equal) {
+			while (old != NULL && old->priority > priority) {
+				old = old->next;
+			}
+			has_equal = old != NULL && old->priority == priority;
+		}
+
+		if (entry->list_empty || priority > entry->highest || priority < entry->lowest || !has_equal) {
+			entry->order = 0;
+		} else if (priority == entry->lowest) {
+			entry->order = 2 * count + 1 + entry->index;
+		} else if (priority == entry->highest) {
+			entry->order = 2 * count - entry->index;
+		} else {
+			entry->order = -1 - entry->index;
+		}
+	}
+	qsort(entries, count, sizeof(BatchEntry_t), compare_batch_order);
+
+	// Merge the batch into the list
+	PCB_t* node = queue->head;
+	PCB_t* last = NULL;
+	PCB_t* link = NULL;
+	int next = 0;
+	while (node != NULL || next < count) {
+		PCB_t* chosen = node;
+		if (next < count) {
+			const BatchEntry_t* entry = &entries[next];
+			int priority = entry->pcb->priority;
+			bool group_first = last == NULL || last->priority != priority;
+			bool before = node == NULL || node->priority < priority;
+			if (node != NULL && node->priority == priority) {
+				before = entry->order < 0 ? group_first : !group_first && entry->order <= 2 * count;
+			}
+			if (before) {
+				chosen = entry->pcb;
+				next++;
+			}
+		}
+		if (chosen == node) {
+			last = node;
+			node = node->next;
+		}
+
+		if (link == NULL) {
+			queue->head = chosen;
+		} else {
+			link->next = chosen;
+		}
+		link = chosen;
+	}
+	link->next = NULL;
+	queue->tail = link;
+	queue->size += count;
+	if (entries != stack_entries) {
+		free(entries);
+	}
+}
+
 /**
 * @brief Removes the first element in the priority queue
 * @param queue: The head of priority queue
@@ -72,11 +244,10 @@ void enqueue_priority_queue(PriorityQueue_t* queue, PCB_t* data) {
 PCB_t* dequeue_priority_queue(PriorityQueue_t* queue) {
 	if (is_empty_priority_queue(queue)) {
 		// Queue is empty, throw an error
-		fprintf(stderr, "ERROR: Queue is already empty!\n");
-		exit(1);
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Queue is already empty!");
 	}
 
-	Node* temp = queue->head;
+	PCB_t* dequeuedData = queue->head;
 	queue->head = queue->head->next;
 	if (queue->head == NULL) {
 		// If the queue is now empty, update the tail to NULL as well
@@ -85,9 +256,8 @@ PCB_t* dequeue_priority_queue(PriorityQueue_t* queue) {
 
 	queue->size--;
 
-	// Return the PCB data of the first element in the queue
-	PCB_t* dequeuedData = temp->data;
-	free(temp); // Deallocate the memory of the node
+	// Unlink and return the first PCB in the queue
+	dequeuedData->next = NULL;
 	return dequeuedData;
 }
 
@@ -98,11 +268,10 @@ PCB_t* dequeue_priority_queue(PriorityQueue_t* queue) {
 */
 PCB_t peek_priority_queue(const PriorityQueue_t* queue) {
 	if (is_empty_priority_queue(queue)) {
-		printf("ERROR: Queue is empty!\n");
-		exit(1);
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Queue is empty!");
 	}
 
-	return *queue->head->data;
+	return *queue->head;
 }
 
 /**
@@ -128,27 +297,9 @@ int get_size_priority_queue(const PriorityQueue_t* queue) {
 }
 
 /**
-* @brief For debugging purposes, prints the contents of the queue
-* @param queue: contents to print
+* @brief empties the priority queue. The PCB's are owned by the PCB store and are left alone
+* @param queue: priority queue to empty
 */
-void dump_priority_queue(PriorityQueue_t* queue) {
-	Node* temp = queue->head;
-	int i = 0;
-	while (temp != NULL) {
-		printf("Node #%d: ID: %d, Priority %d | ", i++, temp->data->PID, temp->data->priority);
-		temp = temp->next;
-	}
-}
-
-/**
-* @brief clears the contents of the priority queue from memory
-* @param queue: priority queue to clear from memory
-*/
-void free_priority_queue(const PriorityQueue_t* queue) {
-	Node* head = queue->head;
-	while (head != NULL) {
-		Node *temp = head;
-		head = head->next;
-		free(temp);
-	}
+void free_priority_queue(PriorityQueue_t* queue) {
+	initialize_priority_queue(queue);
 }
@@ -13,7 +13,6 @@
 
 // Header imports
 #include "PCB.h"
-#include "Node.h"
 // Library imports
 #include <stdbool.h>
 
@@ -23,8 +22,8 @@
 * @brief Defines the attributes of a priority_queue
 */
 typedef struct priority_queue{
-	Node* head;
-	Node* tail;
+	PCB_t* head;	// Linked through the PCB's next field
+	PCB_t* tail;
 	int size;
 }PriorityQueue_t;
 
@@ -41,6 +40,24 @@ void initialize_priority_queue(PriorityQueue_t* queue);
 */
 void enqueue_priority_queue(PriorityQueue_t* queue, PCB_t* data);
 
+/**
+* @brief Adds a PCB to a non-empty priority queue the way enqueue_priority_queue places a
+* priority between the head and tail ones: before the first PCB past the head whose priority
+* is not above its own, or at the tail if there is none
+* @param queue: The head of priority queue
+* @param data: PCB data to add
+*/
+void insert_priority_queue_after_head(PriorityQueue_t* queue, PCB_t* data);
+
+/**
+* @brief Adds PCBs to the priority queue in one merge. The queue ends up exactly as enqueueing
+* them one at a time in array order would leave it
+* @param queue: The head of priority queue
+* @param data: PCB's to add
+* @param count: number of PCB's
+*/
+void enqueue_batch_priority_queue(PriorityQueue_t* queue, PCB_t** data, int count);
+
 /**
 * @brief Removes the first element in the priority queue
 * @param queue: The head of priority queue
@@ -70,15 +87,9 @@ bool is_empty_priority_queue(const PriorityQueue_t* queue);
 int get_size_priority_queue(const PriorityQueue_t* queue);
 
 /**
-* @brief For debugging purposes, prints the contents of the queue
-* @param queue: contents to print
-*/
-void dump_priority_queue(PriorityQueue_t* queue);
-
-/**
-* @brief clears the contents of the priority queue from memory
-* @param queue: priority queue to clear from memory
+* @brief empties the priority queue. The PCB's are owned by the PCB store and are left alone
+* @param queue: priority queue to empty
 */
-void free_priority_queue(const PriorityQueue_t* queue);
+void free_priority_queue(PriorityQueue_t* queue);
 
 #endif //PRIORITY_QUEUE_H
@@ -0,0 +1,961 @@
+/**
+ * @file procsim.c
+ * @brief Defines the public interface of libprocsim. Events are checked here and handed to
+ *		  the handlers of the simulator's scheduler
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "procsim_internal.h"
+#include "instrumentation.h"
+#include "fatal_error.h"
+// Library imports
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Descriptions, indexed by Procsim_Status
+static const char* status_messages[] = {
+	"Event handled",
+	"No such I/O device",
+	"No process is running",
+	"No matching I/O request on the device",
+	"No such process group",
+	"Sector address out of range",
+};
+
+static const char* scheduling_policy_names[SCHEDULE_POLICY_COUNT] = {
+	"fifo", "priority", "sjf", "srtf", "fair"
+};
+
+static const char* ready_queue_backend_names[READY_QUEUE_BACKEND_COUNT] = {
+	"list", "buckets", "heap"
+};
+
+/**
+* @brief Creates a simulator with every device serviced first in, first out on one channel
+* @param preemptive: whether the scheduler preempts the running process for a higher priority
+* @param device_count: number of I/O devices, 1 to PROCSIM_MAX_DEVICES
+* @return the simulator, or NULL if the device count is out of range
+*/
+Procsim_t* procsim_create(bool preemptive, int device_count) {
+	if (device_count < 1 || device_count > PROCSIM_MAX_DEVICES) {
+		return NULL;
+	}
+
+	Procsim_t* simulator = (Procsim_t*)malloc(sizeof(Procsim_t));
+	IO_Device_t* io_devices = (IO_Device_t*)malloc(device_count * sizeof(IO_Device_t));
+	if (!simulator || !io_devices) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+
+	simulator->scheduling_policy = preemptive ? SCHEDULE_PRIORITY : SCHEDULE_FIFO;
+	simulator->PID_tracker = 1;
+	simulator->events_processed = 0;
+	simulator->last_event_time = 0;
+	initialize_pcb_store(&simulator->pcb_store);
+	simulator->io_devices = io_devices;
+	simulator->io_device_count = device_count;
+	for (int i = 0; i < device_count; i++) {
+		initialize_io_device(&io_devices[i], i, &simulator->pcb_store);
+	}
+	initialize_scheduler_handler(&simulator->scheduler_handler, io_devices, &simulator->pcb_store,
+								 simulator->scheduling_policy);
+	return simulator;
+}
+
+/**
+* @brief Clears a simulator and everything it owns from memory
+* @param simulator: the simulator to destroy
+*/
+void procsim_destroy(Procsim_t* simulator) {
+	free_scheduler_handler(&simulator->scheduler_handler);
+	if (simulator->scheduler_handler.ready_spill != NULL) {
+		free_ready_spill(simulator->scheduler_handler.ready_spill);
+		free(simulator->scheduler_handler.ready_spill);
+	}
+	if (simulator->scheduler_handler.adaptive_queue != NULL) {
+		free_adaptive_queue(simulator->scheduler_handler.adaptive_queue);
+		free(simulator->scheduler_handler.adaptive_queue);
+	}
+	for (int i = 0; i < simulator->io_device_count; i++) {
+		free_io_device(&simulator->io_devices[i]);
+	}
+	free(simulator->io_devices);
+	free_pcb_store(&simulator->pcb_store);
+	free(simulator);
+}
+
+/**
+* @brief Replaces the scheduler of a simulator, keeping its record callback, reporting, spill and
+* adaptive ready queue.
+* The ready queue must be empty and the CPU idle
+* @param simulator: the simulator
+* @param policy: the scheduling policy
+*/
+void set_procsim_scheduler(Procsim_t* simulator, Scheduling_Policy policy) {
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	ProcsimRecordCallback callback = scheduler_handler->record_callback;
+	void* context = scheduler_handler->record_context;
+	bool reporting = scheduler_handler->print_events;
+	ReadySpill_t* ready_spill = scheduler_handler->ready_spill;
+	AdaptiveQueue_t* adaptive_queue = scheduler_handler->adaptive_queue;
+
+	free_scheduler_handler(scheduler_handler);
+	simulator->scheduling_policy = policy;
+	initialize_scheduler_handler(scheduler_handler, simulator->io_devices, &simulator->pcb_store, policy);
+
+	scheduler_handler->record_callback = callback;
+	scheduler_handler->record_context = context;
+	scheduler_handler->print_events = reporting;
+	scheduler_handler->ready_spill = ready_spill;
+	scheduler_handler->adaptive_queue = adaptive_queue;
+}
+
+/**
+* @brief Branches a simulator. The fork holds an independent copy of the complete state (the
+* scheduler, the ready queue, the devices and every PCB), so both can handle different events
+* or settings from here on. The fork starts with the same record callback and reporting. Spilled
+* processes, and those held by an adaptive backend, are copied back into the fork's ready queue
+* list, which keeps them all there
+* @param simulator: the simulator to branch
+* @return the fork, destroyed separately
+*/
+Procsim_t* procsim_fork(const Procsim_t* simulator) {
+	Procsim_t* fork = (Procsim_t*)malloc(sizeof(Procsim_t));
+	IO_Device_t* io_devices = (IO_Device_t*)malloc(simulator->io_device_count * sizeof(IO_Device_t));
+	if (!fork || !io_devices) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	*fork = *simulator;
+
+	// Every PCB keeps its slot, so pointers into the original store translate by slot
+	clone_pcb_store(&fork->pcb_store, &simulator->pcb_store);
+	fork->io_devices = io_devices;
+	for (int i = 0; i < simulator->io_device_count; i++) {
+		clone_io_device(&io_devices[i], &simulator->io_devices[i], &fork->pcb_store);
+	}
+
+	// Both list types share the same layout, their links live in the cloned PCB's
+	const SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	void* fork_queue;
+	if (simulator->scheduling_policy == SCHEDULE_FAIR_SHARE) {
+		FairShareQueue_t* fork_groups = (FairShareQueue_t*)malloc(sizeof(FairShareQueue_t));
+		if (!fork_groups) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+		clone_fair_share_queue(fork_groups, (const FairShareQueue_t*)scheduler_handler->queue, &fork->pcb_store);
+		fork_queue = fork_groups;
+	} else if (is_shortest_job_policy(simulator->scheduling_policy)) {
+		RequestHeap_t* fork_heap = (RequestHeap_t*)malloc(sizeof(RequestHeap_t));
+		if (!fork_heap) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+		clone_request_heap(fork_heap, (const RequestHeap_t*)scheduler_handler->queue, &fork->pcb_store);
+		fork_queue = fork_heap;
+	} else {
+		const Queue_t* ready_queue = (const Queue_t*)scheduler_handler->queue;
+		Queue_t* fork_list = (Queue_t*)malloc(simulator->scheduling_policy == SCHEDULE_PRIORITY ? sizeof(PriorityQueue_t) : sizeof(Queue_t));
+		if (!fork_list) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+		fork_list->head = get_cloned_pcb(&fork->pcb_store, ready_queue->head);
+		fork_list->tail = get_cloned_pcb(&fork->pcb_store, ready_queue->tail);
+		fork_list->size = ready_queue->size;
+		fork_queue = fork_list;
+		if (scheduler_handler->ready_spill != NULL && simulator->scheduling_policy == SCHEDULE_PRIORITY) {
+			copy_spilled_processes(scheduler_handler->ready_spill, &fork->pcb_store, (PriorityQueue_t*)fork_list);
+		}
+		if (scheduler_handler->adaptive_queue != NULL && simulator->scheduling_policy == SCHEDULE_PRIORITY) {
+			copy_adaptive_queue(scheduler_handler->adaptive_queue, &fork->pcb_store, (PriorityQueue_t*)fork_list);
+		}
+	}
+
+	fork->scheduler_handler.queue = fork_queue;
+	fork->scheduler_handler.CPU = get_cloned_pcb(&fork->pcb_store, scheduler_handler->CPU);
+	fork->scheduler_handler.io_devices = io_devices;
+	fork->scheduler_handler.pcb_store = &fork->pcb_store;
+	fork->scheduler_handler.ready_spill = NULL;
+	fork->scheduler_handler.adaptive_queue = NULL;
+	return fork;
+}
+
+/**
+* @brief Checks whether no process is in the system, none running, waiting or doing I/O
+* @param simulator: the simulator
+* @return true if every process that started has ended
+*/
+bool procsim_is_idle(const Procsim_t* simulator) {
+	return simulator->pcb_store.live_count == 0;
+}
+
+/**
+* @brief Prepares a simulator that has not handled any event to take over a trace at a point
+* where no process is in the system, such as a speculative segment of a parallel run. Its
+* statistics start from zero, procsim_absorb_statistics adds those of the run before it
+* @param simulator: the simulator
+* @param next_PID: the PID the next process start gets
+* @param idle_since: time the CPU went idle
+* @param last_event_time: time of the last event before the takeover
+*/
+void procsim_start_idle_segment(Procsim_t* simulator, Procsim_PID next_PID, Procsim_Time idle_since, Procsim_Time last_event_time) {
+	simulator->PID_tracker = next_PID;
+	simulator->last_event_time = last_event_time;
+	simulator->scheduler_handler.start_idle_time = idle_since;
+}
+
+/**
+* @brief Moves the head of a device that has no requests, as a guess of where an earlier run
+* left it
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param sector: the sector under the head
+* @return true on success, false if the device is out of range or has requests
+*/
+bool procsim_set_device_head(Procsim_t* simulator, int device, int sector) {
+	if (device < 0 || device >= simulator->io_device_count || get_io_request_count(&simulator->io_devices[device]) > 0) {
+		return false;
+	}
+	simulator->io_devices[device].head_sector = sector;
+	return true;
+}
+
+/**
+* @brief Checks whether two idle simulators would handle any further events exactly alike,
+* apart from the statistics each gathered so far: same policy and settings, next PID, idle
+* start, device heads and fair-share virtual times
+* @param simulator: an idle simulator
+* @param other: another idle simulator
+* @return true if they match, false if they differ or one is not idle
+*/
+bool procsim_has_same_idle_state(const Procsim_t* simulator, const Procsim_t* other) {
+	if (!procsim_is_idle(simulator) || !procsim_is_idle(other) || simulator->scheduling_policy != other->scheduling_policy
+		|| simulator->PID_tracker != other->PID_tracker || simulator->io_device_count != other->io_device_count
+		|| simulator->scheduler_handler.start_idle_time != other->scheduler_handler.start_idle_time
+		|| !has_same_pcb_store_settings(&simulator->pcb_store, &other->pcb_store)) {
+		return false;
+	}
+	for (int i = 0; i < simulator->io_device_count; i++) {
+		if (!has_same_idle_io_device_state(&simulator->io_devices[i], &other->io_devices[i])) {
+			return false;
+		}
+	}
+
+	// Only fair-share carries scheduling state across an idle period
+	if (simulator->scheduling_policy == SCHEDULE_FAIR_SHARE) {
+		return has_same_idle_fair_share_queue((const FairShareQueue_t*)simulator->scheduler_handler.queue,
+											  (const FairShareQueue_t*)other->scheduler_handler.queue);
+	}
+	return true;
+}
+
+/**
+* @brief Adds the statistics of an earlier simulator to one that took over the trace from it at
+* an idle point, so that it reports as if it had handled the whole trace
+* @param simulator: the simulator that took over, started by procsim_start_idle_segment
+* @param earlier: the simulator of the trace up to the takeover, with the same devices
+*/
+void procsim_absorb_statistics(Procsim_t* simulator, const Procsim_t* earlier) {
+	if (simulator->events_processed == 0) {
+		simulator->last_event_time = earlier->last_event_time;
+	}
+	simulator->events_processed += earlier->events_processed;
+	simulator->scheduler_handler.total_idle_time += earlier->scheduler_handler.total_idle_time;
+	merge_pcb_store_statistics(&simulator->pcb_store, &earlier->pcb_store);
+	for (int i = 0; i < simulator->io_device_count && i < earlier->io_device_count; i++) {
+		merge_io_device_statistics(&simulator->io_devices[i], &earlier->io_devices[i]);
+	}
+}
+
+/**
+* @brief Switches the scheduling policy. The waiting processes are moved to the new ready queue
+* in their current order, or by predicted burst for SJF and SRTF, and the running process keeps
+* the CPU, so the switch takes effect at the next scheduling decision
+* @param simulator: the simulator
+* @param policy: the policy from now on
+*/
+void procsim_set_scheduling_policy(Procsim_t* simulator, Scheduling_Policy policy) {
+	Scheduling_Policy old_policy = simulator->scheduling_policy;
+	if (policy == old_policy) {
+		return;
+	}
+
+	// Detach the waiting processes in the order they would run, and keep what the new handler would reset
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	if (scheduler_handler->ready_spill != NULL && old_policy == SCHEDULE_PRIORITY) {
+		drain_ready_spill(scheduler_handler->ready_spill, &simulator->pcb_store, (PriorityQueue_t*)scheduler_handler->queue);
+	}
+	if (scheduler_handler->adaptive_queue != NULL && old_policy == SCHEDULE_PRIORITY) {
+		release_adaptive_queue(scheduler_handler->adaptive_queue, (PriorityQueue_t*)scheduler_handler->queue);
+	}
+	int waiting_count = get_ready_queue_length(scheduler_handler);
+	// The ready queue can hold millions of processes, too many for the stack
+	PCB_t** waiting = (PCB_t**)malloc((waiting_count > 0 ? waiting_count : 1) * sizeof(PCB_t*));
+	if (!waiting) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	if (is_shortest_job_policy(old_policy)) {
+		for (int i = 0; i < waiting_count; i++) {
+			waiting[i] = pop_request_heap((RequestHeap_t*)scheduler_handler->queue);
+		}
+	} else if (old_policy == SCHEDULE_FAIR_SHARE) {
+		for (int i = 0; i < waiting_count; i++) {
+			waiting[i] = dequeue_fair_share_queue((FairShareQueue_t*)scheduler_handler->queue);
+		}
+	} else {
+		Queue_t* ready_queue = (Queue_t*)scheduler_handler->queue;
+		PCB_t* pcb = ready_queue->head;
+		for (int i = 0; i < waiting_count; i++) {
+			waiting[i] = pcb;
+			pcb = pcb->next;
+			waiting[i]->next = NULL;
+		}
+		ready_queue->head = NULL;
+		ready_queue->tail = NULL;
+		ready_queue->size = 0;
+	}
+	PCB_t* CPU = scheduler_handler->CPU;
+	if (CPU != NULL && old_policy == SCHEDULE_FAIR_SHARE) {
+		// Group CPU time is only kept under fair-share, the run so far is charged before leaving it
+		simulator->pcb_store.groups.cpu_time[CPU->group] += simulator->last_event_time - simulator->pcb_store.bursts.run_start_time[CPU->slot];
+	}
+	Procsim_Time start_idle_time = scheduler_handler->start_idle_time;
+	Procsim_Time end_idle_time = scheduler_handler->end_idle_time;
+	Procsim_Time total_idle_time = scheduler_handler->total_idle_time;
+
+	set_procsim_scheduler(simulator, policy);
+	scheduler_handler->CPU = CPU;
+	scheduler_handler->start_idle_time = start_idle_time;
+	scheduler_handler->end_idle_time = end_idle_time;
+	scheduler_handler->total_idle_time = total_idle_time;
+
+	// Runs are only timed under SJF, SRTF and fair-share, so a run in progress is timed from the switch
+	if (CPU != NULL && (policy == SCHEDULE_FAIR_SHARE || is_shortest_job_policy(policy))
+		&& (old_policy == SCHEDULE_FIFO || old_policy == SCHEDULE_PRIORITY)) {
+		simulator->pcb_store.bursts.run_start_time[CPU->slot] = simulator->last_event_time;
+	}
+
+	if (policy == SCHEDULE_PRIORITY) {
+		// The priority queue takes the waiting processes in one merge
+		enqueue_ready_processes(scheduler_handler, waiting, waiting_count, simulator->last_event_time);
+		free(waiting);
+		return;
+	}
+	for (int i = 0; i < waiting_count; i++) {
+		if (policy == SCHEDULE_FIFO) {
+			enqueue_queue((Queue_t*)scheduler_handler->queue, waiting[i]);
+		} else if (policy == SCHEDULE_FAIR_SHARE) {
+			enqueue_fair_share_queue((FairShareQueue_t*)scheduler_handler->queue, waiting[i]);
+		} else {
+			push_request_heap((RequestHeap_t*)scheduler_handler->queue, get_remaining_burst(&simulator->pcb_store, waiting[i]), waiting[i]);
+		}
+	}
+	free(waiting);
+}
+
+/**
+* @brief Switches between the preemptive priority and the non-preemptive FIFO policy, as
+* procsim_set_scheduling_policy does
+* @param simulator: the simulator
+* @param preemptive: whether the scheduler preempts from now on
+*/
+void procsim_set_preemptive(Procsim_t* simulator, bool preemptive) {
+	procsim_set_scheduling_policy(simulator, preemptive ? SCHEDULE_PRIORITY : SCHEDULE_FIFO);
+}
+
+/**
+* @brief Looks up the scheduling policy
+* @param simulator: the simulator
+* @return the policy
+*/
+Scheduling_Policy procsim_get_scheduling_policy(const Procsim_t* simulator) {
+	return simulator->scheduling_policy;
+}
+
+/**
+* @brief Sets how SJF and SRTF predict CPU bursts. Each process predicts its next burst as
+* alpha * last burst + (1 - alpha) * last prediction, starting from the initial prediction
+* @param simulator: the simulator
+* @param initial_burst: prediction for the first burst of a process, at least 0
+* @param alpha: weight of the last burst, 0 to 1
+* @return true on success, false if a value is out of range
+*/
+bool procsim_set_burst_prediction(Procsim_t* simulator, int initial_burst, double alpha) {
+	if (initial_burst < 0 || !(alpha >= 0.0 && alpha <= 1.0)) {
+		return false;
+	}
+	simulator->pcb_store.bursts.initial_burst = initial_burst;
+	simulator->pcb_store.bursts.alpha = alpha;
+	return true;
+}
+
+/**
+* @brief Sets the CPU share of a process group under the fair-share policy. A group with
+* weight 2 gets twice the CPU time of a group with weight 1 while both have work
+* @param simulator: the simulator
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+* @param weight: the weight, at least 1 (the default)
+* @return true on success, false if a value is out of range
+*/
+bool procsim_set_group_weight(Procsim_t* simulator, int group, int weight) {
+	if (group < 0 || group >= PROCSIM_MAX_GROUPS || weight < 1) {
+		return false;
+	}
+	reserve_process_group(&simulator->pcb_store, group);
+	simulator->pcb_store.groups.weight[group] = weight;
+	return true;
+}
+
+/**
+* @brief Sets the CPU time charged for context switches, preemptions and I/O interrupts from
+* now on. Switches are counted either way, every cost is 0 until set
+* @param simulator: the simulator
+* @param costs: the costs
+* @return true on success, false if a cost is negative
+*/
+bool procsim_set_switch_costs(Procsim_t* simulator, const SwitchCosts_t* costs) {
+	if (costs->context_switch < 0 || costs->preemption < 0 || costs->io_interrupt < 0) {
+		return false;
+	}
+	simulator->pcb_store.switches.costs = *costs;
+	simulator->pcb_store.switches.costs_set = true;
+	return true;
+}
+
+/**
+* @brief Looks up the CPU time charged for context switches, preemptions and I/O interrupts
+* @param simulator: the simulator
+* @param costs: filled in with the costs
+* @return true if the costs were set, false if they were left at 0
+*/
+bool procsim_get_switch_costs(const Procsim_t* simulator, SwitchCosts_t* costs) {
+	*costs = simulator->pcb_store.switches.costs;
+	return simulator->pcb_store.switches.costs_set;
+}
+
+/**
+* @brief Bounds the waiting processes the priority policy keeps in memory. Must be called before
+* the first event
+* @param simulator: the simulator
+* @param memory_limit: most waiting processes kept in memory, at least 2
+* @param scratch_fd: a file opened for reading and writing, closed by the caller after procsim_destroy
+* @return true on success, false if the limit is below 2, a bound is already set, the ready queue
+* is adaptive or events were handled
+*/
+bool procsim_set_ready_spill(Procsim_t* simulator, int memory_limit, int scratch_fd) {
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	if (memory_limit < 2 || scheduler_handler->ready_spill != NULL || scheduler_handler->adaptive_queue != NULL
+		|| simulator->events_processed > 0) {
+		return false;
+	}
+
+	ReadySpill_t* ready_spill = (ReadySpill_t*)malloc(sizeof(ReadySpill_t));
+	if (!ready_spill) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	initialize_ready_spill(ready_spill, memory_limit, scratch_fd);
+	scheduler_handler->ready_spill = ready_spill;
+	return true;
+}
+
+/**
+* @brief Looks up the spill and refill statistics of the scratch file
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+* @return true on success, false if the waiting processes are not bounded
+*/
+bool procsim_get_ready_spill_stats(const Procsim_t* simulator, ReadySpillStats_t* stats) {
+	const ReadySpill_t* ready_spill = simulator->scheduler_handler.ready_spill;
+	if (ready_spill == NULL) {
+		return false;
+	}
+	*stats = ready_spill->stats;
+	stats->spilled = ready_spill->spilled;
+	return true;
+}
+
+/**
+* @brief Lets the priority policy's ready queue move between a sorted list, a list per priority
+* and a heap as its depth and distinct priorities change. Processes run in the same order
+* whatever the backend. Must be called before the first event
+* @param simulator: the simulator
+* @param callback: receives each switch of backend, may be NULL
+* @param context: passed to the callback
+* @return true on success, false if the ready queue is already adaptive, it is bounded by
+* procsim_set_ready_spill or events were handled
+*/
+bool procsim_set_adaptive_ready_queue(Procsim_t* simulator, ProcsimQueueSwitchCallback callback, void* context) {
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	if (scheduler_handler->adaptive_queue != NULL || scheduler_handler->ready_spill != NULL || simulator->events_processed > 0) {
+		return false;
+	}
+
+	AdaptiveQueue_t* adaptive_queue = (AdaptiveQueue_t*)malloc(sizeof(AdaptiveQueue_t));
+	if (!adaptive_queue) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	initialize_adaptive_queue(adaptive_queue, callback, context);
+	scheduler_handler->adaptive_queue = adaptive_queue;
+	return true;
+}
+
+/**
+* @brief Looks up the backend, switches and per operation costs of an adaptive ready queue
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+* @return true on success, false if the ready queue is not adaptive
+*/
+bool procsim_get_ready_queue_stats(const Procsim_t* simulator, ReadyQueueStats_t* stats) {
+	const AdaptiveQueue_t* adaptive_queue = simulator->scheduler_handler.adaptive_queue;
+	if (adaptive_queue == NULL) {
+		return false;
+	}
+	get_adaptive_queue_stats(adaptive_queue, stats);
+	return true;
+}
+
+/**
+* @brief Looks up a device that has not received any request yet
+* @return the device, or NULL if it does not exist or is in use
+*/
+static IO_Device_t* get_unused_device(Procsim_t* simulator, int device) {
+	if (device < 0 || device >= simulator->io_device_count) {
+		return NULL;
+	}
+
+	IO_Device_t* io_device = &simulator->io_devices[device];
+	if (get_io_request_count(io_device) > 0) {
+		return NULL;
+	}
+	return io_device;
+}
+
+/**
+* @brief Sets the service policy of a device. Must be called before the device receives any request
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param policy: the policy
+* @return true on success, false if the device does not exist or already has requests
+*/
+bool procsim_set_device_policy(Procsim_t* simulator, int device, IO_Policy policy) {
+	IO_Device_t* io_device = get_unused_device(simulator, device);
+	if (io_device == NULL) {
+		return false;
+	}
+
+	io_device->policy = policy;
+	io_device->configured = true;
+	return true;
+}
+
+/**
+* @brief Sets the number of requests a device services in parallel. Must be called before
+* the device receives any request
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param queue_depth: number of service channels, at least 1
+* @return true on success, false if the device does not exist, already has requests or the depth is below 1
+*/
+bool procsim_set_device_queue_depth(Procsim_t* simulator, int device, int queue_depth) {
+	IO_Device_t* io_device = get_unused_device(simulator, device);
+	if (io_device == NULL || queue_depth < 1) {
+		return false;
+	}
+
+	set_io_queue_depth(io_device, queue_depth);
+	io_device->configured = true;
+	return true;
+}
+
+/**
+* @brief Sets the function receiving the scheduling events
+* @param simulator: the simulator
+* @param callback: the function, NULL to discard the events
+* @param context: passed to every call of the function
+*/
+void procsim_set_record_callback(Procsim_t* simulator, ProcsimRecordCallback callback, void* context) {
+	simulator->scheduler_handler.record_callback = callback;
+	simulator->scheduler_handler.record_context = context;
+}
+
+/**
+* @brief Turns the scheduling events on or off, for example to fast-forward silently
+* @param simulator: the simulator
+* @param reporting: whether events go to the callback
+*/
+void procsim_set_reporting(Procsim_t* simulator, bool reporting) {
+	simulator->scheduler_handler.print_events = reporting;
+}
+
+/**
+* @brief Checks that an event can be handled in the current state
+* @return PROCSIM_OK, or the reason the event would be rejected
+*/
+static Procsim_Status check_event(const Procsim_t* simulator, const Event_t* event) {
+	switch (event->operation_code) {
+		case 1:
+			if (event->extra < 0 || event->extra >= PROCSIM_MAX_GROUPS) {
+				return PROCSIM_INVALID_GROUP;
+			}
+			return PROCSIM_OK;
+		case 2:
+			if (event->argument < 0 || event->argument >= simulator->io_device_count) {
+				return PROCSIM_INVALID_DEVICE;
+			}
+			if (simulator->scheduler_handler.CPU == NULL) {
+				return PROCSIM_NO_RUNNING_PROCESS;
+			}
+			// The PCB keeps the sector in 32 bits to stay compact
+			if (event->extra < INT_MIN || event->extra > INT_MAX) {
+				return PROCSIM_INVALID_SECTOR;
+			}
+			return PROCSIM_OK;
+		case 3:
+			if (event->argument < 0 || event->argument >= simulator->io_device_count) {
+				return PROCSIM_INVALID_DEVICE;
+			}
+			if (get_io_request_count(&simulator->io_devices[event->argument]) == 0
+				|| (event->extra != 0 && !has_io_request_in_flight(&simulator->io_devices[event->argument], event->extra))) {
+				return PROCSIM_NO_REQUEST_IN_FLIGHT;
+			}
+			return PROCSIM_OK;
+		case 4:
+			if (simulator->scheduler_handler.CPU == NULL) {
+				return PROCSIM_NO_RUNNING_PROCESS;
+			}
+			return PROCSIM_OK;
+		default:
+			return PROCSIM_OK;
+	}
+}
+
+/**
+* @brief Handles one event. Unknown op codes are counted and otherwise ignored
+* @param simulator: the simulator
+* @param event: the event, its time no earlier than the previous event
+* @return PROCSIM_OK, or the reason the event was rejected
+*/
+Procsim_Status procsim_submit_event(Procsim_t* simulator, const Event_t* event) {
+	Procsim_Status status = check_event(simulator, event);
+	if (status != PROCSIM_OK) {
+		return status;
+	}
+
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	Procsim_Time time = event->time;
+	switch (event->operation_code) {
+		case 1: {
+			// Handle process start
+			INSTRUMENT_BEGIN(get_ready_queue_length(scheduler_handler));
+			scheduler_handler->handle_process_start(scheduler_handler, event->argument, (int)event->extra, &simulator->PID_tracker, &time);
+			INSTRUMENT_END(INSTRUMENT_PROCESS_START);
+			break;
+		}
+		case 2: {
+			// Handle I/O request
+			INSTRUMENT_BEGIN(get_ready_queue_length(scheduler_handler));
+			scheduler_handler->handle_io_request(scheduler_handler, &simulator->io_devices[event->argument], (int)event->extra, &time);
+			INSTRUMENT_END(INSTRUMENT_IO_REQUEST);
+			break;
+		}
+		case 3: {
+			// Handle I/O request complete
+			INSTRUMENT_BEGIN(get_ready_queue_length(scheduler_handler));
+			scheduler_handler->handle_io_complete(scheduler_handler, &simulator->io_devices[event->argument], event->extra, &time);
+			INSTRUMENT_END(INSTRUMENT_IO_COMPLETE);
+			break;
+		}
+		case 4: {
+			// Handle process end
+			INSTRUMENT_BEGIN(get_ready_queue_length(scheduler_handler));
+			scheduler_handler->handle_process_end(scheduler_handler, &time);
+			INSTRUMENT_END(INSTRUMENT_PROCESS_END);
+			break;
+		}
+
+		default: break;
+	}
+
+	simulator->events_processed++;
+	simulator->last_event_time = event->time;
+	return PROCSIM_OK;
+}
+
+/**
+* @brief Counts the process starts at the start of an array that can be handled in one step:
+* valid op code 1 events at the time of the first, at most PROCSIM_START_BATCH_SIZE
+* @return the length of the run, 0 if the scheduler starts processes one at a time
+*/
+static int count_start_batch(const Procsim_t* simulator, const Event_t* events, long count) {
+	if (simulator->scheduler_handler.handle_process_start_batch == NULL) {
+		return 0;
+	}
+
+	int length = 0;
+	while (length < count && length < PROCSIM_START_BATCH_SIZE && events[length].operation_code == 1
+		&& events[length].time == events[0].time && check_event(simulator, &events[length]) == PROCSIM_OK) {
+		length++;
+	}
+	return length;
+}
+
+/**
+* @brief Handles an array of events in order, stopping at the first rejected event. Process
+* starts at the same time are handled in one step where the scheduler supports it, with the
+* same scheduling events and results as one at a time
+* @param simulator: the simulator
+* @param events: the events
+* @param count: number of events
+* @param status: filled in with the status of the last event handled or rejected, may be NULL
+* @return the number of events handled
+*/
+long procsim_submit_events(Procsim_t* simulator, const Event_t* events, long count, Procsim_Status* status) {
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	Procsim_Status last_status = PROCSIM_OK;
+	long handled = 0;
+	while (handled < count) {
+		int batch = count_start_batch(simulator, &events[handled], count - handled);
+		if (batch > 1) {
+			// A rejected start ends the run, and is rejected on its own below
+			Procsim_Time time = events[handled].time;
+			INSTRUMENT_BEGIN(get_ready_queue_length(scheduler_handler));
+			scheduler_handler->handle_process_start_batch(scheduler_handler, &events[handled], batch, &simulator->PID_tracker, &time);
+			INSTRUMENT_END(INSTRUMENT_PROCESS_START);
+			simulator->events_processed += batch;
+			simulator->last_event_time = events[handled].time;
+			last_status = PROCSIM_OK;
+			handled += batch;
+			continue;
+		}
+
+		last_status = procsim_submit_event(simulator, &events[handled]);
+		if (last_status != PROCSIM_OK) {
+			break;
+		}
+		handled++;
+	}
+
+	if (status != NULL) {
+		*status = last_status;
+	}
+	return handled;
+}
+
+/**
+* @brief Fills in the statistics of the run so far
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+*/
+void procsim_get_stats(const Procsim_t* simulator, ProcsimStats_t* stats) {
+	stats->events_processed = simulator->events_processed;
+	stats->last_event_time = simulator->last_event_time;
+	stats->idle_time = simulator->scheduler_handler.total_idle_time;
+	stats->processes_started = simulator->PID_tracker - 1;
+	stats->processes_live = simulator->pcb_store.live_count;
+	if (simulator->scheduler_handler.ready_spill != NULL) {
+		// Spilled processes gave up their PCB's but are still in the system
+		stats->processes_live += simulator->scheduler_handler.ready_spill->spilled;
+	}
+	get_wait_time_totals(&simulator->pcb_store, stats);
+	stats->bursts_predicted = simulator->pcb_store.bursts.bursts;
+	stats->total_prediction_error = simulator->pcb_store.bursts.total_error;
+	stats->max_prediction_error = simulator->pcb_store.bursts.max_error;
+	stats->dispatches = simulator->pcb_store.switches.dispatches;
+	stats->voluntary_switches = simulator->pcb_store.switches.voluntary_total;
+	stats->involuntary_switches = simulator->pcb_store.switches.involuntary_total;
+	stats->io_interrupts = simulator->pcb_store.switches.io_interrupts;
+	stats->switch_overhead_time = simulator->pcb_store.switches.overhead_time;
+}
+
+/**
+* @brief Counts the completed processes, without the wait time reductions of procsim_get_stats
+* @param simulator: the simulator
+* @return the number of completed processes
+*/
+long procsim_get_completed_count(const Procsim_t* simulator) {
+	return simulator->pcb_store.completed.discarded + simulator->pcb_store.completed.size;
+}
+
+/**
+* @brief Bounds the number of completed processes whose analytics are kept
+* @param simulator: the simulator
+* @param limit: the most results to keep, 0 to keep every result
+*/
+void procsim_set_result_retention(Procsim_t* simulator, int limit) {
+	CompletedProcesses_t* completed = &simulator->pcb_store.completed;
+	completed->retention = limit > 0 && limit < 2 ? 2 : limit;
+	if (completed->retention > 0 && completed->size > completed->retention) {
+		discard_completed_processes(completed, completed->size - completed->retention);
+	}
+}
+
+/**
+* @brief Copies the analytics of completed processes, in completion order
+* @param simulator: the simulator
+* @param first: index of the first retained process to copy
+* @param count: the most results to copy
+* @param results: array of at least count entries
+* @return the number of results copied
+*/
+int procsim_get_process_results(const Procsim_t* simulator, int first, int count, ProcessResult_t* results) {
+	const CompletedProcesses_t* completed = &simulator->pcb_store.completed;
+	if (first < 0 || first >= completed->size || count <= 0) {
+		return 0;
+	}
+	if (count > completed->size - first) {
+		count = completed->size - first;
+	}
+
+	for (int i = 0; i < count; i++) {
+		results[i].PID = completed->PID[first + i];
+		results[i].priority = completed->priority[first + i];
+		results[i].ready_wait_time = completed->ready_wait_time[first + i];
+		results[i].io_wait_time = completed->io_wait_time[first + i];
+		results[i].voluntary_switches = completed->voluntary_switches[first + i];
+		results[i].involuntary_switches = completed->involuntary_switches[first + i];
+	}
+	return count;
+}
+
+/**
+* @brief Fills in the configuration and analytics of a device
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param stats: the statistics to fill in
+* @return true on success, false if the device does not exist
+*/
+bool procsim_get_device_stats(const Procsim_t* simulator, int device, DeviceStats_t* stats) {
+	if (device < 0 || device >= simulator->io_device_count) {
+		return false;
+	}
+
+	get_io_device_stats(&simulator->io_devices[device], stats);
+	return true;
+}
+
+/**
+* @brief Counts the process groups, one more than the highest group id seen or weighted
+* @param simulator: the simulator
+* @return the number of groups
+*/
+int procsim_get_group_count(const Procsim_t* simulator) {
+	return simulator->pcb_store.groups.count;
+}
+
+/**
+* @brief Looks up the weight and analytics of a process group
+* @param simulator: the simulator
+* @param group: the group id
+* @param stats: the statistics to fill in
+* @return true on success, false if the group is out of range
+*/
+bool procsim_get_group_stats(const Procsim_t* simulator, int group, GroupStats_t* stats) {
+	const ProcessGroups_t* groups = &simulator->pcb_store.groups;
+	if (group < 0 || group >= groups->count) {
+		return false;
+	}
+
+	stats->group = group;
+	stats->weight = groups->weight[group];
+	stats->active = groups->processes_started[group] > 0;
+	stats->processes_started = groups->processes_started[group];
+	stats->processes_completed = groups->processes_completed[group];
+	stats->cpu_time = groups->cpu_time[group];
+	stats->total_ready_wait_time = groups->total_ready_wait_time[group];
+	stats->max_ready_wait_time = groups->max_ready_wait_time[group];
+	return true;
+}
+
+/**
+* @brief Checks whether the simulator preempts
+* @param simulator: the simulator
+* @return true for a preemptive scheduler
+*/
+bool procsim_is_preemptive(const Procsim_t* simulator) {
+	return simulator->scheduling_policy == SCHEDULE_PRIORITY || simulator->scheduling_policy == SCHEDULE_SRTF;
+}
+
+/**
+* @brief Counts the devices of the simulator
+* @param simulator: the simulator
+* @return the number of devices
+*/
+int procsim_get_device_count(const Procsim_t* simulator) {
+	return simulator->io_device_count;
+}
+
+/**
+* @brief Counts the processes waiting to run
+* @param simulator: the simulator
+* @return the ready queue length
+*/
+int procsim_get_ready_queue_length(const Procsim_t* simulator) {
+	return get_ready_queue_length(&simulator->scheduler_handler);
+}
+
+/**
+* @brief Checks whether a process is on the CPU
+* @param simulator: the simulator
+* @return true if the CPU is busy
+*/
+bool procsim_is_cpu_busy(const Procsim_t* simulator) {
+	return simulator->scheduler_handler.CPU != NULL;
+}
+
+/**
+* @brief Counts every request on a device, in flight or waiting
+* @param simulator: the simulator
+* @param device: the device identifier, must exist
+* @return the number of requests
+*/
+int procsim_get_device_request_count(const Procsim_t* simulator, int device) {
+	return get_io_request_count(&simulator->io_devices[device]);
+}
+
+/**
+* @brief Converts a scheduling policy name (fifo, priority, sjf, srtf) into a policy
+* @param name: the policy name
+* @param policy: filled in with the matching policy
+* @return true if the name was recognized, false if not
+*/
+bool parse_scheduling_policy(const char* name, Scheduling_Policy* policy) {
+	for (int i = 0; i < SCHEDULE_POLICY_COUNT; i++) {
+		if (strcmp(name, scheduling_policy_names[i]) == 0) {
+			*policy = (Scheduling_Policy)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+* @brief Converts a scheduling policy into its name
+* @param policy: the policy
+* @return the policy name
+*/
+const char* get_scheduling_policy_name(Scheduling_Policy policy) {
+	return scheduling_policy_names[policy];
+}
+
+/**
+* @brief Converts a ready queue backend into its name
+* @param backend: the backend
+* @return the backend name
+*/
+const char* get_ready_queue_backend_name(Ready_Queue_Backend backend) {
+	return ready_queue_backend_names[backend];
+}
+
+/**
+* @brief Describes a submission status
+* @param status: the status
+* @return the description
+*/
+const char* procsim_get_status_message(Procsim_Status status) {
+	return status_messages[status];
+}
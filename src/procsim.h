@@ -0,0 +1,654 @@
+/**
+ * @file procsim.h
+ * @brief Declares the public interface of libprocsim, the embeddable process scheduler
+ *		  simulator. A caller creates a simulator, submits events one at a time or in arrays,
+ *		  receives scheduling events through a callback and queries the run statistics and
+ *		  per-process results. The library does no I/O of its own
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef PROCSIM_H
+#define PROCSIM_H
+
+// Library imports
+#include <stdbool.h>
+
+// Devices are numbered in a signed char of each scheduling event
+#define PROCSIM_MAX_DEVICES 127
+// Group ids of op code 1 are below this
+#define PROCSIM_MAX_GROUPS 4096
+// Process starts at the same time procsim_submit_events hands to the scheduler in one step at most
+#define PROCSIM_START_BATCH_SIZE 256
+// Burst prediction defaults of the SJF and SRTF policies
+#define DEFAULT_INITIAL_BURST 10
+#define DEFAULT_BURST_ALPHA 0.5
+
+// Times and PIDs are 64 bits, so nanosecond or multi-day traces cannot overflow them
+typedef long long Procsim_Time;
+typedef long long Procsim_PID;
+
+/**
+* @struct Event_t
+* @brief Defines a single simulation event, as read from one line of an input file
+*/
+typedef struct event_t {
+	Procsim_Time time;
+	long long extra;	// Optional, 0 when not given. Group id for op code 1, sector address for
+						// op code 2 (32-bit range), PID of the finished request for op code 3
+	int operation_code;
+	int argument;		// Priority for op code 1, device identifier for op codes 2 and 3
+} Event_t;
+
+/**
+* Defines the kinds of scheduling events
+*/
+typedef enum log_kind {
+	LOG_PROCESS_STARTED,
+	LOG_PROCESS_SCHEDULED,
+	LOG_IO_WAITING,
+	LOG_IO_COMPLETED,		// The PID and priority are 0, one record per device completion
+	LOG_PROCESS_ENDED,
+	LOG_PROCESS_PREEMPTED,	// Binary log only, the text output has no line for it
+	LOG_PROCESS_READY,		// Binary log only, a process joined the ready queue
+	LOG_IO_RELEASED,		// Binary log only, one record per process an I/O completion releases
+	LOG_KIND_COUNT,
+} Log_Kind;
+
+/**
+* @struct LogRecord_t
+* @brief Defines one scheduling event. The same packed layout sits in the log sink ring and
+* in a binary log file, after the file header
+*/
+typedef struct __attribute__((packed)) log_record {
+	Procsim_Time time;
+	Procsim_PID PID;
+	int priority;
+	int queue_length;		// Device requests for I/O events, ready queue length otherwise
+	signed char device;		// -1 for events that involve no device
+	unsigned char kind;
+} LogRecord_t;
+
+/**
+* Defines the service disciplines an I/O device can use to pick its next request
+*/
+typedef enum io_policy {
+	IO_FIFO,		// Arrival order
+	IO_PRIORITY,	// Highest process priority first, arrival order between equals
+	IO_SSTF,		// Shortest seek time first from the current head position
+	IO_SCAN,		// Elevator, sweeps up then down
+	IO_CSCAN,		// Circular elevator, sweeps up then wraps to the lowest sector
+} IO_Policy;
+
+/**
+* Defines the CPU scheduling policies. The values are the first line of an input file
+*/
+typedef enum scheduling_policy {
+	SCHEDULE_FIFO,		// Non-preemptive, arrival order
+	SCHEDULE_PRIORITY,	// Preemptive, highest priority first, arrival order between equals
+	SCHEDULE_SJF,		// Non-preemptive, shortest predicted CPU burst first
+	SCHEDULE_SRTF,		// Preemptive, shortest predicted remaining CPU burst first
+	SCHEDULE_FAIR_SHARE,	// Non-preemptive, the group furthest below its weighted CPU share, then by priority
+	SCHEDULE_POLICY_COUNT,
+} Scheduling_Policy;
+
+/**
+* Defines the outcome of submitting an event. A rejected event leaves the simulator untouched
+*/
+typedef enum procsim_status {
+	PROCSIM_OK,
+	PROCSIM_INVALID_DEVICE,			// Op codes 2 and 3 name a device the simulator does not have
+	PROCSIM_NO_RUNNING_PROCESS,		// Op codes 2 and 4 need a process on the CPU
+	PROCSIM_NO_REQUEST_IN_FLIGHT,	// Op code 3 names a device with no request, or a process the device is not servicing
+	PROCSIM_INVALID_GROUP,			// Op code 1 names a group outside 0 to PROCSIM_MAX_GROUPS - 1
+	PROCSIM_INVALID_SECTOR,			// Op code 2 names a sector outside the 32-bit range the PCB keeps
+} Procsim_Status;
+
+/**
+* Defines the errors the simulator cannot recover from
+*/
+typedef enum procsim_fatal_error {
+	PROCSIM_OUT_OF_MEMORY,
+	PROCSIM_CORRUPT_STATE,	// An internal structure was used in a way that cannot happen
+} Procsim_Fatal_Error;
+
+/**
+* @brief Receives each scheduling event while reporting is enabled
+* @param record: the event, only valid during the call
+* @param context: the pointer given to procsim_set_record_callback
+*/
+typedef void (*ProcsimRecordCallback)(const LogRecord_t* record, void* context);
+
+/**
+* @brief Receives an unrecoverable error. The handler must not return to the simulator, the
+* process is aborted if it does
+* @param error: the error
+* @param message: a description of the error
+*/
+typedef void (*ProcsimFatalHandler)(Procsim_Fatal_Error error, const char* message);
+
+/**
+* @struct SwitchCosts_t
+* @brief Defines the CPU time the scheduler spends on itself. Every cost is at least 0
+*/
+typedef struct switch_costs {
+	int context_switch;		// Charged each time a process is dispatched to the CPU
+	int preemption;			// Charged on top of the dispatch when the running process is preempted
+	int io_interrupt;		// Charged for each I/O completion
+} SwitchCosts_t;
+
+/**
+* @struct ProcsimStats_t
+* @brief Defines the statistics of a run
+*/
+typedef struct procsim_stats {
+	long events_processed;
+	Procsim_Time last_event_time;
+	Procsim_Time idle_time;
+	long processes_started;
+	long processes_live;
+	long processes_completed;
+	Procsim_Time total_ready_wait_time;
+	Procsim_Time max_ready_wait_time;
+	Procsim_Time total_io_wait_time;
+	Procsim_Time max_io_wait_time;
+	long bursts_predicted;					// CPU bursts finished under SJF or SRTF
+	Procsim_Time total_prediction_error;	// Sum of the absolute differences between predicted and actual bursts
+	Procsim_Time max_prediction_error;
+	long dispatches;				// Processes given the CPU
+	long voluntary_switches;		// Processes leaving the CPU for I/O or to end
+	long involuntary_switches;		// Processes preempted
+	long io_interrupts;
+	Procsim_Time switch_overhead_time;		// CPU time charged for dispatches, preemptions and interrupts
+} ProcsimStats_t;
+
+/**
+* @struct ProcessResult_t
+* @brief Defines the analytics of one completed process
+*/
+typedef struct process_result {
+	Procsim_PID PID;
+	int priority;
+	Procsim_Time ready_wait_time;
+	Procsim_Time io_wait_time;
+	int voluntary_switches;
+	int involuntary_switches;
+} ProcessResult_t;
+
+/**
+* @struct DeviceStats_t
+* @brief Defines the configuration and analytics of one I/O device
+*/
+typedef struct device_stats {
+	int id;
+	IO_Policy policy;
+	int queue_depth;
+	bool configured;		// Set once a policy or queue depth was chosen for the device
+	long serviced_requests;
+	long total_seek_distance;
+	double average_queue_delay;
+	Procsim_Time max_queue_delay;
+	double throughput;		// Completions per unit of time from the first request to the last completion
+	double average_in_flight;
+	int max_in_flight;
+} DeviceStats_t;
+
+/**
+* @struct GroupStats_t
+* @brief Defines the weight and analytics of one process group
+*/
+typedef struct group_stats {
+	int group;
+	int weight;
+	bool active;				// Set once a process of the group started
+	long processes_started;
+	long processes_completed;
+	Procsim_Time cpu_time;				// Only measured under the fair-share policy
+	Procsim_Time total_ready_wait_time;	// Over the completed processes
+	Procsim_Time max_ready_wait_time;
+} GroupStats_t;
+
+/**
+* @struct ReadySpillStats_t
+* @brief Defines the activity of the scratch file holding the waiting processes the priority
+* policy keeps out of memory
+*/
+typedef struct ready_spill_stats {
+	int memory_limit;			// Waiting processes kept in memory
+	long spilled;				// Waiting processes in the scratch file now
+	long max_spilled;
+	long processes_spilled;		// Waiting processes moved out of memory
+	long runs_written;			// Sorted runs written to the scratch file, merges included
+	long run_merges;			// Times the runs were merged into one
+	long refills;				// Times the in-memory part ran dry and was refilled
+	long processes_refilled;
+	long scratch_bytes;			// Largest size of the scratch file
+} ReadySpillStats_t;
+
+/**
+* Defines the structures the priority policy's ready queue can be kept in
+*/
+typedef enum ready_queue_backend {
+	READY_QUEUE_LIST,		// Sorted list, for a handful of waiting processes
+	READY_QUEUE_BUCKETS,	// A list per priority, for few priorities in a narrow range
+	READY_QUEUE_HEAP,		// Binary heap, for deep queues over many priorities
+	READY_QUEUE_BACKEND_COUNT,
+} Ready_Queue_Backend;
+
+/**
+* @struct ReadyQueueSwitch_t
+* @brief Defines one move of the waiting processes from one ready queue backend to another
+*/
+typedef struct ready_queue_switch {
+	Procsim_Time time;
+	Ready_Queue_Backend from;
+	Ready_Queue_Backend to;
+	int depth;							// Waiting processes moved
+	int distinct_priorities;
+	long long priority_range;			// Highest minus lowest waiting priority, plus 1
+	long operations;					// Queue operations the backend left handled since it was chosen
+	double nanoseconds_per_operation;	// Measured on a sample of those operations, 0 if none was timed
+	double migration_nanoseconds;		// Time taken to move the waiting processes
+} ReadyQueueSwitch_t;
+
+/**
+* @brief Receives each switch of an adaptive ready queue between backends
+* @param record: the switch, only valid during the call
+* @param context: the pointer given to procsim_set_adaptive_ready_queue
+*/
+typedef void (*ProcsimQueueSwitchCallback)(const ReadyQueueSwitch_t* record, void* context);
+
+/**
+* @struct ReadyQueueStats_t
+* @brief Defines the activity of an adaptive ready queue
+*/
+typedef struct ready_queue_stats {
+	Ready_Queue_Backend backend;		// Backend in use now
+	long switches;
+	int max_depth;
+	int max_distinct_priorities;
+	long operations[READY_QUEUE_BACKEND_COUNT];					// Queue operations handled by each backend
+	double nanoseconds_per_operation[READY_QUEUE_BACKEND_COUNT];	// 0 for a backend never timed
+} ReadyQueueStats_t;
+
+/**
+* @brief The simulator. Its layout is private to the library
+*/
+typedef struct procsim Procsim_t;
+
+/**
+* @brief Creates a simulator with every device serviced first in, first out on one channel
+* @param preemptive: whether the scheduler preempts the running process for a higher priority
+* @param device_count: number of I/O devices, 1 to PROCSIM_MAX_DEVICES
+* @return the simulator, or NULL if the device count is out of range
+*/
+Procsim_t* procsim_create(bool preemptive, int device_count);
+
+/**
+* @brief Clears a simulator and everything it owns from memory
+* @param simulator: the simulator to destroy
+*/
+void procsim_destroy(Procsim_t* simulator);
+
+/**
+* @brief Branches a simulator. The fork holds an independent copy of the complete state (the
+* scheduler, the ready queue, the devices and every PCB), so both can handle different events
+* or settings from here on. The fork starts with the same record callback and reporting
+* @param simulator: the simulator to branch
+* @return the fork, destroyed separately
+*/
+Procsim_t* procsim_fork(const Procsim_t* simulator);
+
+/**
+* @brief Checks whether no process is in the system, none running, waiting or doing I/O
+* @param simulator: the simulator
+* @return true if every process that started has ended
+*/
+bool procsim_is_idle(const Procsim_t* simulator);
+
+/**
+* @brief Prepares a simulator that has not handled any event to take over a trace at a point
+* where no process is in the system, such as a speculative segment of a parallel run. Its
+* statistics start from zero, procsim_absorb_statistics adds those of the run before it
+* @param simulator: the simulator
+* @param next_PID: the PID the next process start gets
+* @param idle_since: time the CPU went idle
+* @param last_event_time: time of the last event before the takeover
+*/
+void procsim_start_idle_segment(Procsim_t* simulator, Procsim_PID next_PID, Procsim_Time idle_since, Procsim_Time last_event_time);
+
+/**
+* @brief Moves the head of a device that has no requests, as a guess of where an earlier run
+* left it
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param sector: the sector under the head
+* @return true on success, false if the device is out of range or has requests
+*/
+bool procsim_set_device_head(Procsim_t* simulator, int device, int sector);
+
+/**
+* @brief Checks whether two idle simulators would handle any further events exactly alike,
+* apart from the statistics each gathered so far: same policy and settings, next PID, idle
+* start, device heads and fair-share virtual times
+* @param simulator: an idle simulator
+* @param other: another idle simulator
+* @return true if they match, false if they differ or one is not idle
+*/
+bool procsim_has_same_idle_state(const Procsim_t* simulator, const Procsim_t* other);
+
+/**
+* @brief Adds the statistics of an earlier simulator to one that took over the trace from it at
+* an idle point, so that it reports as if it had handled the whole trace
+* @param simulator: the simulator that took over, started by procsim_start_idle_segment
+* @param earlier: the simulator of the trace up to the takeover, with the same devices
+*/
+void procsim_absorb_statistics(Procsim_t* simulator, const Procsim_t* earlier);
+
+/**
+* @brief Switches between the preemptive priority and the non-preemptive FIFO policy, as
+* procsim_set_scheduling_policy does
+* @param simulator: the simulator
+* @param preemptive: whether the scheduler preempts from now on
+*/
+void procsim_set_preemptive(Procsim_t* simulator, bool preemptive);
+
+/**
+* @brief Switches the scheduling policy. The waiting processes are moved to the new ready queue
+* in their current order, or by predicted burst for SJF and SRTF, and the running process keeps
+* the CPU, so the switch takes effect at the next scheduling decision. Leaving the priority policy
+* brings every process spilled by procsim_set_ready_spill back into memory
+* @param simulator: the simulator
+* @param policy: the policy from now on
+*/
+void procsim_set_scheduling_policy(Procsim_t* simulator, Scheduling_Policy policy);
+
+/**
+* @brief Looks up the scheduling policy
+* @param simulator: the simulator
+* @return the policy
+*/
+Scheduling_Policy procsim_get_scheduling_policy(const Procsim_t* simulator);
+
+/**
+* @brief Sets how SJF and SRTF predict CPU bursts. Each process predicts its next burst as
+* alpha * last burst + (1 - alpha) * last prediction, starting from the initial prediction
+* @param simulator: the simulator
+* @param initial_burst: prediction for the first burst of a process, at least 0
+* @param alpha: weight of the last burst, 0 to 1
+* @return true on success, false if a value is out of range
+*/
+bool procsim_set_burst_prediction(Procsim_t* simulator, int initial_burst, double alpha);
+
+/**
+* @brief Sets the CPU share of a process group under the fair-share policy. A group with
+* weight 2 gets twice the CPU time of a group with weight 1 while both have work
+* @param simulator: the simulator
+* @param group: the group id, 0 to PROCSIM_MAX_GROUPS - 1
+* @param weight: the weight, at least 1 (the default)
+* @return true on success, false if a value is out of range
+*/
+bool procsim_set_group_weight(Procsim_t* simulator, int group, int weight);
+
+/**
+* @brief Sets the CPU time charged for context switches, preemptions and I/O interrupts from
+* now on. Switches are counted either way, every cost is 0 until set
+* @param simulator: the simulator
+* @param costs: the costs
+* @return true on success, false if a cost is negative
+*/
+bool procsim_set_switch_costs(Procsim_t* simulator, const SwitchCosts_t* costs);
+
+/**
+* @brief Looks up the CPU time charged for context switches, preemptions and I/O interrupts
+* @param simulator: the simulator
+* @param costs: filled in with the costs
+* @return true if the costs were set, false if they were left at 0
+*/
+bool procsim_get_switch_costs(const Procsim_t* simulator, SwitchCosts_t* costs);
+
+/**
+* @brief Bounds the waiting processes the priority policy keeps in memory. Past the bound, the
+* lowest ones go to a scratch file as compact records in sorted runs, and come back as the
+* in-memory part drains. The order processes run in is the same as without the bound. Must
+* be called before the first event
+* @param simulator: the simulator
+* @param memory_limit: most waiting processes kept in memory, at least 2
+* @param scratch_fd: a file opened for reading and writing, which the simulator maps into
+* memory and resizes. The caller closes it after procsim_destroy
+* @return true on success, false if the limit is below 2, a bound is already set or events were handled
+*/
+bool procsim_set_ready_spill(Procsim_t* simulator, int memory_limit, int scratch_fd);
+
+/**
+* @brief Looks up the spill and refill statistics of the scratch file
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+* @return true on success, false if the waiting processes are not bounded
+*/
+bool procsim_get_ready_spill_stats(const Procsim_t* simulator, ReadySpillStats_t* stats);
+
+/**
+* @brief Lets the priority policy move its ready queue between a sorted list, a list per
+* priority and a heap as the number of waiting processes and of distinct priorities they have
+* change. The order processes run in is the same whatever the backend. Must be called before
+* the first event
+* @param simulator: the simulator
+* @param callback: receives each switch with the measured cost of the backend left, may be NULL
+* @param context: passed to the callback
+* @return true on success, false if events were handled, the ready queue is already adaptive
+* or bounded by procsim_set_ready_spill
+*/
+bool procsim_set_adaptive_ready_queue(Procsim_t* simulator, ProcsimQueueSwitchCallback callback, void* context);
+
+/**
+* @brief Looks up the backend, switch and cost statistics of an adaptive ready queue
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+* @return true on success, false if the ready queue is not adaptive
+*/
+bool procsim_get_ready_queue_stats(const Procsim_t* simulator, ReadyQueueStats_t* stats);
+
+/**
+* @brief Sets the service policy of a device. Must be called before the device receives any request
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param policy: the policy
+* @return true on success, false if the device does not exist or already has requests
+*/
+bool procsim_set_device_policy(Procsim_t* simulator, int device, IO_Policy policy);
+
+/**
+* @brief Sets the number of requests a device services in parallel. Must be called before
+* the device receives any request
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param queue_depth: number of service channels, at least 1
+* @return true on success, false if the device does not exist, already has requests or the depth is below 1
+*/
+bool procsim_set_device_queue_depth(Procsim_t* simulator, int device, int queue_depth);
+
+/**
+* @brief Sets the function receiving the scheduling events
+* @param simulator: the simulator
+* @param callback: the function, NULL to discard the events
+* @param context: passed to every call of the function
+*/
+void procsim_set_record_callback(Procsim_t* simulator, ProcsimRecordCallback callback, void* context);
+
+/**
+* @brief Turns the scheduling events on or off, for example to fast-forward silently
+* @param simulator: the simulator
+* @param reporting: whether events go to the callback
+*/
+void procsim_set_reporting(Procsim_t* simulator, bool reporting);
+
+/**
+* @brief Handles one event. Unknown op codes are counted and otherwise ignored
+* @param simulator: the simulator
+* @param event: the event, its time no earlier than the previous event
+* @return PROCSIM_OK, or the reason the event was rejected
+*/
+Procsim_Status procsim_submit_event(Procsim_t* simulator, const Event_t* event);
+
+/**
+* @brief Handles an array of events in order, stopping at the first rejected event. Process
+* starts at the same time are handled in one step where the scheduler supports it, with the
+* same scheduling events and results as one at a time
+* @param simulator: the simulator
+* @param events: the events
+* @param count: number of events
+* @param status: filled in with the status of the last event handled or rejected, may be NULL
+* @return the number of events handled
+*/
+long procsim_submit_events(Procsim_t* simulator, const Event_t* events, long count, Procsim_Status* status);
+
+/**
+* @brief Fills in the statistics of the run so far
+* @param simulator: the simulator
+* @param stats: the statistics to fill in
+*/
+void procsim_get_stats(const Procsim_t* simulator, ProcsimStats_t* stats);
+
+/**
+* @brief Counts the completed processes, without the wait time reductions of procsim_get_stats
+* @param simulator: the simulator
+* @return the number of completed processes
+*/
+long procsim_get_completed_count(const Procsim_t* simulator);
+
+/**
+* @brief Bounds the number of completed processes whose analytics are kept, for long runs.
+* Past the limit the oldest half of the results is folded into the totals of procsim_get_stats,
+* so the statistics stay exact while procsim_get_process_results only sees the newer processes
+* @param simulator: the simulator
+* @param limit: the most results to keep, at least 2, or 0 to keep every result (the default)
+*/
+void procsim_set_result_retention(Procsim_t* simulator, int limit);
+
+/**
+* @brief Copies the analytics of the retained completed processes, in completion order
+* @param simulator: the simulator
+* @param first: index of the first retained process to copy
+* @param count: the most results to copy
+* @param results: array of at least count entries
+* @return the number of results copied
+*/
+int procsim_get_process_results(const Procsim_t* simulator, int first, int count, ProcessResult_t* results);
+
+/**
+* @brief Fills in the configuration and analytics of a device
+* @param simulator: the simulator
+* @param device: the device identifier
+* @param stats: the statistics to fill in
+* @return true on success, false if the device does not exist
+*/
+bool procsim_get_device_stats(const Procsim_t* simulator, int device, DeviceStats_t* stats);
+
+/**
+* @brief Counts the process groups, one more than the highest group id seen or weighted
+* @param simulator: the simulator
+* @return the number of groups
+*/
+int procsim_get_group_count(const Procsim_t* simulator);
+
+/**
+* @brief Looks up the weight and analytics of a process group
+* @param simulator: the simulator
+* @param group: the group id
+* @param stats: the statistics to fill in
+* @return true on success, false if the group is out of range
+*/
+bool procsim_get_group_stats(const Procsim_t* simulator, int group, GroupStats_t* stats);
+
+/**
+* @brief Checks whether the simulator preempts
+* @param simulator: the simulator
+* @return true for the priority and SRTF policies
+*/
+bool procsim_is_preemptive(const Procsim_t* simulator);
+
+/**
+* @brief Counts the devices of the simulator
+* @param simulator: the simulator
+* @return the number of devices
+*/
+int procsim_get_device_count(const Procsim_t* simulator);
+
+/**
+* @brief Counts the processes waiting to run
+* @param simulator: the simulator
+* @return the ready queue length
+*/
+int procsim_get_ready_queue_length(const Procsim_t* simulator);
+
+/**
+* @brief Checks whether a process is on the CPU
+* @param simulator: the simulator
+* @return true if the CPU is busy
+*/
+bool procsim_is_cpu_busy(const Procsim_t* simulator);
+
+/**
+* @brief Counts every request on a device, in flight or waiting
+* @param simulator: the simulator
+* @param device: the device identifier, must exist
+* @return the number of requests
+*/
+int procsim_get_device_request_count(const Procsim_t* simulator, int device);
+
+/**
+* @brief Converts a policy name (fifo, priority, sstf, scan, cscan) into a policy
+* @param name: the policy name
+* @param policy: filled in with the matching policy
+* @return true if the name was recognized, false if not
+*/
+bool parse_io_policy(const char* name, IO_Policy* policy);
+
+/**
+* @brief Converts a policy into its name
+* @param policy: the policy
+* @return the policy name
+*/
+const char* get_io_policy_name(IO_Policy policy);
+
+/**
+* @brief Converts a scheduling policy name (fifo, priority, sjf, srtf, fair) into a policy
+* @param name: the policy name
+* @param policy: filled in with the matching policy
+* @return true if the name was recognized, false if not
+*/
+bool parse_scheduling_policy(const char* name, Scheduling_Policy* policy);
+
+/**
+* @brief Converts a scheduling policy into its name
+* @param policy: the policy
+* @return the policy name
+*/
+const char* get_scheduling_policy_name(Scheduling_Policy policy);
+
+/**
+* @brief Converts a ready queue backend into its name
+* @param backend: the backend
+* @return the backend name
+*/
+const char* get_ready_queue_backend_name(Ready_Queue_Backend backend);
+
+/**
+* @brief Describes a submission status
+* @param status: the status
+* @return the description
+*/
+const char* procsim_get_status_message(Procsim_Status status);
+
+/**
+* @brief Sets the function receiving unrecoverable errors, shared by every simulator of the
+* process. Without one the process is aborted
+* @param handler: the function, NULL to restore the default
+*/
+void procsim_set_fatal_handler(ProcsimFatalHandler handler);
+
+#endif //PROCSIM_H
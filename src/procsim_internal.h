@@ -0,0 +1,44 @@
+/**
+ * @file procsim_internal.h
+ * @brief Declares the layout of a simulator, shared by the library and the tools that save
+ *		  and restore its complete state. Embedding programs only need procsim.h
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef PROCSIM_INTERNAL_H
+#define PROCSIM_INTERNAL_H
+
+// Header imports
+#include "procsim.h"
+#include "Scheduler.h"
+#include "io_device.h"
+#include "pcb_store.h"
+
+/**
+* @struct procsim
+* @brief Defines a simulator. It owns its devices and PCB store, so the devices can point at the store
+*/
+struct procsim {
+	Scheduling_Policy scheduling_policy;
+	Procsim_PID PID_tracker;	// Next PID to hand out, starting at 1
+	long events_processed;
+	Procsim_Time last_event_time;
+	SchedulerHandler scheduler_handler;
+	PCB_Store_t pcb_store;
+	IO_Device_t* io_devices;
+	int io_device_count;
+};
+
+/**
+* @brief Replaces the scheduler of a simulator, keeping its record callback and reporting.
+* The ready queue must be empty and the CPU idle
+* @param simulator: the simulator
+* @param policy: the scheduling policy
+*/
+void set_procsim_scheduler(Procsim_t* simulator, Scheduling_Policy policy);
+
+#endif //PROCSIM_INTERNAL_H
@@ -10,8 +10,8 @@
 
 // Header imports
 #include "queue.h"
+#include "fatal_error.h"
 // Library imports
-#include <stdio.h>
 #include <stdlib.h>
 
 /**
@@ -30,16 +30,16 @@ void initialize_queue(Queue_t* queue) {
 * @param data: PCB data to add
 */
 void enqueue_queue(Queue_t* queue, PCB_t* data) {
-	Node* newNode = createNode(data);
+	data->next = NULL;
 	if (queue->size == 0) {
-		// Initialize queue with head and tail pointers to first node
-		queue->head = newNode;
-		queue->tail = newNode;
+		// Initialize queue with head and tail pointers to first PCB
+		queue->head = data;
+		queue->tail = data;
 	} else {
-		// Update current tail node to point to new node
-		queue->tail->next = newNode;
-		// Update current tail node
-		queue->tail = newNode;
+		// Update current tail PCB to point to new PCB
+		queue->tail->next = data;
+		// Update current tail PCB
+		queue->tail = data;
 	}
 
 	queue->size++;
@@ -53,11 +53,10 @@ void enqueue_queue(Queue_t* queue, PCB_t* data) {
 PCB_t* dequeue_queue(Queue_t* queue) {
 	if (is_empty_queue(queue)) {
 		// Queue is empty, throw an error
-		fprintf(stderr, "ERROR: Queue is already empty!\n");
-		exit(1);
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Queue is already empty!");
 	}
 
-	Node* temp = queue->head;
+	PCB_t* dequeuedData = queue->head;
 	queue->head = queue->head->next;
 	if (queue->head == NULL) {
 		// If the queue is now empty, update the tail to NULL as well
@@ -66,9 +65,8 @@ PCB_t* dequeue_queue(Queue_t* queue) {
 
 	queue->size--;
 
-	// Return the PCB data of the first element in the queue
-	PCB_t* dequeuedData = temp->data;
-	free(temp); // Deallocate the memory of the node
+	// Unlink and return the first PCB in the queue
+	dequeuedData->next = NULL;
 	return dequeuedData;
 }
 
@@ -79,11 +77,10 @@ PCB_t* dequeue_queue(Queue_t* queue) {
 */
 PCB_t peek_queue(const Queue_t* queue) {
 	if (is_empty_queue(queue)) {
-		printf("ERROR: Queue is empty!\n");
-		exit(1);
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Queue is empty!");
 	}
 
-	return *queue->head->data;
+	return *queue->head;
 }
 
 /**
@@ -109,27 +106,9 @@ int get_size_queue(const Queue_t* queue) {
 }
 
 /**
-* @brief For debugging purposes, prints the contents of the queue
-* @param queue: contents to print
+* @brief empties the queue. The PCB's are owned by the PCB store and are left alone
+* @param queue: queue to empty
 */
-void dump_queue(const Queue_t* queue) {
-	Node* temp = queue->head;
-	int i = 0;
-	while (temp != NULL) {
-		printf("Node #%d: ID %d, ", i++, temp->data->PID);
-		temp = temp->next;
-	}
-}
-
-/**
-* @brief clears the contents of the queue from memory
-* @param queue: queue to clear from memory
-*/
-void free_queue(const Queue_t* queue) {
-	Node* head = queue->head;
-	while (head != NULL) {
-		Node *temp = head;
-		head = head->next;
-		free(temp);
-	}
+void free_queue(Queue_t* queue) {
+	initialize_queue(queue);
 }
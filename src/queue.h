@@ -13,7 +13,6 @@
 
 // Header imports
 #include "PCB.h"
-#include "Node.h"
 // Library imports
 #include <stdbool.h>
 
@@ -23,8 +22,8 @@
 * @brief Defines the attributes of a queue
 */
 typedef struct queue{
-	Node* head;
-	Node* tail;
+	PCB_t* head;	// Linked through the PCB's next field
+	PCB_t* tail;
 	int size;
 }Queue_t;
 
@@ -71,15 +70,9 @@ bool is_empty_queue(const Queue_t* queue);
 int get_size_queue(const Queue_t* queue);
 
 /**
-* @brief For debugging purposes, prints the contents of the queue
-* @param queue: contents to print
+* @brief empties the queue. The PCB's are owned by the PCB store and are left alone
+* @param queue: queue to empty
 */
-void dump_queue(const Queue_t* queue);
-
-/**
-* @brief clears the contents of the queue from memory
-* @param queue: queue to clear from memory
-*/
-void free_queue(const Queue_t* queue);
+void free_queue(Queue_t* queue);
 
 #endif //QUEUE_H
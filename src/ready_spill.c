@@ -0,0 +1,467 @@
+/**
+ * @file ready_spill.c
+ * @brief Defines the out-of-memory part of the priority policy's ready queue
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "ready_spill.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+* @brief Checks if record a comes before record b in the ready queue
+*/
+static bool record_before(const SpillRecord_t* a, const SpillRecord_t* b) {
+	if (a->priority != b->priority) {
+		return a->priority > b->priority;
+	}
+	return a->key < b->key;
+}
+
+/**
+* @brief Orders records as the ready queue does, for qsort
+*/
+static int compare_records(const void* a, const void* b) {
+	return record_before((const SpillRecord_t*)a, (const SpillRecord_t*)b) ? -1 : 1;
+}
+
+/**
+* @brief Packs a waiting process into a record
+*/
+static void make_record(SpillRecord_t* record, const PCB_Store_t* store, const PCB_t* pcb, long long key) {
+	int slot = pcb->slot;
+	record->PID = pcb->PID;
+	record->key = key;
+	record->start_ready_time = store->start_ready_time[slot];
+	record->total_ready_time = store->total_ready_time[slot];
+	record->total_io_blocked_time = store->total_io_blocked_time[slot];
+	record->predicted_burst = store->bursts.predicted_burst[slot];
+	record->burst_time = store->bursts.burst_time[slot];
+	record->priority = pcb->priority;
+	record->voluntary_switches = store->switches.voluntary[slot];
+	record->involuntary_switches = store->switches.involuntary[slot];
+	record->group = pcb->group;
+}
+
+/**
+* @brief Unpacks a record into a new PCB of the store
+* @return the waiting process
+*/
+static PCB_t* restore_record(PCB_Store_t* store, const SpillRecord_t* record) {
+	PCB_t* pcb = allocate_pcb(store);
+	int slot = pcb->slot;
+	pcb->PID = record->PID;
+	pcb->priority = record->priority;
+	pcb->group = record->group;
+	pcb->state = READY;
+	store->start_ready_time[slot] = record->start_ready_time;
+	store->total_ready_time[slot] = record->total_ready_time;
+	store->total_io_blocked_time[slot] = record->total_io_blocked_time;
+	store->bursts.predicted_burst[slot] = record->predicted_burst;
+	store->bursts.burst_time[slot] = record->burst_time;
+	store->switches.voluntary[slot] = record->voluntary_switches;
+	store->switches.involuntary[slot] = record->involuntary_switches;
+	return pcb;
+}
+
+/**
+* @brief Grows the scratch file so that it holds bytes more past the last run, and maps it again
+*/
+static void reserve_scratch(ReadySpill_t* spill, size_t bytes) {
+	size_t needed = spill->used + bytes;
+	if (needed <= spill->map_size) {
+		return;
+	}
+
+	size_t new_size = spill->map_size > 0 ? spill->map_size * 2 : SPILL_MIN_FILE_SIZE;
+	while (new_size < needed) {
+		new_size *= 2;
+	}
+	if (ftruncate(spill->fd, (off_t)new_size) != 0) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Scratch file could not be grown!");
+	}
+	if (spill->map != NULL) {
+		munmap(spill->map, spill->map_size);
+	}
+	spill->map = (char*)mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, spill->fd, 0);
+	if (spill->map == MAP_FAILED) {
+		spill->map = NULL;
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Scratch file could not be mapped!");
+	}
+	spill->map_size = new_size;
+	if ((long)new_size > spill->stats.scratch_bytes) {
+		spill->stats.scratch_bytes = (long)new_size;
+	}
+}
+
+/**
+* @brief Looks up the records of a run in the mapped scratch file
+*/
+static SpillRecord_t* get_run_records(const ReadySpill_t* spill, const SpillRun_t* run) {
+	return (SpillRecord_t*)(spill->map + run->start);
+}
+
+/**
+* @brief Finds the run holding the next record in queue order among the runs' next records
+* @param next: the next record of each run
+* @return the run, -1 if every run is used up
+*/
+static int find_first_run(const ReadySpill_t* spill, const long* next) {
+	int first = -1;
+	for (int i = 0; i < spill->run_count; i++) {
+		const SpillRun_t* run = &spill->runs[i];
+		if (next[i] < run->count && (first < 0 || record_before(&get_run_records(spill, run)[next[i]],
+			&get_run_records(spill, &spill->runs[first])[next[first]]))) {
+			first = i;
+		}
+	}
+	return first;
+}
+
+/**
+* @brief Merges the records left in every run into one run at the start of the scratch file
+*/
+static void merge_runs(ReadySpill_t* spill) {
+	long count = 0;
+	long next[SPILL_MAX_RUNS];
+	for (int i = 0; i < spill->run_count; i++) {
+		next[i] = spill->runs[i].next;
+		count += spill->runs[i].count - spill->runs[i].next;
+	}
+
+	// Write the merged run past the last run, then move it to the start
+	size_t bytes = (size_t)count * sizeof(SpillRecord_t);
+	reserve_scratch(spill, bytes);
+	SpillRecord_t* merged = (SpillRecord_t*)(spill->map + spill->used);
+	for (long i = 0; i < count; i++) {
+		int first = find_first_run(spill, next);
+		merged[i] = get_run_records(spill, &spill->runs[first])[next[first]++];
+	}
+	memmove(spill->map, merged, bytes);
+
+	spill->runs[0].start = 0;
+	spill->runs[0].count = count;
+	spill->runs[0].next = 0;
+	spill->run_count = 1;
+	spill->used = bytes;
+	spill->stats.run_merges++;
+	spill->stats.runs_written++;
+}
+
+/**
+* @brief Makes room for a new run of count records past the last run
+* @return where the records go, valid until the scratch file grows again
+*/
+static SpillRecord_t* begin_run(ReadySpill_t* spill, long count) {
+	if (spill->run_count == SPILL_MAX_RUNS) {
+		merge_runs(spill);
+	}
+	reserve_scratch(spill, (size_t)count * sizeof(SpillRecord_t));
+	return (SpillRecord_t*)(spill->map + spill->used);
+}
+
+/**
+* @brief Adds the run of count records written past the last run
+*/
+static void end_run(ReadySpill_t* spill, long count) {
+	SpillRun_t* run = &spill->runs[spill->run_count++];
+	run->start = spill->used;
+	run->count = count;
+	run->next = 0;
+	spill->used += (size_t)count * sizeof(SpillRecord_t);
+	spill->stats.runs_written++;
+}
+
+/**
+* @brief Counts processes moved out of memory, the lowest of them having the given priority
+*/
+static void count_spilled(ReadySpill_t* spill, long count, int lowest_priority) {
+	if (spill->spilled == 0 || lowest_priority < spill->lowest_priority) {
+		spill->lowest_priority = lowest_priority;
+	}
+	spill->spilled += count;
+	spill->stats.processes_spilled += count;
+	if (spill->spilled > spill->stats.max_spilled) {
+		spill->stats.max_spilled = spill->spilled;
+	}
+}
+
+/**
+* @brief Adds a record to the heap, writing the heap out as a run once it is full
+*/
+static void push_record(ReadySpill_t* spill, const SpillRecord_t* record) {
+	SpillRecord_t* heap = spill->heap;
+	int index = spill->heap_size++;
+	while (index > 0 && record_before(record, &heap[(index - 1) / 2])) {
+		heap[index] = heap[(index - 1) / 2];
+		index = (index - 1) / 2;
+	}
+	heap[index] = *record;
+	count_spilled(spill, 1, record->priority);
+
+	if (spill->heap_size == spill->heap_capacity) {
+		qsort(heap, spill->heap_size, sizeof(SpillRecord_t), compare_records);
+		SpillRecord_t* records = begin_run(spill, spill->heap_size);
+		memcpy(records, heap, (size_t)spill->heap_size * sizeof(SpillRecord_t));
+		end_run(spill, spill->heap_size);
+		spill->heap_size = 0;
+	}
+}
+
+/**
+* @brief Removes the first record of the heap
+*/
+static void pop_record(ReadySpill_t* spill, SpillRecord_t* record) {
+	SpillRecord_t* heap = spill->heap;
+	*record = heap[0];
+	SpillRecord_t last = heap[--spill->heap_size];
+	int index = 0;
+	while (true) {
+		int child = 2 * index + 1;
+		if (child >= spill->heap_size) {
+			break;
+		}
+		if (child + 1 < spill->heap_size && record_before(&heap[child + 1], &heap[child])) {
+			child++;
+		}
+		if (!record_before(&heap[child], &last)) {
+			break;
+		}
+		heap[index] = heap[child];
+		index = child;
+	}
+	heap[index] = last;
+}
+
+/**
+* @brief Takes the first spilled record in queue order, from the runs or the heap
+*/
+static void take_record(ReadySpill_t* spill, SpillRecord_t* record) {
+	long next[SPILL_MAX_RUNS];
+	for (int i = 0; i < spill->run_count; i++) {
+		next[i] = spill->runs[i].next;
+	}
+	int first = find_first_run(spill, next);
+
+	if (first < 0 || (spill->heap_size > 0 && record_before(&spill->heap[0], &get_run_records(spill, &spill->runs[first])[next[first]]))) {
+		pop_record(spill, record);
+	} else {
+		SpillRun_t* run = &spill->runs[first];
+		*record = get_run_records(spill, run)[run->next++];
+		if (run->next == run->count) {
+			// Runs are unordered, the last one takes the place of a used up run
+			spill->runs[first] = spill->runs[--spill->run_count];
+		}
+	}
+
+	spill->spilled--;
+	if (spill->spilled == 0) {
+		// Nothing left, the scratch file is reused from the start
+		spill->run_count = 0;
+		spill->used = 0;
+		spill->next_front_key = -1;
+		spill->next_back_key = 1;
+	}
+}
+
+/**
+* @brief Brings up to count spilled processes back to the end of the list, in queue order
+*/
+static void refill_list(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue, long count) {
+	if (count > spill->spilled) {
+		count = spill->spilled;
+	}
+	for (long i = 0; i < count; i++) {
+		SpillRecord_t record;
+		take_record(spill, &record);
+		enqueue_priority_queue(queue, restore_record(store, &record));
+	}
+	spill->stats.refills++;
+	spill->stats.processes_refilled += count;
+}
+
+/**
+* @brief Moves a waiting process out of memory
+*/
+static void spill_process(ReadySpill_t* spill, PCB_Store_t* store, PCB_t* pcb, long long key) {
+	SpillRecord_t record;
+	make_record(&record, store, pcb, key);
+	release_pcb(store, pcb);
+	push_record(spill, &record);
+}
+
+/**
+* @brief Moves the back half of the list out of memory as one run. It comes before every
+* spilled process of the same priority, so it takes the next front keys
+*/
+static void spill_back_half(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue) {
+	int keep = spill->memory_limit / 2;
+	PCB_t* last_kept = queue->head;
+	for (int i = 1; i < keep; i++) {
+		last_kept = last_kept->next;
+	}
+	long count = queue->size - keep;
+	PCB_t* pcb = last_kept->next;
+	last_kept->next = NULL;
+	queue->tail = last_kept;
+	queue->size = keep;
+
+	SpillRecord_t* records = begin_run(spill, count);
+	long long key = spill->next_front_key - count + 1;
+	spill->next_front_key -= count;
+	int lowest_priority = 0;
+	for (long i = 0; i < count; i++) {
+		PCB_t* next = pcb->next;
+		make_record(&records[i], store, pcb, key++);
+		lowest_priority = pcb->priority;
+		release_pcb(store, pcb);
+		pcb = next;
+	}
+	end_run(spill, count);
+	count_spilled(spill, count, lowest_priority);
+}
+
+/**
+* @brief Initializes an empty spill over a scratch file
+* @param spill: the spill to initialize
+* @param memory_limit: most PCB's the ready queue list holds, at least 2
+* @param fd: the scratch file, opened for reading and writing
+*/
+void initialize_ready_spill(ReadySpill_t* spill, int memory_limit, int fd) {
+	spill->memory_limit = memory_limit;
+	spill->fd = fd;
+	spill->map = NULL;
+	spill->map_size = 0;
+	spill->used = 0;
+	spill->run_count = 0;
+	spill->heap_capacity = memory_limit / 2;
+	spill->heap_size = 0;
+	spill->heap = (SpillRecord_t*)malloc((size_t)spill->heap_capacity * sizeof(SpillRecord_t));
+	if (spill->heap == NULL) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	spill->next_front_key = -1;
+	spill->next_back_key = 1;
+	spill->lowest_priority = 0;
+	spill->spilled = 0;
+	memset(&spill->stats, 0, sizeof(spill->stats));
+	spill->stats.memory_limit = memory_limit;
+}
+
+/**
+* @brief Adds a waiting process to the ready queue, where enqueue_priority_queue would put it
+* in the whole queue. A process that lands past the list is spilled, and a list over the
+* limit spills its back half
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list
+* @param pcb: the process
+*/
+void enqueue_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue, PCB_t* pcb) {
+	pcb->next = NULL;
+	if (spill->spilled == 0 || pcb->priority > queue->head->priority) {
+		// The list is the whole queue, or the process goes first
+		enqueue_priority_queue(queue, pcb);
+	} else if (pcb->priority <= spill->lowest_priority) {
+		// At the tail of the whole queue, after every spilled process
+		spill_process(spill, store, pcb, spill->next_back_key++);
+	} else if (queue->tail->priority <= pcb->priority) {
+		// Before the first lower or equal priority past the head, which is in the list
+		insert_priority_queue_after_head(queue, pcb);
+	} else {
+		// Before the spilled processes of its priority
+		spill_process(spill, store, pcb, spill->next_front_key--);
+	}
+
+	if (queue->size > spill->memory_limit) {
+		spill_back_half(spill, store, queue);
+	}
+}
+
+/**
+* @brief Removes the first process of the ready queue, refilling the list from the scratch
+* file if that empties it
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list, not empty
+* @return the process
+*/
+PCB_t* dequeue_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue) {
+	PCB_t* pcb = dequeue_priority_queue(queue);
+	if (is_empty_priority_queue(queue) && spill->spilled > 0) {
+		refill_list(spill, store, queue, spill->memory_limit / 2);
+	}
+	return pcb;
+}
+
+/**
+* @brief Brings every spilled process back to the end of the list
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list
+*/
+void drain_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue) {
+	if (spill->spilled > 0) {
+		refill_list(spill, store, queue, spill->spilled);
+	}
+}
+
+/**
+* @brief Appends copies of the spilled processes, in queue order, to the list of another
+* store, leaving the spill untouched
+* @param spill: the spill
+* @param store: the store the copies are allocated from
+* @param queue: the list the copies are appended to
+*/
+void copy_spilled_processes(const ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue) {
+	if (spill->spilled == 0) {
+		return;
+	}
+
+	// The heap is copied and sorted so it can be merged with the runs
+	SpillRecord_t* heap = (SpillRecord_t*)malloc((spill->heap_size > 0 ? (size_t)spill->heap_size : 1) * sizeof(SpillRecord_t));
+	if (heap == NULL) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	memcpy(heap, spill->heap, (size_t)spill->heap_size * sizeof(SpillRecord_t));
+	qsort(heap, spill->heap_size, sizeof(SpillRecord_t), compare_records);
+
+	long next[SPILL_MAX_RUNS];
+	for (int i = 0; i < spill->run_count; i++) {
+		next[i] = spill->runs[i].next;
+	}
+	int next_heap = 0;
+	for (long i = 0; i < spill->spilled; i++) {
+		int first = find_first_run(spill, next);
+		const SpillRecord_t* record;
+		if (first < 0 || (next_heap < spill->heap_size && record_before(&heap[next_heap], &get_run_records(spill, &spill->runs[first])[next[first]]))) {
+			record = &heap[next_heap++];
+		} else {
+			record = &get_run_records(spill, &spill->runs[first])[next[first]++];
+		}
+		enqueue_priority_queue(queue, restore_record(store, record));
+	}
+	free(heap);
+}
+
+/**
+* @brief Unmaps the scratch file and clears the spill from memory. The file stays open
+* @param spill: the spill to clear
+*/
+void free_ready_spill(ReadySpill_t* spill) {
+	if (spill->map != NULL) {
+		munmap(spill->map, spill->map_size);
+		spill->map = NULL;
+	}
+	free(spill->heap);
+	spill->heap = NULL;
+}
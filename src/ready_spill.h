@@ -0,0 +1,137 @@
+/**
+ * @file ready_spill.h
+ * @brief Declares the out-of-memory part of the priority policy's ready queue. The ready
+ *		  queue list keeps the first waiting processes in memory and the rest are kept as
+ *		  compact records in a memory mapped scratch file, in sorted runs merged back as the
+ *		  list drains
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef READY_SPILL_H
+#define READY_SPILL_H
+
+// Header imports
+#include "PCB.h"
+#include "pcb_store.h"
+#include "priority_queue.h"
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+#include <stddef.h>
+
+// Runs in the scratch file before they are merged into one
+#define SPILL_MAX_RUNS 16
+// Smallest size the scratch file grows to, in bytes
+#define SPILL_MIN_FILE_SIZE (1 << 20)
+
+/**
+* @struct SpillRecord_t
+* @brief Defines a waiting process out of memory: its PCB fields and slot statistics. The key
+* keeps equal priorities in list order, negative keys counting down for processes placed before
+* the others of their priority, positive keys counting up for processes placed after them
+*/
+typedef struct spill_record {
+	Procsim_PID PID;
+	long long key;
+	Procsim_Time start_ready_time;
+	Procsim_Time total_ready_time;
+	Procsim_Time total_io_blocked_time;
+	Procsim_Time predicted_burst;
+	Procsim_Time burst_time;
+	int priority;
+	int voluntary_switches;
+	int involuntary_switches;
+	unsigned short group;
+} SpillRecord_t;
+
+/**
+* @struct SpillRun_t
+* @brief Defines a sorted run of records in the scratch file
+*/
+typedef struct spill_run {
+	size_t start;		// Byte offset of the first record
+	long count;
+	long next;			// Next record to refill
+} SpillRun_t;
+
+/**
+* @struct ReadySpill_t
+* @brief Defines the spilled end of the ready queue. Every spilled process comes after every
+* process in the list, so the list stays the exact front of the queue. Records placed among the
+* spilled ones gather in a bounded heap, written out as a run once it fills
+*/
+typedef struct ready_spill {
+	int memory_limit;			// Most PCB's the list holds before its back half is spilled
+	int fd;
+	char* map;					// The scratch file, mapped
+	size_t map_size;
+	size_t used;				// Bytes up to the end of the last run
+	SpillRun_t runs[SPILL_MAX_RUNS];
+	int run_count;
+	SpillRecord_t* heap;		// Records not yet written, highest priority then lowest key first
+	int heap_size;
+	int heap_capacity;
+	long long next_front_key;	// Counts down from -1
+	long long next_back_key;	// Counts up from 1
+	int lowest_priority;		// Lowest spilled priority, valid while any is spilled
+	long spilled;
+	ReadySpillStats_t stats;
+} ReadySpill_t;
+
+/**
+* @brief Initializes an empty spill over a scratch file
+* @param spill: the spill to initialize
+* @param memory_limit: most PCB's the ready queue list holds, at least 2
+* @param fd: the scratch file, opened for reading and writing
+*/
+void initialize_ready_spill(ReadySpill_t* spill, int memory_limit, int fd);
+
+/**
+* @brief Adds a waiting process to the ready queue, where enqueue_priority_queue would put it
+* in the whole queue. A process that lands past the list is spilled, and a list over the
+* limit spills its back half
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list
+* @param pcb: the process
+*/
+void enqueue_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue, PCB_t* pcb);
+
+/**
+* @brief Removes the first process of the ready queue, refilling the list from the scratch
+* file if that empties it
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list, not empty
+* @return the process
+*/
+PCB_t* dequeue_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue);
+
+/**
+* @brief Brings every spilled process back to the end of the list
+* @param spill: the spill
+* @param store: the store that owns the PCB's
+* @param queue: the ready queue list
+*/
+void drain_ready_spill(ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue);
+
+/**
+* @brief Appends copies of the spilled processes, in queue order, to the list of another
+* store, leaving the spill untouched
+* @param spill: the spill
+* @param store: the store the copies are allocated from
+* @param queue: the list the copies are appended to
+*/
+void copy_spilled_processes(const ReadySpill_t* spill, PCB_Store_t* store, PriorityQueue_t* queue);
+
+/**
+* @brief Unmaps the scratch file and clears the spill from memory. The file stays open
+* @param spill: the spill to clear
+*/
+void free_ready_spill(ReadySpill_t* spill);
+
+#endif //READY_SPILL_H
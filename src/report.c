@@ -0,0 +1,213 @@
+/**
+ * @file report.c
+ * @brief Defines the end of run analytics printed by the simulator program
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "report.h"
+// Library imports
+#include <stdio.h>
+
+// Completed processes fetched from the simulator at a time
+#define REPORT_BATCH 256
+
+/**
+* @brief Prints the context switch counts and the CPU time they cost. Each preemption is charged
+* the preemption cost and the dispatch that follows it
+*/
+static void print_switch_totals(const ProcsimStats_t* stats, const SwitchCosts_t* costs) {
+	Procsim_Time busy_time = stats->last_event_time - stats->idle_time;
+	Procsim_Time useful_time = busy_time > stats->switch_overhead_time ? busy_time - stats->switch_overhead_time : 0;
+	printf("CONTEXT SWITCHES: DISPATCHES %ld, VOLUNTARY %ld, INVOLUNTARY %ld, I/O INTERRUPTS %ld, OVERHEAD TIME %lld, "
+		"LOST TO PREEMPTION %lld\n", stats->dispatches, stats->voluntary_switches, stats->involuntary_switches,
+		stats->io_interrupts, stats->switch_overhead_time,
+		(Procsim_Time)stats->involuntary_switches * (costs->preemption + costs->context_switch));
+	printf("CPU TIME: BUSY %lld, OVERHEAD %lld, USEFUL %lld (%.2f%%)\n", busy_time, stats->switch_overhead_time,
+		useful_time, busy_time > 0 ? 100.0 * useful_time / busy_time : 0.0);
+}
+
+/**
+* @brief Prints the CPU share and ready wait of every process group next to the share its weight
+* entitles it to among the groups that started a process
+*/
+static void print_group_summaries(const Procsim_t* simulator) {
+	GroupStats_t stats;
+	Procsim_Time total_cpu_time = 0;
+	long total_weight = 0;
+	for (int i = 0; i < procsim_get_group_count(simulator); i++) {
+		procsim_get_group_stats(simulator, i, &stats);
+		if (stats.active) {
+			total_cpu_time += stats.cpu_time;
+			total_weight += stats.weight;
+		}
+	}
+
+	for (int i = 0; i < procsim_get_group_count(simulator); i++) {
+		procsim_get_group_stats(simulator, i, &stats);
+		if (!stats.active) {
+			continue;
+		}
+
+		long completed = stats.processes_completed > 0 ? stats.processes_completed : 1;
+		printf("GROUP: %d, WEIGHT: %d, PROCESSES: %ld, CPU TIME: %lld, SHARE: %.2f%%, FAIR SHARE: %.2f%%, "
+			"READY WAIT TIME: TOTAL %lld, MEAN %.2f, MAX %lld\n", stats.group, stats.weight, stats.processes_completed,
+			stats.cpu_time, total_cpu_time > 0 ? 100.0 * stats.cpu_time / total_cpu_time : 0.0,
+			100.0 * stats.weight / total_weight, stats.total_ready_wait_time,
+			(double)stats.total_ready_wait_time / completed, stats.max_ready_wait_time);
+	}
+}
+
+/**
+* @brief Prints one line per completed process followed by the wait time totals, means and maxima
+* @param simulator: the simulator
+*/
+void print_process_summaries(const Procsim_t* simulator) {
+	ProcsimStats_t stats;
+	procsim_get_stats(simulator, &stats);
+	SwitchCosts_t costs;
+	bool show_switches = procsim_get_switch_costs(simulator, &costs);
+	if (stats.processes_completed == 0) {
+		fprintf(stderr,"ERROR: List is empty!\n\n");
+		return;
+	}
+
+	ProcessResult_t results[REPORT_BATCH];
+	int count;
+	long printed = 0;
+	for (int first = 0; (count = procsim_get_process_results(simulator, first, REPORT_BATCH, results)) > 0; first += count) {
+		for (int i = 0; i < count; i++) {
+			printf("PID: %lld, PRIORITY: %d, READY WAIT TIME: %lld, I/O WAIT TIME: %lld", results[i].PID,
+				results[i].priority, results[i].ready_wait_time, results[i].io_wait_time);
+			if (show_switches) {
+				printf(", SWITCHES: VOLUNTARY %d, INVOLUNTARY %d", results[i].voluntary_switches, results[i].involuntary_switches);
+			}
+			printf("\n");
+		}
+		printed += count;
+	}
+	if (printed < stats.processes_completed) {
+		printf("(%ld EARLIER PROCESSES ONLY COUNTED IN THE TOTALS)\n", stats.processes_completed - printed);
+	}
+	printf("\n");
+
+	printf("PROCESSES: %ld, READY WAIT TIME: TOTAL %lld, MEAN %.2f, MAX %lld, I/O WAIT TIME: TOTAL %lld, MEAN %.2f, MAX %lld\n",
+		stats.processes_completed, stats.total_ready_wait_time, (double)stats.total_ready_wait_time / stats.processes_completed,
+		stats.max_ready_wait_time, stats.total_io_wait_time, (double)stats.total_io_wait_time / stats.processes_completed,
+		stats.max_io_wait_time);
+	Scheduling_Policy policy = procsim_get_scheduling_policy(simulator);
+	if (policy == SCHEDULE_SJF || policy == SCHEDULE_SRTF) {
+		long bursts = stats.bursts_predicted > 0 ? stats.bursts_predicted : 1;
+		printf("BURST PREDICTION ERROR: BURSTS %ld, TOTAL %lld, MEAN %.2f, MAX %lld\n", stats.bursts_predicted,
+			stats.total_prediction_error, (double)stats.total_prediction_error / bursts, stats.max_prediction_error);
+	}
+	if (policy == SCHEDULE_FAIR_SHARE) {
+		print_group_summaries(simulator);
+	}
+	if (show_switches) {
+		print_switch_totals(&stats, &costs);
+	}
+}
+
+// Run totals labels, indexed by Scheduling_Policy
+static const char* run_totals_labels[SCHEDULE_POLICY_COUNT] = {
+	"NON-PREEMPTIVE", "PREEMPTIVE", "SJF", "SRTF", "FAIR-SHARE"
+};
+
+/**
+* @brief Prints one line of run totals, labeled with the scheduler type
+*/
+static void print_run_totals(const Procsim_t* simulator) {
+	ProcsimStats_t stats;
+	procsim_get_stats(simulator, &stats);
+	long completed = stats.processes_completed > 0 ? stats.processes_completed : 1;
+	printf("%s: PROCESSES %ld, IDLE TIME %lld, MEAN READY WAIT TIME %.2f, MAX %lld, MEAN I/O WAIT TIME %.2f, MAX %lld\n",
+		run_totals_labels[procsim_get_scheduling_policy(simulator)], stats.processes_completed, stats.idle_time,
+		(double)stats.total_ready_wait_time / completed, stats.max_ready_wait_time,
+		(double)stats.total_io_wait_time / completed, stats.max_io_wait_time);
+	Scheduling_Policy policy = procsim_get_scheduling_policy(simulator);
+	if (policy == SCHEDULE_SJF || policy == SCHEDULE_SRTF) {
+		long bursts = stats.bursts_predicted > 0 ? stats.bursts_predicted : 1;
+		printf("%s: BURST PREDICTION ERROR MEAN %.2f, MAX %lld\n", run_totals_labels[procsim_get_scheduling_policy(simulator)],
+			(double)stats.total_prediction_error / bursts, stats.max_prediction_error);
+	}
+	SwitchCosts_t costs;
+	if (procsim_get_switch_costs(simulator, &costs)) {
+		printf("%s: VOLUNTARY SWITCHES %ld, INVOLUNTARY %ld, SWITCH OVERHEAD TIME %lld\n",
+			run_totals_labels[procsim_get_scheduling_policy(simulator)], stats.voluntary_switches,
+			stats.involuntary_switches, stats.switch_overhead_time);
+	}
+}
+
+/**
+* @brief Prints the run totals of a simulator next to those of a branch forked from it
+* @param simulator: the simulator
+* @param branch: the branch
+* @param branch_time: time of the last event before the branch was forked
+*/
+void print_branch_comparison(const Procsim_t* simulator, const Procsim_t* branch, Procsim_Time branch_time) {
+	printf("\nWHAT-IF BRANCH AFTER TIME %lld\n", branch_time);
+	print_run_totals(simulator);
+	print_run_totals(branch);
+}
+
+/**
+* @brief Prints the seek distance, queueing delay, throughput and occupancy statistics of every
+* device that was configured
+* @param simulator: the simulator
+*/
+void print_io_device_summaries(const Procsim_t* simulator) {
+	DeviceStats_t stats;
+	for (int i = 0; i < procsim_get_device_count(simulator); i++) {
+		procsim_get_device_stats(simulator, i, &stats);
+		if (!stats.configured) {
+			continue;
+		}
+
+		printf("DEVICE: %d, POLICY: %s, CHANNELS: %d, REQUESTS: %ld, SEEK DISTANCE: %ld, AVG QUEUE DELAY: %.2f, MAX QUEUE DELAY: %lld, "
+			"THROUGHPUT: %.3f, AVG IN-FLIGHT: %.2f, MAX IN-FLIGHT: %d\n",
+			stats.id, get_io_policy_name(stats.policy), stats.queue_depth, stats.serviced_requests,
+			stats.total_seek_distance, stats.average_queue_delay, stats.max_queue_delay,
+			stats.throughput, stats.average_in_flight, stats.max_in_flight);
+	}
+}
+
+/**
+* @brief Prints the spill, merge and refill statistics of the scratch file, if the waiting
+* processes were bounded
+* @param simulator: the simulator
+*/
+void print_ready_spill_summary(const Procsim_t* simulator) {
+	ReadySpillStats_t stats;
+	if (!procsim_get_ready_spill_stats(simulator, &stats)) {
+		return;
+	}
+
+	printf("READY SPILL: LIMIT %d, SPILLED PROCESSES %ld, RUNS %ld, MERGES %ld, REFILLS %ld, REFILLED PROCESSES %ld, "
+		"MOST SPILLED %ld, SCRATCH BYTES %ld\n", stats.memory_limit, stats.processes_spilled, stats.runs_written,
+		stats.run_merges, stats.refills, stats.processes_refilled, stats.max_spilled, stats.scratch_bytes);
+}
+
+/**
+* @brief Prints the backend, switches and per operation costs of the ready queue, if it was
+* adaptive
+* @param simulator: the simulator
+*/
+void print_ready_queue_summary(const Procsim_t* simulator) {
+	ReadyQueueStats_t stats;
+	if (!procsim_get_ready_queue_stats(simulator, &stats)) {
+		return;
+	}
+
+	printf("READY QUEUE: BACKEND %s, SWITCHES %ld, MAX DEPTH %d, MAX PRIORITIES %d", get_ready_queue_backend_name(stats.backend),
+		stats.switches, stats.max_depth, stats.max_distinct_priorities);
+	for (int i = 0; i < READY_QUEUE_BACKEND_COUNT; i++) {
+		printf(", %s OPERATIONS %ld, NS PER OPERATION %.1f", get_ready_queue_backend_name((Ready_Queue_Backend)i),
+			stats.operations[i], stats.nanoseconds_per_operation[i]);
+	}
+	printf("\n");
+}
@@ -0,0 +1,53 @@
+/**
+ * @file report.h
+ * @brief Declares the end of run analytics printed by the simulator program, built from
+ *		  the statistics libprocsim reports
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+// Header imports
+#include "procsim.h"
+
+/**
+* @brief Prints one line per completed process followed by the wait time totals, means and maxima
+* @param simulator: the simulator
+*/
+void print_process_summaries(const Procsim_t* simulator);
+
+/**
+* @brief Prints the seek distance, queueing delay, throughput and occupancy statistics of every
+* device that was configured
+* @param simulator: the simulator
+*/
+void print_io_device_summaries(const Procsim_t* simulator);
+
+/**
+* @brief Prints the run totals of a simulator next to those of a branch forked from it
+* @param simulator: the simulator
+* @param branch: the branch
+* @param branch_time: time of the last event before the branch was forked
+*/
+void print_branch_comparison(const Procsim_t* simulator, const Procsim_t* branch, Procsim_Time branch_time);
+
+/**
+* @brief Prints the spill, merge and refill statistics of the scratch file, if the waiting
+* processes were bounded
+* @param simulator: the simulator
+*/
+void print_ready_spill_summary(const Procsim_t* simulator);
+
+/**
+* @brief Prints the backend, switches and per operation costs of the ready queue, if it was
+* adaptive
+* @param simulator: the simulator
+*/
+void print_ready_queue_summary(const Procsim_t* simulator);
+
+#endif //REPORT_H
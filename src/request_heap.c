@@ -0,0 +1,171 @@
+/**
+ * @file request_heap.c
+ * @brief Defines functionality of a binary min-heap of PCB's ordered by an integer key
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "request_heap.h"
+#include "instrumentation.h"
+#include "fatal_error.h"
+// Library imports
+#include <stdlib.h>
+
+/**
+* @brief Checks if entry a should leave the heap before entry b
+*/
+static bool entry_before(const HeapEntry_t* a, const HeapEntry_t* b) {
+	if (a->key != b->key) {
+		return a->key < b->key;
+	}
+	return a->sequence < b->sequence;
+}
+
+/**
+* @brief Initializes the contents of the heap struct to empty
+* @param heap: the heap to initialize
+*/
+void initialize_request_heap(RequestHeap_t* heap) {
+	heap->entries = NULL;
+	heap->size = 0;
+	heap->capacity = 0;
+	heap->next_sequence = 0;
+}
+
+/**
+* @brief Adds a PCB to the heap
+* @param heap: the heap
+* @param key: ordering key, smallest key leaves first
+* @param data: PCB data to add
+*/
+void push_request_heap(RequestHeap_t* heap, long key, PCB_t* data) {
+	if (heap->size == heap->capacity) {
+		// Grow the backing array
+		int new_capacity = heap->capacity == 0 ? 8 : heap->capacity * 2;
+		INSTRUMENT_MEMORY_ALLOCATION();
+		HeapEntry_t* grown = (HeapEntry_t*)realloc(heap->entries, new_capacity * sizeof(HeapEntry_t));
+		if (!grown) {
+			report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+		}
+		heap->entries = grown;
+		heap->capacity = new_capacity;
+	}
+
+	HeapEntry_t entry = {key, heap->next_sequence++, data};
+
+	// Sift the new entry up from the bottom of the heap
+	int i = heap->size++;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!entry_before(&entry, &heap->entries[parent])) {
+			break;
+		}
+		heap->entries[i] = heap->entries[parent];
+		i = parent;
+	}
+	heap->entries[i] = entry;
+}
+
+/**
+* @brief Removes the entry with the smallest key
+* @param heap: the heap
+* @return the PCB of the removed entry
+*/
+PCB_t* pop_request_heap(RequestHeap_t* heap) {
+	if (is_empty_request_heap(heap)) {
+		// Heap is empty, throw an error
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Heap is already empty!");
+	}
+
+	PCB_t* top = heap->entries[0].data;
+	HeapEntry_t last = heap->entries[--heap->size];
+
+	// Sift the last entry down from the root of the heap
+	int i = 0;
+	while (true) {
+		int child = 2 * i + 1;
+		if (child >= heap->size) {
+			break;
+		}
+		if (child + 1 < heap->size && entry_before(&heap->entries[child + 1], &heap->entries[child])) {
+			child++;
+		}
+		if (!entry_before(&heap->entries[child], &last)) {
+			break;
+		}
+		heap->entries[i] = heap->entries[child];
+		i = child;
+	}
+	if (heap->size > 0) {
+		heap->entries[i] = last;
+	}
+
+	return top;
+}
+
+/**
+* @brief View the smallest key in the heap
+* @param heap: the heap
+* @return the smallest key
+*/
+long peek_key_request_heap(const RequestHeap_t* heap) {
+	if (is_empty_request_heap(heap)) {
+		report_fatal_error(PROCSIM_CORRUPT_STATE, "Heap is empty!");
+	}
+
+	return heap->entries[0].key;
+}
+
+/**
+* @brief checks if the heap is empty
+* @param heap: the heap
+* @return true if empty, false if not
+*/
+bool is_empty_request_heap(const RequestHeap_t* heap) {
+	return heap->size == 0;
+}
+
+/**
+* @brief checks the size of the heap
+* @param heap: the heap
+* @return size of the heap
+*/
+int get_size_request_heap(const RequestHeap_t* heap) {
+	return heap->size;
+}
+
+/**
+* @brief clears the contents of the heap from memory
+* @param heap: heap to clear from memory
+*/
+void free_request_heap(RequestHeap_t* heap) {
+	free(heap->entries);
+	initialize_request_heap(heap);
+}
+
+/**
+* @brief Makes an independent copy of a heap for a cloned simulator
+* @param clone: the heap to fill in, not initialized
+* @param heap: the heap to copy
+* @param pcb_store: the cloned store, already holding copies of the heap's PCB's
+*/
+void clone_request_heap(RequestHeap_t* clone, const RequestHeap_t* heap, const PCB_Store_t* pcb_store) {
+	*clone = *heap;
+	if (heap->capacity == 0) {
+		return;
+	}
+
+	INSTRUMENT_MEMORY_ALLOCATION();
+	clone->entries = (HeapEntry_t*)malloc(heap->capacity * sizeof(HeapEntry_t));
+	if (!clone->entries) {
+		report_fatal_error(PROCSIM_OUT_OF_MEMORY, "Memory allocation failed!");
+	}
+	for (int i = 0; i < heap->size; i++) {
+		clone->entries[i] = heap->entries[i];
+		clone->entries[i].data = get_cloned_pcb(pcb_store, heap->entries[i].data);
+	}
+}
@@ -0,0 +1,98 @@
+/**
+ * @file request_heap.h
+ * @brief Declares functionality of a binary min-heap of PCB's ordered by an integer key.
+ *		  Used by the I/O devices to pick their next request in O(log n)
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef REQUEST_HEAP_H
+#define REQUEST_HEAP_H
+
+// Header imports
+#include "PCB.h"
+#include "pcb_store.h"
+// Library imports
+#include <stdbool.h>
+
+/**
+* @struct HeapEntry_t
+* @brief Defines a single heap entry. Entries with equal keys leave in insertion order
+*/
+typedef struct heap_entry {
+	long key;
+	unsigned long sequence;
+	PCB_t* data;
+} HeapEntry_t;
+
+/**
+* @struct RequestHeap_t
+* @brief Defines the attributes of a request heap
+*/
+typedef struct request_heap {
+	HeapEntry_t* entries;
+	int size;
+	int capacity;
+	unsigned long next_sequence;
+} RequestHeap_t;
+
+/**
+* @brief Initializes the contents of the heap struct to empty
+* @param heap: the heap to initialize
+*/
+void initialize_request_heap(RequestHeap_t* heap);
+
+/**
+* @brief Adds a PCB to the heap
+* @param heap: the heap
+* @param key: ordering key, smallest key leaves first
+* @param data: PCB data to add
+*/
+void push_request_heap(RequestHeap_t* heap, long key, PCB_t* data);
+
+/**
+* @brief Removes the entry with the smallest key
+* @param heap: the heap
+* @return the PCB of the removed entry
+*/
+PCB_t* pop_request_heap(RequestHeap_t* heap);
+
+/**
+* @brief View the smallest key in the heap
+* @param heap: the heap
+* @return the smallest key
+*/
+long peek_key_request_heap(const RequestHeap_t* heap);
+
+/**
+* @brief checks if the heap is empty
+* @param heap: the heap
+* @return true if empty, false if not
+*/
+bool is_empty_request_heap(const RequestHeap_t* heap);
+
+/**
+* @brief checks the size of the heap
+* @param heap: the heap
+* @return size of the heap
+*/
+int get_size_request_heap(const RequestHeap_t* heap);
+
+/**
+* @brief Makes an independent copy of a heap for a cloned simulator
+* @param clone: the heap to fill in, not initialized
+* @param heap: the heap to copy
+* @param pcb_store: the cloned store, already holding copies of the heap's PCB's
+*/
+void clone_request_heap(RequestHeap_t* clone, const RequestHeap_t* heap, const PCB_Store_t* pcb_store);
+
+/**
+* @brief clears the contents of the heap from memory
+* @param heap: heap to clear from memory
+*/
+void free_request_heap(RequestHeap_t* heap);
+
+#endif //REQUEST_HEAP_H
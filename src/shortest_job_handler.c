@@ -0,0 +1,268 @@
+/**
+ * @file shortest_job_handler.c
+ * @brief Defines the SJF and SRTF scheduler functions declared in Scheduler.h. The ready queue
+ *		  is a heap keyed by the predicted CPU burst of each process, which is an exponential
+ *		  average of its earlier bursts
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "Scheduler.h"
+#include "request_heap.h"
+#include "io_device.h"
+#include "PCB.h"
+#include "pcb_store.h"
+
+/**
+* @brief Adds a process to the ready heap, keyed by what is predicted to be left of its burst
+*/
+static void make_ready(SchedulerHandler* schedulerHandler, PCB_t* process, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+	process->state = READY;
+	store->start_ready_time[process->slot] = current_time;
+	push_request_heap((RequestHeap_t*)schedulerHandler->queue, get_remaining_burst(store, process), process);
+	log_event(schedulerHandler, LOG_PROCESS_READY, current_time, process, NULL);
+}
+
+/**
+* @brief Gives the CPU to a process and starts timing its run
+*/
+static void run_process(SchedulerHandler* schedulerHandler, PCB_t* process, Procsim_Time current_time) {
+	process->state = RUNNING;
+	schedulerHandler->CPU = process;
+	schedulerHandler->pcb_store->bursts.run_start_time[process->slot] = current_time;
+	log_event(schedulerHandler, LOG_PROCESS_SCHEDULED, current_time, process, NULL);
+	charge_dispatch(schedulerHandler->pcb_store);
+}
+
+/**
+* @brief Sends the waiting process with the shortest predicted burst to the CPU, or idles the
+* CPU if none is waiting
+*/
+static void dispatch_next_process(SchedulerHandler* schedulerHandler, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+	RequestHeap_t* ready_heap = (RequestHeap_t*)schedulerHandler->queue;
+
+	if (!is_empty_request_heap(ready_heap)) {
+		PCB_t* new_process = pop_request_heap(ready_heap);
+		run_process(schedulerHandler, new_process, current_time);
+
+		// Process analytics
+		store->total_ready_time[new_process->slot] += current_time - store->start_ready_time[new_process->slot];
+	} else {
+		// If there are no processes in the queue, the CPU goes idle
+		schedulerHandler->CPU = NULL;
+
+		// System analytics
+		schedulerHandler->start_idle_time = current_time;
+	}
+}
+
+/**
+* @brief Dispatches a waiting process to the idle CPU, ending the idle period
+*/
+static void end_idle_period(SchedulerHandler* schedulerHandler, Procsim_Time current_time) {
+	dispatch_next_process(schedulerHandler, current_time);
+
+	// System analytics
+	schedulerHandler->end_idle_time = current_time;
+	schedulerHandler->total_idle_time += schedulerHandler->end_idle_time - schedulerHandler->start_idle_time;
+}
+
+/**
+* @brief Preempts the running process when a waiting one is predicted to finish its burst
+* first. Between equal predictions the running process keeps the CPU
+*/
+static void preempt_if_shorter(SchedulerHandler* schedulerHandler, Procsim_Time current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+	RequestHeap_t* ready_heap = (RequestHeap_t*)schedulerHandler->queue;
+	PCB_t* running = schedulerHandler->CPU;
+
+	int slot = running->slot;
+	long remaining = store->bursts.predicted_burst[slot] - store->bursts.burst_time[slot]
+					 - (current_time - store->bursts.run_start_time[slot]);
+	if (remaining < 0) {
+		remaining = 0;
+	}
+	if (peek_key_request_heap(ready_heap) >= remaining) {
+		return;
+	}
+
+	// The burst goes on where it left off once the process runs again
+	store->bursts.burst_time[slot] += current_time - store->bursts.run_start_time[slot];
+	running->state = READY;
+	store->start_ready_time[slot] = current_time;
+	push_request_heap(ready_heap, get_remaining_burst(store, running), running);
+	log_event(schedulerHandler, LOG_PROCESS_PREEMPTED, current_time, running, NULL);
+	charge_switch_out(store, running, true);
+
+	dispatch_next_process(schedulerHandler, current_time);
+}
+
+/**
+* @brief Starts a process, running it right away on an idle CPU
+*/
+static void start_process(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time current_time, bool preemptive) {
+	// Create a new PCB for the new process
+	PCB_t* new_process = allocate_pcb(schedulerHandler->pcb_store);
+	new_process->priority = priority;
+	new_process->PID = *PID_tracker;
+	assign_process_group(schedulerHandler->pcb_store, new_process, group);
+
+	// Iterate the PID tracker so new processes get new ID's
+	(*PID_tracker)++;
+
+	log_event(schedulerHandler, LOG_PROCESS_STARTED, current_time, new_process, NULL);
+	if (schedulerHandler->CPU == NULL) {
+		// No process is currently running in the CPU, assign new process to CPU
+		run_process(schedulerHandler, new_process, current_time);
+
+		// System analytics
+		schedulerHandler->end_idle_time = current_time;
+		schedulerHandler->total_idle_time += schedulerHandler->end_idle_time - schedulerHandler->start_idle_time;
+	} else {
+		make_ready(schedulerHandler, new_process, current_time);
+		if (preemptive) {
+			preempt_if_shorter(schedulerHandler, current_time);
+		}
+	}
+}
+
+/**
+* @brief Returns the processes of a finished I/O request to the ready heap
+*/
+static void complete_io(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time current_time, bool preemptive) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Remove the processes from the I/O device. Submitted events always release one, but a
+	// completion with nothing to release leaves everything as it was
+	int request_count = get_io_request_count(io_device);
+	if (request_count == 0) {
+		return;
+	}
+	PCB_t* stack_processes[HANDLER_STACK_PROCESSES];
+	PCB_t** io_processes = get_process_buffer(stack_processes, request_count);
+	int io_device_queue_size = release_io_requests(io_device, PID, current_time, io_processes);
+	if (io_device_queue_size == 0) {
+		release_process_buffer(io_processes, stack_processes);
+		return;
+	}
+
+	// Process analytics
+	for (int i = 0; i < io_device_queue_size; i++) {
+		store->total_io_blocked_time[io_processes[i]->slot] += current_time - store->start_io_blocked_time[io_processes[i]->slot];
+		log_event(schedulerHandler, LOG_IO_RELEASED, current_time, io_processes[i], io_device);
+	}
+	log_event(schedulerHandler, LOG_IO_COMPLETED, current_time, NULL, io_device);
+	charge_io_interrupt(store);
+
+	// The heap picks the shortest of the released and the already waiting processes
+	for (int i = 0; i < io_device_queue_size; i++) {
+		make_ready(schedulerHandler, io_processes[i], current_time);
+	}
+	release_process_buffer(io_processes, stack_processes);
+	if (schedulerHandler->CPU == NULL) {
+		end_idle_period(schedulerHandler, current_time);
+	} else if (preemptive) {
+		preempt_if_shorter(schedulerHandler, current_time);
+	}
+}
+
+/**
+* @brief Handles the event of starting of a process using SJF scheduling. The process waits
+* with its initial burst prediction unless the CPU is idle
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void sjf_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time) {
+	start_process(schedulerHandler, priority, group, PID_tracker, *current_time, false);
+}
+
+/**
+* @brief Handles the event of starting of a process using SRTF scheduling. The process preempts
+* the running one if its predicted burst is shorter than what the running one has left
+* @param schedulerHandler: A reference to the current scheduler
+* @param priority: a new processes priority
+* @param group: the process group of the new process
+* @param PID_tracker: reference to the current value of PID tracker, used to assign a PID to a new process
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void srtf_process_start(SchedulerHandler* schedulerHandler, int priority, int group, Procsim_PID* PID_tracker, Procsim_Time* current_time) {
+	start_process(schedulerHandler, priority, group, PID_tracker, *current_time, true);
+}
+
+/**
+* @brief Handles the event where an active process requests an I/O device using SJF or SRTF
+* scheduling. The request ends the process's CPU burst
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the requested I/O device
+* @param sector: the sector address targeted by the request
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void shortest_job_io_request(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, int sector, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Send the current PCB to the desired I/O device
+	PCB_t* io_requested_process = schedulerHandler->CPU;
+	end_cpu_burst(store, io_requested_process, *current_time);
+	io_requested_process->state = BLOCKED;
+	io_requested_process->target_io_device = io_device->id;
+	io_requested_process->target_sector = sector;
+
+	// Process analytics
+	store->start_io_blocked_time[io_requested_process->slot] = *current_time;
+
+	add_io_request(io_device, io_requested_process, *current_time);
+	log_event(schedulerHandler, LOG_IO_WAITING, *current_time, io_requested_process, io_device);
+	charge_switch_out(store, io_requested_process, false);
+
+	dispatch_next_process(schedulerHandler, *current_time);
+}
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using SJF scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void sjf_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time) {
+	complete_io(schedulerHandler, io_device, PID, *current_time, false);
+}
+
+/**
+* @brief Handles the event where an I/O device completes its tasks using SRTF scheduling
+* @param schedulerHandler: A reference to the current scheduler
+* @param io_device: a reference to the finished I/O device
+* @param PID: the process whose request finished, or 0 when every request on the device finished
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void srtf_io_complete(SchedulerHandler* schedulerHandler, IO_Device_t* io_device, Procsim_PID PID, Procsim_Time* current_time) {
+	complete_io(schedulerHandler, io_device, PID, *current_time, true);
+}
+
+/**
+* @brief Handles the event where an active process terminates using SJF or SRTF scheduling.
+* The process is recorded in the completed process analytics of the PCB store
+* @param schedulerHandler: A reference to the current scheduler
+* @param current_time: reference to the current time, used for analytics and marking events
+*/
+void shortest_job_process_end(SchedulerHandler* schedulerHandler, Procsim_Time* current_time) {
+	PCB_Store_t* store = schedulerHandler->pcb_store;
+
+	// Retrieve the current process, score its last burst and record it in the completed process analytics
+	PCB_t* ended_process = schedulerHandler->CPU;
+	end_cpu_burst(store, ended_process, *current_time);
+	log_event(schedulerHandler, LOG_PROCESS_ENDED, *current_time, ended_process, NULL);
+	charge_switch_out(store, ended_process, false);
+	complete_pcb(store, ended_process);
+
+	dispatch_next_process(schedulerHandler, *current_time);
+}
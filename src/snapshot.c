@@ -0,0 +1,583 @@
+/**
+ * @file snapshot.c
+ * @brief Defines the functions that save the complete simulator state to a binary
+ *		  snapshot file and restore it so an interrupted run can continue.
+ *
+ * Every PCB is live in exactly one place (the CPU, the ready queue, a device channel or a
+ * device waiting structure), so PCB's are written inline, together with their statistics
+ * from the PCB store, where they are referenced and each structure is rebuilt in its exact
+ * original order on restore. Values are stored in host byte order, so snapshots are only
+ * meant to be resumed on the same kind of machine.
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "snapshot.h"
+#include "procsim_internal.h"
+// Library imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC 0x504e5350	// "PSNP"
+#define SNAPSHOT_VERSION 8
+
+/**
+* @struct SnapshotWriter_t
+* @brief Tracks the output file of a save and the store holding the PCB statistics
+*/
+typedef struct snapshot_writer {
+	FILE* file;
+	const PCB_Store_t* pcb_store;
+} SnapshotWriter_t;
+
+/**
+* @struct SnapshotReader_t
+* @brief Tracks the input file of a restore, the store receiving the PCB's and whether
+* every read so far succeeded
+*/
+typedef struct snapshot_reader {
+	FILE* file;
+	PCB_Store_t* pcb_store;
+	bool ok;
+} SnapshotReader_t;
+
+/**
+* @brief Writes a raw value to the snapshot file
+*/
+static void put_value(FILE* file, const void* value, size_t size) {
+	fwrite(value, size, 1, file);
+}
+
+/**
+* @brief Reads a raw value from the snapshot file, marking the reader as failed on a short read
+*/
+static void get_value(SnapshotReader_t* reader, void* value, size_t size) {
+	if (reader->ok && fread(value, size, 1, reader->file) != 1) {
+		reader->ok = false;
+	}
+}
+
+/**
+* @brief Writes a PCB and its statistics to the snapshot file, or a marker when there is none
+*/
+static void put_pcb(SnapshotWriter_t* writer, const PCB_t* pcb) {
+	char present = pcb != NULL;
+	put_value(writer->file, &present, sizeof(present));
+	if (!present) {
+		return;
+	}
+
+	const PCB_Store_t* store = writer->pcb_store;
+	put_value(writer->file, pcb, sizeof(PCB_t));
+	put_value(writer->file, &store->start_ready_time[pcb->slot], sizeof(store->start_ready_time[0]));
+	put_value(writer->file, &store->total_ready_time[pcb->slot], sizeof(store->total_ready_time[0]));
+	put_value(writer->file, &store->start_io_blocked_time[pcb->slot], sizeof(store->start_io_blocked_time[0]));
+	put_value(writer->file, &store->total_io_blocked_time[pcb->slot], sizeof(store->total_io_blocked_time[0]));
+	put_value(writer->file, &store->bursts.predicted_burst[pcb->slot], sizeof(store->bursts.predicted_burst[0]));
+	put_value(writer->file, &store->bursts.burst_time[pcb->slot], sizeof(store->bursts.burst_time[0]));
+	put_value(writer->file, &store->bursts.run_start_time[pcb->slot], sizeof(store->bursts.run_start_time[0]));
+	put_value(writer->file, &store->switches.voluntary[pcb->slot], sizeof(store->switches.voluntary[0]));
+	put_value(writer->file, &store->switches.involuntary[pcb->slot], sizeof(store->switches.involuntary[0]));
+}
+
+/**
+* @brief Reads a PCB and its statistics from the snapshot file into a new slot of the store
+* @return the PCB, or NULL if none was stored or the read failed
+*/
+static PCB_t* get_pcb(SnapshotReader_t* reader) {
+	char present = 0;
+	get_value(reader, &present, sizeof(present));
+	if (!reader->ok || !present) {
+		return NULL;
+	}
+
+	// The PCB may land in a different slot than it had when it was saved
+	PCB_Store_t* store = reader->pcb_store;
+	PCB_t* pcb = allocate_pcb(store);
+	int slot = pcb->slot;
+	get_value(reader, pcb, sizeof(PCB_t));
+	pcb->slot = slot;
+	pcb->next = NULL;	// Queue links are rebuilt by the list that holds the PCB
+	get_value(reader, &store->start_ready_time[slot], sizeof(store->start_ready_time[0]));
+	get_value(reader, &store->total_ready_time[slot], sizeof(store->total_ready_time[0]));
+	get_value(reader, &store->start_io_blocked_time[slot], sizeof(store->start_io_blocked_time[0]));
+	get_value(reader, &store->total_io_blocked_time[slot], sizeof(store->total_io_blocked_time[0]));
+	get_value(reader, &store->bursts.predicted_burst[slot], sizeof(store->bursts.predicted_burst[0]));
+	get_value(reader, &store->bursts.burst_time[slot], sizeof(store->bursts.burst_time[0]));
+	get_value(reader, &store->bursts.run_start_time[slot], sizeof(store->bursts.run_start_time[0]));
+	get_value(reader, &store->switches.voluntary[slot], sizeof(store->switches.voluntary[0]));
+	get_value(reader, &store->switches.involuntary[slot], sizeof(store->switches.involuntary[0]));
+	return pcb;
+}
+
+/**
+* @brief Writes a PCB list (the layout shared by Queue_t and PriorityQueue_t) in order
+*/
+static void put_pcb_list(SnapshotWriter_t* writer, const PCB_t* head, int size) {
+	put_value(writer->file, &size, sizeof(size));
+	for (const PCB_t* pcb = head; pcb != NULL; pcb = pcb->next) {
+		put_pcb(writer, pcb);
+	}
+}
+
+/**
+* @brief Reads a PCB list back in its original order
+* @param reader: the snapshot reader
+* @param head: filled in with the first PCB
+* @param tail: filled in with the last PCB
+* @return the number of PCB's
+*/
+static int get_pcb_list(SnapshotReader_t* reader, PCB_t** head, PCB_t** tail) {
+	int size = 0;
+	get_value(reader, &size, sizeof(size));
+	*head = NULL;
+	*tail = NULL;
+
+	// Link PCB's directly instead of re-inserting, so equal priorities keep their order
+	for (int i = 0; i < size && reader->ok; i++) {
+		PCB_t* pcb = get_pcb(reader);
+		if (pcb == NULL) {
+			break;
+		}
+		if (*tail == NULL) {
+			*head = pcb;
+		} else {
+			(*tail)->next = pcb;
+		}
+		*tail = pcb;
+	}
+	return size;
+}
+
+/**
+* @brief Writes a request heap in storage order
+*/
+static void put_request_heap(SnapshotWriter_t* writer, const RequestHeap_t* heap) {
+	put_value(writer->file, &heap->size, sizeof(heap->size));
+	put_value(writer->file, &heap->next_sequence, sizeof(heap->next_sequence));
+	for (int i = 0; i < heap->size; i++) {
+		put_value(writer->file, &heap->entries[i].key, sizeof(heap->entries[i].key));
+		put_value(writer->file, &heap->entries[i].sequence, sizeof(heap->entries[i].sequence));
+		put_pcb(writer, heap->entries[i].data);
+	}
+}
+
+/**
+* @brief Reads a request heap back in storage order
+*/
+static void get_request_heap(SnapshotReader_t* reader, RequestHeap_t* heap) {
+	int size = 0;
+	get_value(reader, &size, sizeof(size));
+	get_value(reader, &heap->next_sequence, sizeof(heap->next_sequence));
+	if (!reader->ok || size == 0) {
+		return;
+	}
+
+	heap->entries = (HeapEntry_t*)malloc(size * sizeof(HeapEntry_t));
+	if (!heap->entries) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	heap->capacity = size;
+	for (int i = 0; i < size && reader->ok; i++) {
+		get_value(reader, &heap->entries[i].key, sizeof(heap->entries[i].key));
+		get_value(reader, &heap->entries[i].sequence, sizeof(heap->entries[i].sequence));
+		heap->entries[i].data = get_pcb(reader);
+		heap->size++;
+	}
+}
+
+/**
+* @brief Writes the fair-share queue: each group's waiting list and virtual time, then the heap
+*/
+static void put_fair_share_queue(SnapshotWriter_t* writer, const FairShareQueue_t* queue) {
+	put_value(writer->file, &queue->group_capacity, sizeof(queue->group_capacity));
+	for (int i = 0; i < queue->group_capacity; i++) {
+		const FairShareGroup_t* group = &queue->groups[i];
+		put_pcb_list(writer, group->waiting.head, group->waiting.size);
+		put_value(writer->file, &group->virtual_time, sizeof(group->virtual_time));
+		put_value(writer->file, &group->sequence, sizeof(group->sequence));
+	}
+	put_value(writer->file, &queue->heap_size, sizeof(queue->heap_size));
+	fwrite(queue->heap, sizeof(int), queue->heap_size, writer->file);
+	put_value(writer->file, &queue->size, sizeof(queue->size));
+	put_value(writer->file, &queue->virtual_clock, sizeof(queue->virtual_clock));
+	put_value(writer->file, &queue->next_sequence, sizeof(queue->next_sequence));
+}
+
+/**
+* @brief Reads the fair-share queue back, rebuilding the heap positions of the groups
+*/
+static void get_fair_share_queue(SnapshotReader_t* reader, FairShareQueue_t* queue) {
+	int group_capacity = 0;
+	get_value(reader, &group_capacity, sizeof(group_capacity));
+	if (!reader->ok || group_capacity <= 0 || group_capacity > 2 * PROCSIM_MAX_GROUPS) {
+		return;
+	}
+
+	queue->groups = (FairShareGroup_t*)malloc(group_capacity * sizeof(FairShareGroup_t));
+	queue->heap = (int*)malloc(group_capacity * sizeof(int));
+	if (!queue->groups || !queue->heap) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	queue->group_capacity = group_capacity;
+	for (int i = 0; i < group_capacity; i++) {
+		FairShareGroup_t* group = &queue->groups[i];
+		initialize_priority_queue(&group->waiting);
+		group->virtual_time = 0;
+		group->sequence = 0;
+		group->position = -1;
+		if (reader->ok) {
+			group->waiting.size = get_pcb_list(reader, &group->waiting.head, &group->waiting.tail);
+			get_value(reader, &group->virtual_time, sizeof(group->virtual_time));
+			get_value(reader, &group->sequence, sizeof(group->sequence));
+		}
+	}
+	get_value(reader, &queue->heap_size, sizeof(queue->heap_size));
+	if (queue->heap_size < 0 || queue->heap_size > group_capacity) {
+		queue->heap_size = 0;
+		reader->ok = false;
+	}
+	if (queue->heap_size > 0) {
+		get_value(reader, queue->heap, queue->heap_size * sizeof(int));
+	}
+	for (int i = 0; i < queue->heap_size && reader->ok; i++) {
+		if (queue->heap[i] < 0 || queue->heap[i] >= group_capacity) {
+			queue->heap_size = 0;
+			reader->ok = false;
+			break;
+		}
+		queue->groups[queue->heap[i]].position = i;
+	}
+	get_value(reader, &queue->size, sizeof(queue->size));
+	get_value(reader, &queue->virtual_clock, sizeof(queue->virtual_clock));
+	get_value(reader, &queue->next_sequence, sizeof(queue->next_sequence));
+}
+
+/**
+* @brief Writes the configuration, requests and analytics of an I/O device
+*/
+static void put_io_device(SnapshotWriter_t* writer, const IO_Device_t* io_device) {
+	put_value(writer->file, &io_device->policy, sizeof(io_device->policy));
+	put_value(writer->file, &io_device->configured, sizeof(io_device->configured));
+	put_value(writer->file, &io_device->queue_depth, sizeof(io_device->queue_depth));
+	put_value(writer->file, &io_device->in_flight_count, sizeof(io_device->in_flight_count));
+	for (int i = 0; i < io_device->in_flight_count; i++) {
+		put_pcb(writer, io_device->in_flight[i]);
+	}
+	put_pcb_list(writer, io_device->queue.head, io_device->queue.size);
+	put_request_heap(writer, &io_device->upper_heap);
+	put_request_heap(writer, &io_device->lower_heap);
+	put_value(writer->file, &io_device->head_sector, sizeof(io_device->head_sector));
+	put_value(writer->file, &io_device->sweeping_up, sizeof(io_device->sweeping_up));
+
+	// Device analytics
+	put_value(writer->file, &io_device->serviced_requests, sizeof(io_device->serviced_requests));
+	put_value(writer->file, &io_device->total_seek_distance, sizeof(io_device->total_seek_distance));
+	put_value(writer->file, &io_device->total_queue_delay, sizeof(io_device->total_queue_delay));
+	put_value(writer->file, &io_device->max_queue_delay, sizeof(io_device->max_queue_delay));
+	put_value(writer->file, &io_device->completed_requests, sizeof(io_device->completed_requests));
+	put_value(writer->file, &io_device->first_request_time, sizeof(io_device->first_request_time));
+	put_value(writer->file, &io_device->last_completion_time, sizeof(io_device->last_completion_time));
+	put_value(writer->file, &io_device->last_occupancy_time, sizeof(io_device->last_occupancy_time));
+	put_value(writer->file, &io_device->total_occupancy, sizeof(io_device->total_occupancy));
+	put_value(writer->file, &io_device->max_in_flight, sizeof(io_device->max_in_flight));
+}
+
+/**
+* @brief Reads the configuration, requests and analytics of an I/O device
+*/
+static void get_io_device(SnapshotReader_t* reader, IO_Device_t* io_device) {
+	int queue_depth = 1;
+	get_value(reader, &io_device->policy, sizeof(io_device->policy));
+	get_value(reader, &io_device->configured, sizeof(io_device->configured));
+	get_value(reader, &queue_depth, sizeof(queue_depth));
+	if (!reader->ok || queue_depth < 1) {
+		reader->ok = false;
+		return;
+	}
+	set_io_queue_depth(io_device, queue_depth);
+
+	get_value(reader, &io_device->in_flight_count, sizeof(io_device->in_flight_count));
+	if (!reader->ok || io_device->in_flight_count < 0 || io_device->in_flight_count > queue_depth) {
+		io_device->in_flight_count = 0;
+		reader->ok = false;
+		return;
+	}
+	for (int i = 0; i < io_device->in_flight_count && reader->ok; i++) {
+		io_device->in_flight[i] = get_pcb(reader);
+	}
+	io_device->queue.size = get_pcb_list(reader, &io_device->queue.head, &io_device->queue.tail);
+	get_request_heap(reader, &io_device->upper_heap);
+	get_request_heap(reader, &io_device->lower_heap);
+	get_value(reader, &io_device->head_sector, sizeof(io_device->head_sector));
+	get_value(reader, &io_device->sweeping_up, sizeof(io_device->sweeping_up));
+
+	// Device analytics
+	get_value(reader, &io_device->serviced_requests, sizeof(io_device->serviced_requests));
+	get_value(reader, &io_device->total_seek_distance, sizeof(io_device->total_seek_distance));
+	get_value(reader, &io_device->total_queue_delay, sizeof(io_device->total_queue_delay));
+	get_value(reader, &io_device->max_queue_delay, sizeof(io_device->max_queue_delay));
+	get_value(reader, &io_device->completed_requests, sizeof(io_device->completed_requests));
+	get_value(reader, &io_device->first_request_time, sizeof(io_device->first_request_time));
+	get_value(reader, &io_device->last_completion_time, sizeof(io_device->last_completion_time));
+	get_value(reader, &io_device->last_occupancy_time, sizeof(io_device->last_occupancy_time));
+	get_value(reader, &io_device->total_occupancy, sizeof(io_device->total_occupancy));
+	get_value(reader, &io_device->max_in_flight, sizeof(io_device->max_in_flight));
+}
+
+/**
+* @brief Writes the simulator state to a snapshot file. The file is written next to the
+* target and renamed over it, so an interrupted write never leaves a broken snapshot behind
+* @param path: the snapshot file
+* @param state: the state to save
+* @return true on success, false if the file could not be written
+*/
+bool save_snapshot(const char* path, const SnapshotState_t* state) {
+	char temp_path[strlen(path) + 5];
+	snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+	FILE* file = fopen(temp_path, "wb");
+	if (file == NULL) {
+		return false;
+	}
+	const Procsim_t* simulator = state->simulator;
+	SnapshotWriter_t snapshot_writer = {file, &simulator->pcb_store};
+	SnapshotWriter_t* writer = &snapshot_writer;
+
+	const SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	int magic = SNAPSHOT_MAGIC;
+	int version = SNAPSHOT_VERSION;
+
+	// Run position
+	put_value(writer->file, &magic, sizeof(magic));
+	put_value(writer->file, &version, sizeof(version));
+	put_value(writer->file, &simulator->scheduling_policy, sizeof(simulator->scheduling_policy));
+	put_value(writer->file, &state->input_offset, sizeof(state->input_offset));
+	put_value(writer->file, &state->event_time, sizeof(state->event_time));
+	put_value(writer->file, &state->events_processed, sizeof(state->events_processed));
+	put_value(writer->file, &simulator->PID_tracker, sizeof(simulator->PID_tracker));
+
+	// Scheduler state. Both list types share the same PCB list layout
+	put_pcb(writer, scheduler_handler->CPU);
+	if (is_shortest_job_policy(simulator->scheduling_policy)) {
+		put_request_heap(writer, (const RequestHeap_t*)scheduler_handler->queue);
+	} else if (simulator->scheduling_policy == SCHEDULE_FAIR_SHARE) {
+		put_fair_share_queue(writer, (const FairShareQueue_t*)scheduler_handler->queue);
+	} else {
+		const Queue_t* ready_queue = (const Queue_t*)scheduler_handler->queue;
+		put_pcb_list(writer, ready_queue->head, ready_queue->size);
+	}
+	put_value(writer->file, &scheduler_handler->start_idle_time, sizeof(scheduler_handler->start_idle_time));
+	put_value(writer->file, &scheduler_handler->end_idle_time, sizeof(scheduler_handler->end_idle_time));
+	put_value(writer->file, &scheduler_handler->total_idle_time, sizeof(scheduler_handler->total_idle_time));
+
+	// Burst prediction settings and accuracy
+	const BurstPredictions_t* bursts = &simulator->pcb_store.bursts;
+	put_value(writer->file, &bursts->initial_burst, sizeof(bursts->initial_burst));
+	put_value(writer->file, &bursts->alpha, sizeof(bursts->alpha));
+	put_value(writer->file, &bursts->bursts, sizeof(bursts->bursts));
+	put_value(writer->file, &bursts->total_error, sizeof(bursts->total_error));
+	put_value(writer->file, &bursts->max_error, sizeof(bursts->max_error));
+
+	// Context switch costs and counts
+	const ContextSwitches_t* switches = &simulator->pcb_store.switches;
+	put_value(writer->file, &switches->costs, sizeof(switches->costs));
+	put_value(writer->file, &switches->costs_set, sizeof(switches->costs_set));
+	put_value(writer->file, &switches->dispatches, sizeof(switches->dispatches));
+	put_value(writer->file, &switches->voluntary_total, sizeof(switches->voluntary_total));
+	put_value(writer->file, &switches->involuntary_total, sizeof(switches->involuntary_total));
+	put_value(writer->file, &switches->io_interrupts, sizeof(switches->io_interrupts));
+	put_value(writer->file, &switches->overhead_time, sizeof(switches->overhead_time));
+
+	// Process group weights and analytics
+	const ProcessGroups_t* groups = &simulator->pcb_store.groups;
+	put_value(writer->file, &groups->count, sizeof(groups->count));
+	fwrite(groups->weight, sizeof(groups->weight[0]), groups->count, writer->file);
+	fwrite(groups->processes_started, sizeof(groups->processes_started[0]), groups->count, writer->file);
+	fwrite(groups->processes_completed, sizeof(groups->processes_completed[0]), groups->count, writer->file);
+	fwrite(groups->cpu_time, sizeof(groups->cpu_time[0]), groups->count, writer->file);
+	fwrite(groups->total_ready_wait_time, sizeof(groups->total_ready_wait_time[0]), groups->count, writer->file);
+	fwrite(groups->max_ready_wait_time, sizeof(groups->max_ready_wait_time[0]), groups->count, writer->file);
+
+	// I/O devices
+	put_value(writer->file, &simulator->io_device_count, sizeof(simulator->io_device_count));
+	for (int i = 0; i < simulator->io_device_count; i++) {
+		put_io_device(writer, &simulator->io_devices[i]);
+	}
+
+	// Completed process analytics
+	const CompletedProcesses_t* completed = &simulator->pcb_store.completed;
+	put_value(writer->file, &completed->retention, sizeof(completed->retention));
+	put_value(writer->file, &completed->discarded, sizeof(completed->discarded));
+	put_value(writer->file, &completed->discarded_ready_wait_time, sizeof(completed->discarded_ready_wait_time));
+	put_value(writer->file, &completed->discarded_max_ready_wait_time, sizeof(completed->discarded_max_ready_wait_time));
+	put_value(writer->file, &completed->discarded_io_wait_time, sizeof(completed->discarded_io_wait_time));
+	put_value(writer->file, &completed->discarded_max_io_wait_time, sizeof(completed->discarded_max_io_wait_time));
+	put_value(writer->file, &completed->size, sizeof(completed->size));
+	fwrite(completed->PID, sizeof(completed->PID[0]), completed->size, writer->file);
+	fwrite(completed->priority, sizeof(completed->priority[0]), completed->size, writer->file);
+	fwrite(completed->ready_wait_time, sizeof(completed->ready_wait_time[0]), completed->size, writer->file);
+	fwrite(completed->io_wait_time, sizeof(completed->io_wait_time[0]), completed->size, writer->file);
+	fwrite(completed->voluntary_switches, sizeof(completed->voluntary_switches[0]), completed->size, writer->file);
+	fwrite(completed->involuntary_switches, sizeof(completed->involuntary_switches[0]), completed->size, writer->file);
+
+	bool ok = !ferror(file);
+	if (fclose(file) != 0) {
+		ok = false;
+	}
+	if (ok && rename(temp_path, path) != 0) {
+		ok = false;
+	}
+	if (!ok) {
+		remove(temp_path);
+	}
+	return ok;
+}
+
+/**
+* @brief Restores the simulator state from a snapshot file into a simulator that has not
+* handled any event. Its scheduler and device configuration are replaced by the saved ones
+* @param path: the snapshot file
+* @param state: the state to restore, its simulator must reference the caller's simulator
+* @return true on success, false if the file is missing or not a snapshot
+*/
+bool load_snapshot(const char* path, SnapshotState_t* state) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	Procsim_t* simulator = state->simulator;
+	SnapshotReader_t reader = {file, &simulator->pcb_store, true};
+	int magic = 0;
+	int version = 0;
+	Scheduling_Policy policy = SCHEDULE_FIFO;
+
+	// Run position
+	get_value(&reader, &magic, sizeof(magic));
+	get_value(&reader, &version, sizeof(version));
+	if (!reader.ok || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		fclose(file);
+		return false;
+	}
+	get_value(&reader, &policy, sizeof(policy));
+	get_value(&reader, &state->input_offset, sizeof(state->input_offset));
+	get_value(&reader, &state->event_time, sizeof(state->event_time));
+	get_value(&reader, &state->events_processed, sizeof(state->events_processed));
+	get_value(&reader, &simulator->PID_tracker, sizeof(simulator->PID_tracker));
+	if (!reader.ok || policy < 0 || policy >= SCHEDULE_POLICY_COUNT) {
+		fclose(file);
+		return false;
+	}
+	simulator->events_processed = state->events_processed;
+	simulator->last_event_time = state->event_time;
+
+	// Scheduler state
+	set_procsim_scheduler(simulator, policy);
+	SchedulerHandler* scheduler_handler = &simulator->scheduler_handler;
+	scheduler_handler->CPU = get_pcb(&reader);
+	if (is_shortest_job_policy(policy)) {
+		get_request_heap(&reader, (RequestHeap_t*)scheduler_handler->queue);
+	} else if (policy == SCHEDULE_FAIR_SHARE) {
+		get_fair_share_queue(&reader, (FairShareQueue_t*)scheduler_handler->queue);
+	} else {
+		Queue_t* ready_queue = (Queue_t*)scheduler_handler->queue;
+		ready_queue->size = get_pcb_list(&reader, &ready_queue->head, &ready_queue->tail);
+	}
+	get_value(&reader, &scheduler_handler->start_idle_time, sizeof(scheduler_handler->start_idle_time));
+	get_value(&reader, &scheduler_handler->end_idle_time, sizeof(scheduler_handler->end_idle_time));
+	get_value(&reader, &scheduler_handler->total_idle_time, sizeof(scheduler_handler->total_idle_time));
+
+	// Burst prediction settings and accuracy
+	BurstPredictions_t* bursts = &simulator->pcb_store.bursts;
+	get_value(&reader, &bursts->initial_burst, sizeof(bursts->initial_burst));
+	get_value(&reader, &bursts->alpha, sizeof(bursts->alpha));
+	get_value(&reader, &bursts->bursts, sizeof(bursts->bursts));
+	get_value(&reader, &bursts->total_error, sizeof(bursts->total_error));
+	get_value(&reader, &bursts->max_error, sizeof(bursts->max_error));
+
+	// Context switch costs and counts
+	ContextSwitches_t* switches = &simulator->pcb_store.switches;
+	get_value(&reader, &switches->costs, sizeof(switches->costs));
+	get_value(&reader, &switches->costs_set, sizeof(switches->costs_set));
+	get_value(&reader, &switches->dispatches, sizeof(switches->dispatches));
+	get_value(&reader, &switches->voluntary_total, sizeof(switches->voluntary_total));
+	get_value(&reader, &switches->involuntary_total, sizeof(switches->involuntary_total));
+	get_value(&reader, &switches->io_interrupts, sizeof(switches->io_interrupts));
+	get_value(&reader, &switches->overhead_time, sizeof(switches->overhead_time));
+
+	// Process group weights and analytics
+	ProcessGroups_t* groups = &simulator->pcb_store.groups;
+	int group_count = 0;
+	get_value(&reader, &group_count, sizeof(group_count));
+	if (group_count < 0 || group_count > PROCSIM_MAX_GROUPS) {
+		reader.ok = false;
+	} else if (reader.ok && group_count > 0) {
+		reserve_process_group(&simulator->pcb_store, group_count - 1);
+		get_value(&reader, groups->weight, group_count * sizeof(groups->weight[0]));
+		get_value(&reader, groups->processes_started, group_count * sizeof(groups->processes_started[0]));
+		get_value(&reader, groups->processes_completed, group_count * sizeof(groups->processes_completed[0]));
+		get_value(&reader, groups->cpu_time, group_count * sizeof(groups->cpu_time[0]));
+		get_value(&reader, groups->total_ready_wait_time, group_count * sizeof(groups->total_ready_wait_time[0]));
+		get_value(&reader, groups->max_ready_wait_time, group_count * sizeof(groups->max_ready_wait_time[0]));
+	}
+
+	// I/O devices
+	int io_device_count = 0;
+	get_value(&reader, &io_device_count, sizeof(io_device_count));
+	if (io_device_count != simulator->io_device_count) {
+		reader.ok = false;
+	}
+	for (int i = 0; i < io_device_count && reader.ok; i++) {
+		get_io_device(&reader, &simulator->io_devices[i]);
+	}
+
+	// Completed process analytics, the retention limit is set once the retained ones are back
+	CompletedProcesses_t* analytics = &simulator->pcb_store.completed;
+	int retention = 0;
+	get_value(&reader, &retention, sizeof(retention));
+	get_value(&reader, &analytics->discarded, sizeof(analytics->discarded));
+	get_value(&reader, &analytics->discarded_ready_wait_time, sizeof(analytics->discarded_ready_wait_time));
+	get_value(&reader, &analytics->discarded_max_ready_wait_time, sizeof(analytics->discarded_max_ready_wait_time));
+	get_value(&reader, &analytics->discarded_io_wait_time, sizeof(analytics->discarded_io_wait_time));
+	get_value(&reader, &analytics->discarded_max_io_wait_time, sizeof(analytics->discarded_max_io_wait_time));
+	int completed = 0;
+	get_value(&reader, &completed, sizeof(completed));
+	if (reader.ok && completed > 0) {
+		// One column per field, the 64-bit columns first so that every column stays aligned
+		char* columns = (char*)malloc(completed * (sizeof(Procsim_PID) + 2 * sizeof(Procsim_Time) + 3 * sizeof(int)));
+		if (!columns) {
+			fprintf(stderr, "ERROR: Memory allocation failed!\n");
+			exit(1);
+		}
+		Procsim_PID* PIDs = (Procsim_PID*)columns;
+		Procsim_Time* ready_wait_times = (Procsim_Time*)(PIDs + completed);
+		Procsim_Time* io_wait_times = ready_wait_times + completed;
+		int* priorities = (int*)(io_wait_times + completed);
+		int* voluntary_switches = priorities + completed;
+		int* involuntary_switches = voluntary_switches + completed;
+		get_value(&reader, PIDs, completed * sizeof(Procsim_PID));
+		get_value(&reader, priorities, completed * sizeof(int));
+		get_value(&reader, ready_wait_times, completed * sizeof(Procsim_Time));
+		get_value(&reader, io_wait_times, completed * sizeof(Procsim_Time));
+		get_value(&reader, voluntary_switches, completed * sizeof(int));
+		get_value(&reader, involuntary_switches, completed * sizeof(int));
+		for (int i = 0; i < completed && reader.ok; i++) {
+			ProcessResult_t result = {PIDs[i], priorities[i], ready_wait_times[i], io_wait_times[i],
+				voluntary_switches[i], involuntary_switches[i]};
+			append_completed_process(analytics, &result);
+		}
+		free(columns);
+	}
+	analytics->retention = retention;
+
+	fclose(file);
+	return reader.ok;
+}
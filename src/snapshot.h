@@ -0,0 +1,49 @@
+/**
+ * @file snapshot.h
+ * @brief Declares the functions that save the complete simulator state to a binary
+ *		  snapshot file and restore it so an interrupted run can continue
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+
+/**
+* @struct SnapshotState_t
+* @brief Defines the run position a snapshot covers, along with the simulator it saves
+*/
+typedef struct snapshot_state {
+	long input_offset;		// Byte offset of the next unread event in the input file
+	Procsim_Time event_time;	// Time of the last handled event
+	long events_processed;
+	Procsim_t* simulator;
+} SnapshotState_t;
+
+/**
+* @brief Writes the simulator state to a snapshot file. The file is written next to the
+* target and renamed over it, so an interrupted write never leaves a broken snapshot behind
+* @param path: the snapshot file
+* @param state: the state to save
+* @return true on success, false if the file could not be written
+*/
+bool save_snapshot(const char* path, const SnapshotState_t* state);
+
+/**
+* @brief Restores the simulator state from a snapshot file into a simulator that has not
+* handled any event. Its scheduler and device configuration are replaced by the saved ones
+* @param path: the snapshot file
+* @param state: the state to restore, its simulator must reference the caller's simulator
+* @return true on success, false if the file is missing or not a snapshot
+*/
+bool load_snapshot(const char* path, SnapshotState_t* state);
+
+#endif //SNAPSHOT_H
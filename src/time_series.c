@@ -0,0 +1,197 @@
+/**
+ * @file time_series.c
+ * @brief Defines the time series sampler
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "time_series.h"
+// Library imports
+#include <stdlib.h>
+
+/**
+* @brief Allocates a zeroed array, exiting if memory runs out
+*/
+static void* allocate_zeroed(int count, size_t size) {
+	void* array = calloc((size_t)count, size);
+	if (!array) {
+		fprintf(stderr, "ERROR: Memory allocation failed!\n");
+		exit(1);
+	}
+	return array;
+}
+
+/**
+* @brief Adds the current state, held for a span of time, to the window's areas
+*/
+static void accumulate_time_series(TimeSeries_t* series, Procsim_Time span) {
+	series->ready_area += series->ready_length * span;
+	if (series->cpu_busy) {
+		series->cpu_busy_time += span;
+	}
+	for (int i = 0; i < series->device_count; i++) {
+		series->device_request_area[i] += series->device_requests[i] * span;
+		if (series->device_requests[i] > 0) {
+			series->device_busy_time[i] += span;
+		}
+	}
+	series->last_time += span;
+}
+
+/**
+* @brief Writes the current window as one sample and starts the next window
+* @param series: the sampler
+* @param window_end: end of the window, before the full interval for the last window
+*/
+static void write_time_series_sample(TimeSeries_t* series, Procsim_Time window_end) {
+	// Averages cover the part of the window the run saw, empty windows are reported as 0
+	Procsim_Time covered_start = series->start_time > series->window_start ? series->start_time : series->window_start;
+	Procsim_Time length = window_end - covered_start;
+	double scale = length > 0 ? 1.0 / length : 0.0;
+
+	if (series->binary) {
+		float ready = (float)(series->ready_area * scale);
+		float cpu = (float)(series->cpu_busy_time * scale);
+		fwrite(&series->window_start, sizeof(series->window_start), 1, series->output);
+		fwrite(&series->completed_in_window, sizeof(series->completed_in_window), 1, series->output);
+		fwrite(&ready, sizeof(ready), 1, series->output);
+		fwrite(&cpu, sizeof(cpu), 1, series->output);
+		for (int i = 0; i < series->device_count; i++) {
+			float requests = (float)(series->device_request_area[i] * scale);
+			float busy = (float)(series->device_busy_time[i] * scale);
+			fwrite(&requests, sizeof(requests), 1, series->output);
+			fwrite(&busy, sizeof(busy), 1, series->output);
+		}
+	} else {
+		fprintf(series->output, "%lld,%.3f,%.3f,%d", series->window_start, series->ready_area * scale,
+				series->cpu_busy_time * scale, series->completed_in_window);
+		for (int i = 0; i < series->device_count; i++) {
+			fprintf(series->output, ",%.3f,%.3f", series->device_request_area[i] * scale,
+					series->device_busy_time[i] * scale);
+		}
+		fputc('\n', series->output);
+	}
+	series->samples_written++;
+
+	series->window_start += series->interval;
+	series->ready_area = 0;
+	series->cpu_busy_time = 0;
+	series->completed_in_window = 0;
+	for (int i = 0; i < series->device_count; i++) {
+		series->device_request_area[i] = 0;
+		series->device_busy_time[i] = 0;
+	}
+}
+
+/**
+* @brief Creates the time series file, writes its header and records the starting state
+* @param series: the sampler to open
+* @param path: the file to write
+* @param binary: true for the binary format, false for CSV
+* @param interval: length of a sampling window
+* @param simulator: the simulator, its devices are all sampled
+* @param start_time: time the run starts or resumes at
+* @return true on success, false if the file could not be created
+*/
+bool open_time_series(TimeSeries_t* series, const char* path, bool binary, Procsim_Time interval,
+					  const Procsim_t* simulator, Procsim_Time start_time) {
+	series->output = fopen(path, binary ? "wb" : "w");
+	if (series->output == NULL) {
+		return false;
+	}
+
+	series->binary = binary;
+	series->interval = interval;
+	int device_count = procsim_get_device_count(simulator);
+	series->device_count = device_count;
+	series->samples_written = 0;
+
+	// Windows stay aligned to multiples of the interval, even when resuming
+	series->start_time = start_time;
+	series->window_start = start_time - start_time % interval;
+	series->last_time = start_time;
+
+	series->device_requests = (int*)allocate_zeroed(device_count, sizeof(int));
+
+	series->ready_area = 0;
+	series->cpu_busy_time = 0;
+	series->completed_in_window = 0;
+	series->device_request_area = (Procsim_Time*)allocate_zeroed(device_count, sizeof(Procsim_Time));
+	series->device_busy_time = (Procsim_Time*)allocate_zeroed(device_count, sizeof(Procsim_Time));
+
+	if (binary) {
+		int header[3] = {TIME_SERIES_MAGIC, TIME_SERIES_VERSION, device_count};
+		fwrite(header, sizeof(int), 3, series->output);
+		fwrite(&interval, sizeof(interval), 1, series->output);
+	} else {
+		fprintf(series->output, "time,ready_queue,cpu_utilization,completed");
+		for (int i = 0; i < device_count; i++) {
+			fprintf(series->output, ",device%d_queue,device%d_busy", i, i);
+		}
+		fputc('\n', series->output);
+	}
+
+	// Processes completed before a resumed run started are not counted
+	series->completed_total = procsim_get_completed_count(simulator);
+	update_time_series(series, simulator);
+	return true;
+}
+
+/**
+* @brief Integrates the current state up to a time, writing every window that ends on the way
+* @param series: the sampler
+* @param time: the time of the next event
+*/
+void advance_time_series(TimeSeries_t* series, Procsim_Time time) {
+	while (time >= series->window_start + series->interval) {
+		accumulate_time_series(series, series->window_start + series->interval - series->last_time);
+		write_time_series_sample(series, series->window_start + series->interval);
+	}
+	accumulate_time_series(series, time - series->last_time);
+}
+
+/**
+* @brief Records the state the simulator is left in after an event
+* @param series: the sampler
+* @param simulator: the simulator
+*/
+void update_time_series(TimeSeries_t* series, const Procsim_t* simulator) {
+	series->ready_length = procsim_get_ready_queue_length(simulator);
+	series->cpu_busy = procsim_is_cpu_busy(simulator);
+	for (int i = 0; i < series->device_count; i++) {
+		series->device_requests[i] = procsim_get_device_request_count(simulator, i);
+	}
+
+	// Completions since the last event belong to the window the event falls in
+	long completed_total = procsim_get_completed_count(simulator);
+	series->completed_in_window += (int)(completed_total - series->completed_total);
+	series->completed_total = completed_total;
+}
+
+/**
+* @brief Integrates up to the end of the run, writes the last, partial window and closes the file
+* @param series: the sampler
+* @param end_time: the time the run ended
+* @return true on success, false if the file could not be written
+*/
+bool close_time_series(TimeSeries_t* series, Procsim_Time end_time) {
+	advance_time_series(series, end_time);
+	if (series->last_time > series->window_start || series->completed_in_window > 0) {
+		write_time_series_sample(series, series->last_time);
+	}
+
+	free(series->device_requests);
+	free(series->device_request_area);
+	free(series->device_busy_time);
+
+	bool ok = !ferror(series->output);
+	if (fclose(series->output) != 0) {
+		ok = false;
+	}
+	series->output = NULL;
+	return ok;
+}
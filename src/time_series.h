@@ -0,0 +1,90 @@
+/**
+ * @file time_series.h
+ * @brief Declares the time series sampler, which integrates queue lengths, utilization and
+ *		  throughput over fixed windows of simulation time
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+
+// Binary time series header
+#define TIME_SERIES_MAGIC 0x53535450	// "PTSS"
+#define TIME_SERIES_VERSION 2	// Version 2 widened the interval to 64 bits
+
+/**
+* @struct TimeSeries_t
+* @brief Defines the sampler state. The simulator state is piecewise constant between events,
+* so each event adds value times elapsed time to the window's running areas
+*/
+typedef struct time_series {
+	FILE* output;
+	bool binary;
+	Procsim_Time interval;	// Length of a sampling window
+	int device_count;
+	long samples_written;
+
+	Procsim_Time start_time;	// Time the run started or resumed at
+	Procsim_Time window_start;
+	Procsim_Time last_time;		// Time the areas are integrated up to
+
+	// State since the last event
+	int ready_length;
+	bool cpu_busy;
+	long completed_total;
+	int* device_requests;
+
+	// Areas and counts of the current window
+	Procsim_Time ready_area;
+	Procsim_Time cpu_busy_time;
+	int completed_in_window;
+	Procsim_Time* device_request_area;
+	Procsim_Time* device_busy_time;
+} TimeSeries_t;
+
+/**
+* @brief Creates the time series file, writes its header and records the starting state
+* @param series: the sampler to open
+* @param path: the file to write
+* @param binary: true for the binary format, false for CSV
+* @param interval: length of a sampling window
+* @param simulator: the simulator, its devices are all sampled
+* @param start_time: time the run starts or resumes at
+* @return true on success, false if the file could not be created
+*/
+bool open_time_series(TimeSeries_t* series, const char* path, bool binary, Procsim_Time interval,
+					  const Procsim_t* simulator, Procsim_Time start_time);
+
+/**
+* @brief Integrates the current state up to a time, writing every window that ends on the way
+* @param series: the sampler
+* @param time: the time of the next event
+*/
+void advance_time_series(TimeSeries_t* series, Procsim_Time time);
+
+/**
+* @brief Records the state the simulator is left in after an event
+* @param series: the sampler
+* @param simulator: the simulator
+*/
+void update_time_series(TimeSeries_t* series, const Procsim_t* simulator);
+
+/**
+* @brief Integrates up to the end of the run, writes the last, partial window and closes the file
+* @param series: the sampler
+* @param end_time: the time the run ended
+* @return true on success, false if the file could not be written
+*/
+bool close_time_series(TimeSeries_t* series, Procsim_Time end_time);
+
+#endif //TIME_SERIES_H
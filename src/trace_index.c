@@ -0,0 +1,181 @@
+/**
+ * @file trace_index.c
+ * @brief Defines the sparse time index kept next to an input file
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "trace_index.h"
+#include "event.h"
+// Library imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#define INDEX_MAGIC 0x58444950	// "PIDX"
+#define INDEX_VERSION 2	// Version 2 widened the entry time to 64 bits
+
+/**
+* @brief Looks up the size of a file
+* @return the size in bytes, or -1 if the file does not exist
+*/
+static long get_file_size(const char* path) {
+	struct stat file_stat;
+	if (stat(path, &file_stat) != 0) {
+		return -1;
+	}
+	return (long)file_stat.st_size;
+}
+
+/**
+* @brief Appends an entry to the index, growing it as needed
+*/
+static void append_index_entry(TraceIndex_t* index, IndexEntry_t entry) {
+	if (index->size == index->capacity) {
+		int new_capacity = index->capacity == 0 ? 64 : index->capacity * 2;
+		IndexEntry_t* grown = (IndexEntry_t*)realloc(index->entries, new_capacity * sizeof(IndexEntry_t));
+		if (!grown) {
+			fprintf(stderr, "ERROR: Memory allocation failed!\n");
+			exit(1);
+		}
+		index->entries = grown;
+		index->capacity = new_capacity;
+	}
+	index->entries[index->size++] = entry;
+}
+
+/**
+* @brief Builds the index of an input file in one streaming pass and writes it to disk
+* @param trace_path: the input file
+* @param index_path: the index file to write
+* @param stride: number of events between index entries
+* @param index: filled in with the built index
+* @return true on success, false if either file could not be opened
+*/
+bool build_trace_index(const char* trace_path, const char* index_path, long stride, TraceIndex_t* index) {
+	FILE* input = fopen(trace_path, "r");
+	if (input == NULL) {
+		return false;
+	}
+
+	index->entries = NULL;
+	index->size = 0;
+	index->capacity = 0;
+	index->stride = stride;
+	index->total_events = 0;
+	index->trace_size = get_file_size(trace_path);
+
+	// Skip the simulation parameters, then record every stride-th event
+	int preemptive_scheduler;
+	fscanf(input, "%d", &preemptive_scheduler);
+	Event_t event;
+	long offset = ftell(input);
+	while (read_event(input, &event)) {
+		if (index->total_events % stride == 0) {
+			IndexEntry_t entry = {event.time, offset, index->total_events};
+			append_index_entry(index, entry);
+		}
+		index->total_events++;
+		offset = ftell(input);
+	}
+	fclose(input);
+
+	FILE* output = fopen(index_path, "wb");
+	if (output == NULL) {
+		return false;
+	}
+	int magic = INDEX_MAGIC;
+	int version = INDEX_VERSION;
+	fwrite(&magic, sizeof(magic), 1, output);
+	fwrite(&version, sizeof(version), 1, output);
+	fwrite(&index->stride, sizeof(index->stride), 1, output);
+	fwrite(&index->total_events, sizeof(index->total_events), 1, output);
+	fwrite(&index->trace_size, sizeof(index->trace_size), 1, output);
+	fwrite(&index->size, sizeof(index->size), 1, output);
+	fwrite(index->entries, sizeof(IndexEntry_t), index->size, output);
+
+	bool ok = !ferror(output);
+	if (fclose(output) != 0) {
+		ok = false;
+	}
+	return ok;
+}
+
+/**
+* @brief Reads an index from disk and checks it still matches its input file
+* @param trace_path: the input file the index should describe
+* @param index_path: the index file
+* @param index: filled in with the index
+* @return true on success, false if the index is missing, malformed or stale
+*/
+bool load_trace_index(const char* trace_path, const char* index_path, TraceIndex_t* index) {
+	FILE* input = fopen(index_path, "rb");
+	if (input == NULL) {
+		return false;
+	}
+
+	int magic = 0;
+	int version = 0;
+	index->entries = NULL;
+	index->size = 0;
+	index->capacity = 0;
+	bool ok = fread(&magic, sizeof(magic), 1, input) == 1 && magic == INDEX_MAGIC
+		&& fread(&version, sizeof(version), 1, input) == 1 && version == INDEX_VERSION
+		&& fread(&index->stride, sizeof(index->stride), 1, input) == 1
+		&& fread(&index->total_events, sizeof(index->total_events), 1, input) == 1
+		&& fread(&index->trace_size, sizeof(index->trace_size), 1, input) == 1
+		&& fread(&index->capacity, sizeof(index->capacity), 1, input) == 1
+		&& index->capacity >= 0 && index->trace_size == get_file_size(trace_path);
+
+	if (ok && index->capacity > 0) {
+		index->entries = (IndexEntry_t*)malloc(index->capacity * sizeof(IndexEntry_t));
+		if (!index->entries) {
+			fprintf(stderr, "ERROR: Memory allocation failed!\n");
+			exit(1);
+		}
+		ok = fread(index->entries, sizeof(IndexEntry_t), index->capacity, input) == (size_t)index->capacity;
+		index->size = index->capacity;
+	}
+	fclose(input);
+
+	if (!ok) {
+		free_trace_index(index);
+	}
+	return ok;
+}
+
+/**
+* @brief Finds the first indexed event later than a time in O(log n)
+* @param index: the index
+* @param time: the time to search for
+* @return the entry, or NULL if no indexed event is later than the time
+*/
+const IndexEntry_t* find_index_entry_after(const TraceIndex_t* index, Procsim_Time time) {
+	int low = 0;
+	int high = index->size;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (index->entries[middle].time <= time) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low < index->size ? &index->entries[low] : NULL;
+}
+
+/**
+* @brief clears the contents of the index from memory
+* @param index: index to clear from memory
+*/
+void free_trace_index(TraceIndex_t* index) {
+	free(index->entries);
+	index->entries = NULL;
+	index->size = 0;
+	index->capacity = 0;
+}
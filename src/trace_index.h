@@ -0,0 +1,79 @@
+/**
+ * @file trace_index.h
+ * @brief Declares the sparse time index kept next to an input file. The index maps event
+ *		  times to byte offsets and event numbers so a run can locate a time window without
+ *		  scanning the whole file
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef TRACE_INDEX_H
+#define TRACE_INDEX_H
+
+// Header imports
+#include "procsim.h"
+// Library imports
+#include <stdbool.h>
+
+#define DEFAULT_INDEX_STRIDE 4096
+
+/**
+* @struct IndexEntry_t
+* @brief Defines the position of one indexed event in the input file
+*/
+typedef struct index_entry {
+	Procsim_Time time;
+	long offset;		// Byte offset of the start of the event line
+	long event_number;	// Number of events before this one
+} IndexEntry_t;
+
+/**
+* @struct TraceIndex_t
+* @brief Defines an index with one entry every stride events
+*/
+typedef struct trace_index {
+	IndexEntry_t* entries;
+	int size;
+	int capacity;
+	long stride;
+	long total_events;
+	long trace_size;	// Size of the indexed file, used to detect a stale index
+} TraceIndex_t;
+
+/**
+* @brief Builds the index of an input file in one streaming pass and writes it to disk
+* @param trace_path: the input file
+* @param index_path: the index file to write
+* @param stride: number of events between index entries
+* @param index: filled in with the built index
+* @return true on success, false if either file could not be opened
+*/
+bool build_trace_index(const char* trace_path, const char* index_path, long stride, TraceIndex_t* index);
+
+/**
+* @brief Reads an index from disk and checks it still matches its input file
+* @param trace_path: the input file the index should describe
+* @param index_path: the index file
+* @param index: filled in with the index
+* @return true on success, false if the index is missing, malformed or stale
+*/
+bool load_trace_index(const char* trace_path, const char* index_path, TraceIndex_t* index);
+
+/**
+* @brief Finds the first indexed event later than a time in O(log n)
+* @param index: the index
+* @param time: the time to search for
+* @return the entry, or NULL if no indexed event is later than the time
+*/
+const IndexEntry_t* find_index_entry_after(const TraceIndex_t* index, Procsim_Time time);
+
+/**
+* @brief clears the contents of the index from memory
+* @param index: index to clear from memory
+*/
+void free_trace_index(TraceIndex_t* index);
+
+#endif //TRACE_INDEX_H
@@ -0,0 +1,297 @@
+/**
+ * @file trace_merge.c
+ * @brief Defines the merge of several input files into one time ordered stream of events
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+// Header imports
+#include "trace_merge.h"
+// Library imports
+#include <stdlib.h>
+
+/**
+* @struct SortRecord_t
+* @brief Defines an event of an unsorted shard with its position, which keeps the sort stable
+*/
+typedef struct sort_record {
+	Event_t event;
+	long sequence;
+} SortRecord_t;
+
+/**
+* @brief Orders sort records by time, then by position in the shard
+*/
+static int compare_sort_records(const void* a, const void* b) {
+	const SortRecord_t* first = (const SortRecord_t*)a;
+	const SortRecord_t* second = (const SortRecord_t*)b;
+	if (first->event.time != second->event.time) {
+		return first->event.time < second->event.time ? -1 : 1;
+	}
+	return first->sequence < second->sequence ? -1 : first->sequence > second->sequence;
+}
+
+/**
+* @brief Adds a source to the merge. It stays empty until the tree is built
+* @return true on success, false if memory ran out
+*/
+static bool add_merge_source(TraceMerge_t* merge, FILE* input, bool binary) {
+	if (merge->size == merge->capacity) {
+		int new_capacity = merge->capacity == 0 ? 8 : merge->capacity * 2;
+		MergeSource_t* sources = (MergeSource_t*)realloc(merge->sources, new_capacity * sizeof(MergeSource_t));
+		if (sources == NULL) {
+			return false;
+		}
+		merge->sources = sources;
+		merge->capacity = new_capacity;
+	}
+
+	MergeSource_t* source = &merge->sources[merge->size];
+	source->buffer = (Event_t*)malloc(MERGE_READ_AHEAD * sizeof(Event_t));
+	if (source->buffer == NULL) {
+		return false;
+	}
+	source->input = input;
+	source->binary = binary;
+	source->count = 0;
+	source->next = 0;
+	source->exhausted = false;
+	merge->size++;
+	return true;
+}
+
+/**
+* @brief Refills the read-ahead buffer of a source once it has been used up
+*/
+static void refill_merge_source(MergeSource_t* source) {
+	if (source->next < source->count || source->exhausted) {
+		return;
+	}
+
+	source->next = 0;
+	if (source->binary) {
+		source->count = (int)fread(source->buffer, sizeof(Event_t), MERGE_READ_AHEAD, source->input);
+	} else {
+		source->count = 0;
+		while (source->count < MERGE_READ_AHEAD && read_event(source->input, &source->buffer[source->count])) {
+			source->count++;
+		}
+	}
+	source->exhausted = source->count == 0;
+}
+
+/**
+* @brief Checks if the next event of source a comes before the next event of source b
+*/
+static bool source_before(const TraceMerge_t* merge, int a, int b) {
+	const MergeSource_t* first = &merge->sources[a];
+	const MergeSource_t* second = &merge->sources[b];
+	if (first->exhausted || second->exhausted) {
+		return !first->exhausted;
+	}
+	Procsim_Time first_time = first->buffer[first->next].time;
+	Procsim_Time second_time = second->buffer[second->next].time;
+	if (first_time != second_time) {
+		return first_time < second_time;
+	}
+	return a < b;
+}
+
+/**
+* @brief Plays the matches below a node of the loser tree, keeping the losers in the tree
+* @return the source that wins at the node
+*/
+static int build_loser_tree(TraceMerge_t* merge, int node) {
+	if (node >= merge->size) {
+		return node - merge->size;
+	}
+	int left = build_loser_tree(merge, 2 * node);
+	int right = build_loser_tree(merge, 2 * node + 1);
+	if (source_before(merge, left, right)) {
+		merge->tree[node] = right;
+		return left;
+	}
+	merge->tree[node] = left;
+	return right;
+}
+
+/**
+* @brief Checks whether the events of a shard are in time order. The shard is left where it was
+*/
+static bool is_shard_sorted(FILE* input) {
+	long start = ftell(input);
+	Event_t event;
+	bool sorted = true;
+	bool first = true;
+	Procsim_Time last_time = 0;
+	while (sorted && read_event(input, &event)) {
+		sorted = first || event.time >= last_time;
+		first = false;
+		last_time = event.time;
+	}
+	fseek(input, start, SEEK_SET);
+	return sorted;
+}
+
+/**
+* @brief Sorts the events of a shard into runs of at most run_size events, each written to a
+* temporary file and added to the merge
+* @return true on success, false if a run file could not be opened or memory ran out
+*/
+static bool sort_shard_into_runs(TraceMerge_t* merge, FILE* input, long run_size) {
+	SortRecord_t* records = (SortRecord_t*)malloc(run_size * sizeof(SortRecord_t));
+	if (records == NULL) {
+		return false;
+	}
+
+	long sequence = 0;
+	bool ok = true;
+	while (ok) {
+		long count = 0;
+		while (count < run_size && read_event(input, &records[count].event)) {
+			records[count].sequence = sequence++;
+			count++;
+		}
+		if (count == 0) {
+			break;
+		}
+		qsort(records, count, sizeof(SortRecord_t), compare_sort_records);
+
+		FILE* run = tmpfile();
+		if (run == NULL || !add_merge_source(merge, run, true)) {
+			if (run != NULL) {
+				fclose(run);
+			}
+			ok = false;
+			break;
+		}
+		for (long i = 0; i < count; i++) {
+			fwrite(&records[i].event, sizeof(Event_t), 1, run);
+		}
+		rewind(run);
+		merge->sorted_runs++;
+	}
+	free(records);
+	return ok;
+}
+
+/**
+* @brief Opens the shards and starts the merge. Each shard starts with the simulation
+* parameters line, and the run follows the one of the first shard. Shards out of time order
+* are sorted into runs of at most run_size events first
+* @param merge: the merge to start
+* @param paths: the shard files
+* @param path_count: number of shards
+* @param run_size: events sorted in memory at a time
+* @param scheduler: filled in with the simulation parameters of the first shard
+* @return true on success, false if a shard or a run file could not be opened
+*/
+bool open_trace_merge(TraceMerge_t* merge, char* const* paths, int path_count, long run_size, int* scheduler) {
+	merge->sources = NULL;
+	merge->size = 0;
+	merge->capacity = 0;
+	merge->tree = NULL;
+	merge->shard_count = path_count;
+	merge->unsorted_shards = 0;
+	merge->sorted_runs = 0;
+	merge->events = 0;
+
+	*scheduler = 0;
+	for (int i = 0; i < path_count; i++) {
+		FILE* input = fopen(paths[i], "r");
+		if (input == NULL) {
+			close_trace_merge(merge);
+			return false;
+		}
+		int shard_scheduler = 0;
+		fscanf(input, "%d", &shard_scheduler);
+		if (i == 0) {
+			*scheduler = shard_scheduler;
+		}
+
+		if (is_shard_sorted(input)) {
+			if (!add_merge_source(merge, input, false)) {
+				fclose(input);
+				close_trace_merge(merge);
+				return false;
+			}
+			continue;
+		}
+		merge->unsorted_shards++;
+		bool sorted = sort_shard_into_runs(merge, input, run_size);
+		fclose(input);
+		if (!sorted) {
+			close_trace_merge(merge);
+			return false;
+		}
+	}
+
+	merge->tree = (int*)malloc((merge->size > 0 ? merge->size : 1) * sizeof(int));
+	if (merge->tree == NULL) {
+		close_trace_merge(merge);
+		return false;
+	}
+	for (int i = 0; i < merge->size; i++) {
+		refill_merge_source(&merge->sources[i]);
+	}
+	merge->tree[0] = merge->size > 0 ? build_loser_tree(merge, 1) : -1;
+	return true;
+}
+
+/**
+* @brief Takes the earliest event left out of the merge
+* @param merge: the merge
+* @param event: filled in with the event
+* @return true if an event was read, false once every shard is exhausted
+*/
+bool next_merged_event(TraceMerge_t* merge, Event_t* event) {
+	int winner = merge->tree[0];
+	if (winner < 0 || merge->sources[winner].exhausted) {
+		return false;
+	}
+
+	MergeSource_t* source = &merge->sources[winner];
+	*event = source->buffer[source->next++];
+	refill_merge_source(source);
+	merge->events++;
+
+	// Replay the matches on the path from the winner's leaf to the root
+	for (int node = (winner + merge->size) / 2; node > 0; node /= 2) {
+		if (source_before(merge, merge->tree[node], winner)) {
+			int loser = winner;
+			winner = merge->tree[node];
+			merge->tree[node] = loser;
+		}
+	}
+	merge->tree[0] = winner;
+	return true;
+}
+
+/**
+* @brief Closes the shards and the run files and clears the merge from memory
+* @param merge: the merge to close
+*/
+void close_trace_merge(TraceMerge_t* merge) {
+	for (int i = 0; i < merge->size; i++) {
+		fclose(merge->sources[i].input);
+		free(merge->sources[i].buffer);
+	}
+	free(merge->sources);
+	free(merge->tree);
+	merge->sources = NULL;
+	merge->tree = NULL;
+	merge->size = 0;
+	merge->capacity = 0;
+}
+
+/**
+* @brief Prints the shard, run and event counts of a merge
+* @param merge: the merge
+*/
+void print_trace_merge_summary(const TraceMerge_t* merge) {
+	printf("MERGE: SHARDS %d, UNSORTED SHARDS %d, SORTED RUNS %d, EVENTS %ld\n", merge->shard_count,
+		merge->unsorted_shards, merge->sorted_runs, merge->events);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file trace_merge.h
+ * @brief Declares the merge of several input files into one time ordered stream of events.
+ *		  Each shard is read through a small read-ahead buffer and a loser tree picks the
+ *		  earliest event. A shard that is not in time order is first sorted into runs on disk,
+ *		  which join the merge as shards of their own
+ *
+ * Course: CSC3210
+ * Section: 003
+ * Assignment: Process Simulator
+ * Name: Victor Barbulescu
+ */
+
+#ifndef TRACE_MERGE_H
+#define TRACE_MERGE_H
+
+// Header imports
+#include "event.h"
+// Library imports
+#include <stdio.h>
+#include <stdbool.h>
+
+// Events each source reads ahead
+#define MERGE_READ_AHEAD 256
+// Events sorted in memory at a time when a shard is out of order
+#define DEFAULT_SORT_RUN_SIZE (1 << 20)
+
+/**
+* @struct MergeSource_t
+* @brief Defines one sorted stream of events, a shard in time order or a sorted run
+*/
+typedef struct merge_source {
+	FILE* input;
+	bool binary;		// A run of Event_t records written by the sort, rather than a text shard
+	Event_t* buffer;	// MERGE_READ_AHEAD events
+	int count;			// Events in the buffer
+	int next;			// Next event of the buffer
+	bool exhausted;
+} MergeSource_t;
+
+/**
+* @struct TraceMerge_t
+* @brief Defines the merge. The loser tree keeps the source of the earliest event in
+* tree[0] and the loser of each match above the leaves in tree[1] to tree[size - 1].
+* Between events at the same time, the source opened first wins, so the merge is stable
+*/
+typedef struct trace_merge {
+	MergeSource_t* sources;
+	int size;
+	int capacity;
+	int* tree;
+	int shard_count;
+	int unsorted_shards;
+	int sorted_runs;	// Runs written by the sort of the unsorted shards
+	long events;		// Events merged so far
+} TraceMerge_t;
+
+/**
+* @brief Opens the shards and starts the merge. Each shard starts with the simulation
+* parameters line, and the run follows the one of the first shard. Shards out of time order
+* are sorted into runs of at most run_size events first
+* @param merge: the merge to start
+* @param paths: the shard files
+* @param path_count: number of shards
+* @param run_size: events sorted in memory at a time
+* @param scheduler: filled in with the simulation parameters of the first shard
+* @return true on success, false if a shard or a run file could not be opened
+*/
+bool open_trace_merge(TraceMerge_t* merge, char* const* paths, int path_count, long run_size, int* scheduler);
+
+/**
+* @brief Takes the earliest event left out of the merge
+* @param merge: the merge
+* @param event: filled in with the event
+* @return true if an event was read, false once every shard is exhausted
+*/
+bool next_merged_event(TraceMerge_t* merge, Event_t* event);
+
+/**
+* @brief Closes the shards and the run files and clears the merge from memory
+* @param merge: the merge to close
+*/
+void close_trace_merge(TraceMerge_t* merge);
+
+/**
+* @brief Prints the shard, run and event counts of a merge
+* @param merge: the merge
+*/
+void print_trace_merge_summary(const TraceMerge_t* merge);
+
+#endif //TRACE_MERGE_H